@@ -0,0 +1,82 @@
+#include "BitBoard.hpp"
+#include "Logger.hpp"
+#include "MinesweeperBoard.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+// Board generation cost: MinesweeperBoard against BitBoard, and the
+// BitBoard adjacency pass alone with each kernel the CPU supports.
+
+namespace {
+using clearbomb::AdjacencyKernel;
+using clearbomb::BitBoard;
+
+template <typename Work>
+double measure_ms(Work work, std::size_t iterations)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        work();
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / static_cast<double>(iterations);
+}
+
+void run(std::size_t size, std::size_t iterations, bool include_vector_board)
+{
+    const std::size_t mines = size * size / 6;
+    std::cout << size << 'x' << size << " with " << mines << " mines" << std::endl;
+
+    if (include_vector_board) {
+        const double vector_board = measure_ms(
+            [&]() {
+                clearbomb::MinesweeperBoard board(
+                    size, size, mines, clearbomb::random_board_seed(), clearbomb::BoardGenerator::Mt19937,
+                    clearbomb::SafeStart::None
+                );
+                if (board.rows() != size) {
+                    std::abort();
+                }
+            },
+            iterations
+        );
+        std::cout << "  MinesweeperBoard construction " << vector_board << " ms" << std::endl;
+    }
+
+    const double bit_board = measure_ms(
+        [&]() {
+            BitBoard board(size, size, mines);
+            if (board.rows() != size) {
+                std::abort();
+            }
+        },
+        iterations
+    );
+    std::cout << "  BitBoard construction " << bit_board << " ms" << std::endl;
+
+    BitBoard board(size, size, mines, 1);
+    const std::pair<AdjacencyKernel, const char*> kernels[] = {
+        {AdjacencyKernel::Scalar, "scalar"}, {AdjacencyKernel::Sse2, "sse2"}, {AdjacencyKernel::Avx2, "avx2"}
+    };
+    for (const auto& [kernel, name] : kernels) {
+        if (!BitBoard::kernel_supported(kernel)) {
+            std::cout << "  adjacency " << name << ": not supported" << std::endl;
+            continue;
+        }
+        const double elapsed = measure_ms([&]() { board.recompute_adjacency(kernel); }, iterations * 4);
+        std::cout << "  adjacency " << name << ' ' << elapsed << " ms" << std::endl;
+    }
+}
+
+}  // namespace
+
+int main()
+{
+    clearbomb::Logger::instance().set_level(clearbomb::LogLevel::Warning);
+    run(1000, 20, true);
+    run(4000, 5, false);
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "Logger.hpp"
+#include "MinesweeperBoard.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Compares Floyd sampling with the full-board shuffle populate_board used
+// before it (shuffle every index, build a mask, then rescan every cell),
+// for both generators.
+
+namespace {
+using clearbomb::BoardGenerator;
+using clearbomb::PackedCell;
+
+class BenchBoard : public clearbomb::MinesweeperBoard {
+public:
+    using MinesweeperBoard::MinesweeperBoard;
+
+    void legacy_populate()
+    {
+        std::vector<std::size_t> indices(rows_ * columns_);
+        std::iota(indices.begin(), indices.end(), 0);
+        std::mt19937_64 rng(seed_);
+        std::shuffle(indices.begin(), indices.end(), rng);
+
+        std::vector<bool> mine_mask(rows_ * columns_, false);
+        for (std::size_t i = 0; i < mine_count_; ++i) {
+            mine_mask[indices[i]] = true;
+        }
+        for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
+            cells_[idx] = PackedCell{};
+            cells_[idx].set_mine(mine_mask[idx]);
+        }
+        for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
+            if (!cells_[idx].is_mine()) {
+                continue;
+            }
+            for_each_neighbor(idx, [this](std::size_t neighbor_index) {
+                PackedCell& neighbor_cell = cells_[neighbor_index];
+                if (!neighbor_cell.is_mine()) {
+                    neighbor_cell.set_adjacent_mines(neighbor_cell.adjacent_mines() + 1);
+                }
+            });
+        }
+        seed_ = clearbomb::next_board_seed(seed_);
+    }
+};
+
+template <typename Work>
+double measure_us(Work work, std::size_t iterations)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        work();
+    }
+    const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / static_cast<double>(iterations);
+}
+
+void run(std::size_t rows, std::size_t columns, std::size_t mines, std::size_t iterations)
+{
+    BenchBoard mt(rows, columns, mines, 1, BoardGenerator::Mt19937);
+    BenchBoard counter(rows, columns, mines, 1, BoardGenerator::Counter);
+
+    const double legacy = measure_us([&]() { mt.legacy_populate(); }, iterations);
+    const double floyd_mt = measure_us([&]() { mt.regenerate(); }, iterations);
+    const double floyd_counter = measure_us([&]() { counter.regenerate(); }, iterations);
+    if (std::count_if(mt.packed_cells().begin(), mt.packed_cells().end(), [](PackedCell cell) {
+            return cell.is_mine();
+        }) != static_cast<std::ptrdiff_t>(mines)) {
+        std::abort();
+    }
+
+    std::cout << rows << 'x' << columns << " with " << mines << " mines: shuffle " << legacy << " us, floyd mt19937 "
+              << floyd_mt << " us, floyd counter " << floyd_counter << " us" << std::endl;
+}
+
+}  // namespace
+
+int main()
+{
+    clearbomb::Logger::instance().set_level(clearbomb::LogLevel::Warning);
+    run(9, 9, 10, 20000);
+    run(16, 30, 99, 20000);
+    run(50, 50, 500, 5000);
+    run(500, 500, 2500, 200);
+    run(1000, 1000, 10000, 50);
+    run(1000, 1000, 166666, 20);
+    return 0;
+}
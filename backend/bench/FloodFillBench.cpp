@@ -0,0 +1,154 @@
+#include "Logger.hpp"
+#include "MinesweeperBoard.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <vector>
+
+// Compares the scanline reveal with the breadth-first reveal it replaced
+// (a fresh visited vector and queue per call, neighbors() per zero cell).
+// Both boards share one layout and must expose the same number of cells.
+
+namespace {
+using clearbomb::CellState;
+using clearbomb::PackedCell;
+using clearbomb::Position;
+
+class BenchBoard : public clearbomb::MinesweeperBoard {
+public:
+    BenchBoard(std::size_t size, std::size_t mines, bool legacy)
+        : MinesweeperBoard(
+              size, size, mines, clearbomb::random_board_seed(), clearbomb::BoardGenerator::Mt19937,
+              clearbomb::SafeStart::None
+          )
+        , legacy_(legacy)
+    {}
+
+    void restore(const std::vector<PackedCell>& layout)
+    {
+        cells_ = layout;
+        revealed_safe_cells_ = 0;
+    }
+
+    clearbomb::RevealOutcome reveal(Position position) override
+    {
+        return legacy_ ? legacy_reveal(position) : MinesweeperBoard::reveal(position);
+    }
+
+private:
+    bool legacy_;
+
+    clearbomb::RevealOutcome legacy_reveal(Position position)
+    {
+        clearbomb::RevealOutcome outcome{};
+        std::vector<bool> visited(cells_.size(), false);
+        std::queue<Position> frontier;
+        frontier.push(position);
+        visited[index(position)] = true;
+
+        while (!frontier.empty()) {
+            const Position current = frontier.front();
+            frontier.pop();
+
+            PackedCell& current_cell = cells_.at(index(current));
+            if (current_cell.state() == CellState::Flagged) {
+                continue;
+            }
+            if (current_cell.state() != CellState::Revealed) {
+                current_cell.set_state(CellState::Revealed);
+                ++revealed_safe_cells_;
+                outcome.revealed_cells.push_back(current_cell.to_cell(current));
+            }
+            if (current_cell.adjacent_mines() != 0) {
+                continue;
+            }
+            for (const auto& neighbor_cell : neighbors(current)) {
+                const auto neighbor_index = index(neighbor_cell.position);
+                if (visited[neighbor_index]) {
+                    continue;
+                }
+                visited[neighbor_index] = true;
+                const PackedCell neighbor = cells_[neighbor_index];
+                if (neighbor.is_mine() || neighbor.state() == CellState::Flagged) {
+                    continue;
+                }
+                frontier.push(neighbor_cell.position);
+            }
+        }
+        return outcome;
+    }
+};
+
+// The zero cell whose reveal opens the largest area, so both fills do
+// their maximum amount of work.
+Position widest_opening(BenchBoard& board, const std::vector<PackedCell>& layout)
+{
+    Position best{0, 0};
+    std::size_t best_size = 0;
+    for (std::size_t idx = 0; idx < layout.size(); ++idx) {
+        if (layout[idx].is_mine() || layout[idx].adjacent_mines() != 0 ||
+            layout[idx].state() == CellState::Revealed) {
+            continue;
+        }
+        const Position position{idx / board.columns(), idx % board.columns()};
+        board.restore(layout);
+        const std::size_t size = board.reveal(position).revealed_cells.size();
+        if (size > best_size) {
+            best_size = size;
+            best = position;
+        }
+        if (best_size * 2 > layout.size()) {
+            break;
+        }
+    }
+    return best;
+}
+
+double measure_us(BenchBoard& board, const std::vector<PackedCell>& layout, Position start, std::size_t iterations,
+                  std::size_t& exposed)
+{
+    double total = 0;
+    for (std::size_t i = 0; i < iterations; ++i) {
+        board.restore(layout);
+        const auto begin = std::chrono::steady_clock::now();
+        exposed = board.reveal(start).revealed_cells.size();
+        total += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    }
+    return total / static_cast<double>(iterations);
+}
+
+void run(std::size_t size, std::size_t mines, std::size_t iterations)
+{
+    BenchBoard scanline(size, mines, false);
+    BenchBoard legacy(size, mines, true);
+    const std::vector<PackedCell> layout = scanline.packed_cells();
+    const Position start = widest_opening(scanline, layout);
+
+    std::size_t scanline_exposed = 0;
+    std::size_t legacy_exposed = 0;
+    const double scanline_us = measure_us(scanline, layout, start, iterations, scanline_exposed);
+    const double legacy_us = measure_us(legacy, layout, start, iterations, legacy_exposed);
+    if (scanline_exposed != legacy_exposed) {
+        std::cerr << size << 'x' << size << ": scanline exposed " << scanline_exposed << " cells, BFS "
+                  << legacy_exposed << std::endl;
+        std::exit(1);
+    }
+
+    std::cout << size << 'x' << size << " with " << mines << " mines, opening " << scanline_exposed
+              << " cells: BFS " << legacy_us << " us, scanline " << scanline_us << " us" << std::endl;
+}
+
+}  // namespace
+
+int main()
+{
+    clearbomb::Logger::instance().set_level(clearbomb::LogLevel::Warning);
+    run(50, 50, 2000);
+    run(50, 250, 2000);
+    run(500, 5000, 50);
+    run(500, 25000, 50);
+    return 0;
+}
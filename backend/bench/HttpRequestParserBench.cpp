@@ -0,0 +1,106 @@
+#include "HttpRequestParser.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+// Compares the zero-copy parser with the istringstream-based framing the
+// server used before it, on a typical browser-sized reveal request.
+
+namespace {
+
+const std::string kRequest =
+    "POST /api/reveal HTTP/1.1\r\n"
+    "Host: localhost:8080\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\n"
+    "Accept: */*\r\n"
+    "Accept-Language: en-US,en;q=0.9\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Content-Type: application/json\r\n"
+    "X-Session-Id: 7c9e6679-7425-40de-944b-e07fc1f90ae7\r\n"
+    "Origin: http://localhost:5173\r\n"
+    "Referer: http://localhost:5173/\r\n"
+    "Connection: keep-alive\r\n"
+    "Content-Length: 20\r\n"
+    "\r\n"
+    "{\"row\":3,\"column\":7}";
+
+std::optional<std::string> legacy_find_header(const std::string& headers, std::string_view name)
+{
+    std::istringstream stream(headers);
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        const auto colon = line.find(':');
+        if (colon == std::string::npos || !clearbomb::iequals(std::string_view(line).substr(0, colon), name)) {
+            continue;
+        }
+        const auto value_begin = line.find_first_not_of(" \t", colon + 1);
+        if (value_begin == std::string::npos) {
+            return std::string{};
+        }
+        return line.substr(value_begin, line.find_last_not_of(" \t") - value_begin + 1);
+    }
+    return std::nullopt;
+}
+
+std::size_t legacy_parse(const std::string& buffer)
+{
+    const auto header_end = buffer.find("\r\n\r\n");
+    const std::string headers = buffer.substr(0, header_end);
+    const std::size_t content_length = std::stoul(legacy_find_header(headers, "Content-Length").value_or("0"));
+    const std::string request = buffer.substr(0, header_end + 4 + content_length);
+    const std::string body = request.substr(header_end + 4);
+
+    std::istringstream header_stream(headers);
+    std::string request_line;
+    std::getline(header_stream, request_line);
+    std::istringstream request_line_stream(request_line);
+    std::string method;
+    std::string path;
+    std::string version;
+    request_line_stream >> method >> path >> version;
+
+    const auto session = legacy_find_header(headers, "X-Session-Id");
+    const auto connection = legacy_find_header(headers, "Connection");
+    return method.size() + path.size() + body.size() + (session ? session->size() : 0) + (connection ? 1 : 0);
+}
+
+std::size_t parser_parse(const std::string& buffer)
+{
+    clearbomb::HttpRequestParser parser;
+    clearbomb::HttpRequest request;
+    parser.parse(buffer, request);
+    const auto session = request.header("X-Session-Id");
+    return request.method.size() + request.path.size() + request.body.size() + (session ? session->size() : 0) +
+           (request.keep_alive() ? 1 : 0);
+}
+
+template <typename Parse>
+void run(const char* label, Parse parse, std::size_t iterations)
+{
+    std::size_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        checksum += parse(kRequest);
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << label << ": " << elapsed / static_cast<double>(iterations) << " ns/request"
+              << " (checksum " << checksum << ")" << std::endl;
+}
+
+}  // namespace
+
+int main()
+{
+    constexpr std::size_t kIterations = 500000;
+    run("istringstream framing", legacy_parse, kIterations);
+    run("HttpRequestParser", parser_parse, kIterations);
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include "Compression.hpp"
+#include "GameEngine.hpp"
+#include "JsonWriter.hpp"
+#include "MinesweeperBoard.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Compares JsonWriter with the per-cell std::ostringstream serialiser the
+// server used before it. Both must produce byte-identical snapshots. The
+// compact run-length snapshot is timed alongside for its size, and both are
+// gzipped at a few zlib levels to show what compression costs per response.
+
+namespace {
+
+const char* legacy_bool(bool value)
+{
+    return value ? "true" : "false";
+}
+
+std::string legacy_cell(const clearbomb::Cell& cell)
+{
+    const bool mine_visible = cell.state == clearbomb::CellState::Revealed && cell.is_mine;
+    const int adjacent_value = (cell.state == clearbomb::CellState::Revealed && !cell.is_mine) ? cell.adjacent_mines : 0;
+
+    std::ostringstream out;
+    out << "{\"row\":" << cell.position.row
+        << ",\"column\":" << cell.position.column
+        << ",\"state\":\"" << clearbomb::cell_state_name(cell.state) << "\""
+        << ",\"adjacentMines\":" << adjacent_value
+        << ",\"isMine\":" << legacy_bool(mine_visible)
+        << ",\"exploded\":" << legacy_bool(cell.exploded)
+        << '}';
+    return out.str();
+}
+
+std::string legacy_cells(const std::vector<clearbomb::Cell>& cells)
+{
+    std::ostringstream buffer;
+    buffer << '[';
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        buffer << legacy_cell(cells[i]);
+        if (i + 1 < cells.size()) {
+            buffer << ',';
+        }
+    }
+    buffer << ']';
+    return buffer.str();
+}
+
+std::string legacy_snapshot(const clearbomb::BoardSnapshot& snapshot)
+{
+    std::ostringstream payload;
+    payload << "{\"rows\":" << snapshot.rows
+            << ",\"columns\":" << snapshot.columns
+            << ",\"mines\":" << snapshot.mines
+            << ",\"flagsRemaining\":" << snapshot.flags_remaining
+            << ",\"status\":\"" << clearbomb::game_status_name(snapshot.status) << "\""
+            << ",\"seed\":" << snapshot.seed
+            << ",\"generator\":\"" << clearbomb::board_generator_name(snapshot.generator) << "\""
+            << ",\"safeStart\":\"" << clearbomb::safe_start_name(snapshot.safe_start) << "\""
+            << ",\"version\":" << snapshot.version
+            << ",\"cells\":" << legacy_cells(snapshot.cells) << "}";
+    return payload.str();
+}
+
+// A mid-game board: a corner opened by a reveal and a few flags placed.
+clearbomb::BoardSnapshot make_snapshot(std::size_t size)
+{
+    clearbomb::GameEngine engine;
+    engine.reset(clearbomb::BoardConfig{size, size, size * size / 6});
+    engine.reveal_cell(clearbomb::Position{0, 0});
+    for (std::size_t i = 1; i < size; i += 3) {
+        if (engine.board().cell_at(clearbomb::Position{size - 1, i}).state == clearbomb::CellState::Hidden) {
+            engine.toggle_flag(clearbomb::Position{size - 1, i});
+        }
+    }
+    return engine.snapshot();
+}
+
+template <typename Serialize>
+double measure(Serialize serialize, std::size_t iterations)
+{
+    std::size_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        checksum += serialize();
+    }
+    const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (checksum == 0) {
+        std::abort();
+    }
+    return elapsed / static_cast<double>(iterations);
+}
+
+void run(std::size_t size, std::size_t iterations)
+{
+    const auto snapshot = make_snapshot(size);
+
+    std::string reused;
+    clearbomb::JsonWriter(reused).board_snapshot(snapshot);
+    if (reused != legacy_snapshot(snapshot)) {
+        std::cerr << size << 'x' << size << ": JsonWriter output differs from legacy serializer" << std::endl;
+        std::exit(1);
+    }
+
+    const double legacy = measure([&]() { return legacy_snapshot(snapshot).size(); }, iterations);
+    const double fresh = measure(
+        [&]() {
+            std::string payload;
+            clearbomb::JsonWriter(payload).board_snapshot(snapshot);
+            return payload.size();
+        },
+        iterations
+    );
+    const double reuse = measure(
+        [&]() {
+            reused.clear();
+            clearbomb::JsonWriter(reused).board_snapshot(snapshot);
+            return reused.size();
+        },
+        iterations
+    );
+
+    std::string compact_payload;
+    const double compact = measure(
+        [&]() {
+            compact_payload.clear();
+            clearbomb::JsonWriter(compact_payload).compact_board_snapshot(snapshot);
+            return compact_payload.size();
+        },
+        iterations
+    );
+
+    std::cout << size << 'x' << size << " (" << reused.size() << " bytes): ostringstream " << legacy
+              << " us, JsonWriter " << fresh << " us, JsonWriter reusing buffer " << reuse << " us" << std::endl;
+    std::cout << size << 'x' << size << " compact (" << compact_payload.size() << " bytes): " << compact << " us"
+              << std::endl;
+
+    for (const int level : {1, 6, 9}) {
+        for (const std::string* payload : {&reused, &compact_payload}) {
+            std::size_t compressed_size = 0;
+            const double elapsed = measure(
+                [&]() {
+                    compressed_size =
+                        clearbomb::compress_body(*payload, clearbomb::ContentEncoding::Gzip, level).size();
+                    return compressed_size;
+                },
+                iterations
+            );
+            std::cout << size << 'x' << size << (payload == &reused ? " json" : " compact") << " gzip level " << level
+                      << ": " << payload->size() << " -> " << compressed_size << " bytes, " << elapsed << " us"
+                      << std::endl;
+        }
+    }
+}
+
+}  // namespace
+
+int main()
+{
+    run(16, 2000);
+    run(50, 300);
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include "AutoMarker.hpp"
+#include "Logger.hpp"
+#include "ProbabilityEngine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Runs the constraint solver over a corpus of seeded mid-game boards and
+// compares it with the single-cell rule AutoMarker applied before it
+// ("remaining mines == hidden neighbours"), then times the exact probability
+// engine over the same corpus.
+
+namespace {
+using clearbomb::AutoMarker;
+using clearbomb::CellState;
+using clearbomb::MinesweeperBoard;
+using clearbomb::PackedCell;
+using clearbomb::Position;
+
+std::size_t single_cell_rule(const MinesweeperBoard& board)
+{
+    const auto& packed = board.packed_cells();
+    std::vector<bool> marked(packed.size(), false);
+    std::size_t found = 0;
+    for (std::size_t idx = 0; idx < packed.size(); ++idx) {
+        const PackedCell cell = packed[idx];
+        if (cell.state() != CellState::Revealed || cell.adjacent_mines() == 0) {
+            continue;
+        }
+        std::size_t hidden = 0;
+        int remaining = cell.adjacent_mines();
+        board.for_each_neighbor(idx, [&](std::size_t neighbor) {
+            hidden += packed[neighbor].state() == CellState::Hidden ? 1 : 0;
+            remaining -= packed[neighbor].state() == CellState::Flagged ? 1 : 0;
+        });
+        if (hidden == 0 || remaining != static_cast<int>(hidden)) {
+            continue;
+        }
+        board.for_each_neighbor(idx, [&](std::size_t neighbor) {
+            if (packed[neighbor].state() == CellState::Hidden && !marked[neighbor]) {
+                marked[neighbor] = true;
+                ++found;
+            }
+        });
+    }
+    return found;
+}
+
+// A game opened at the centre and then played by revealing random safe
+// cells until the given share of safe cells is open.
+std::unique_ptr<MinesweeperBoard> mid_game(std::size_t rows, std::size_t columns, std::size_t mines, std::uint64_t seed,
+                                           double progress)
+{
+    auto board = std::make_unique<MinesweeperBoard>(
+        rows, columns, mines, seed, clearbomb::BoardGenerator::Counter, clearbomb::SafeStart::Neighborhood
+    );
+    board->reveal(Position{rows / 2, columns / 2});
+    std::mt19937_64 picker(seed);
+    std::uniform_int_distribution<std::size_t> pick(0, rows * columns - 1);
+    const auto target = static_cast<std::size_t>(progress * static_cast<double>(board->total_safe_cells()));
+    while (board->revealed_safe_cells() < target) {
+        const std::size_t idx = pick(picker);
+        const PackedCell cell = board->packed_cells()[idx];
+        if (!cell.is_mine() && cell.state() == CellState::Hidden) {
+            board->reveal(Position{idx / columns, idx % columns});
+        }
+    }
+    return board;
+}
+
+void run(std::size_t rows, std::size_t columns, std::size_t mines, std::size_t games)
+{
+    std::vector<std::unique_ptr<MinesweeperBoard>> corpus;
+    for (std::uint64_t seed = 0; seed < games; ++seed) {
+        corpus.push_back(mid_game(rows, columns, mines, seed, 0.3 + 0.4 * static_cast<double>(seed % 3) / 2.0));
+    }
+    std::vector<Position> selection;
+    for (std::size_t row = 0; row < rows; ++row) {
+        for (std::size_t column = 0; column < columns; ++column) {
+            selection.push_back(Position{row, column});
+        }
+    }
+
+    std::size_t rule_found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& board : corpus) {
+        rule_found += single_cell_rule(*board);
+    }
+    const double rule_us =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+        static_cast<double>(games);
+
+    std::size_t solver_mines = 0;
+    std::size_t solver_safe = 0;
+    double worst_us = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& board : corpus) {
+        const auto begin = std::chrono::steady_clock::now();
+        const auto deductions = AutoMarker{}.deduce(*board, selection);
+        worst_us = std::max(
+            worst_us, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count()
+        );
+        solver_mines += deductions.mines.size();
+        solver_safe += deductions.safe_cells.size();
+    }
+    const double solver_us =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+        static_cast<double>(games);
+    if (solver_mines < rule_found) {
+        std::cerr << "solver found fewer mines than the single-cell rule" << std::endl;
+        std::exit(1);
+    }
+
+    const clearbomb::ProbabilityEngine engine;
+    std::size_t largest_frontier = 0;
+    double probability_worst_us = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& board : corpus) {
+        const auto begin = std::chrono::steady_clock::now();
+        const auto map = engine.compute(*board);
+        probability_worst_us = std::max(
+            probability_worst_us,
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count()
+        );
+        if (map.status != clearbomb::ProbabilityStatus::Exact) {
+            std::cerr << "probability engine gave up on a corpus board" << std::endl;
+            std::exit(1);
+        }
+        largest_frontier = std::max(largest_frontier, map.frontier_cells);
+    }
+    const double probability_us =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+        static_cast<double>(games);
+
+    std::cout << rows << 'x' << columns << " with " << mines << " mines, " << games << " mid-game boards:" << std::endl
+              << "  single-cell rule " << rule_us << " us/board, " << rule_found << " mines" << std::endl
+              << "  solver " << solver_us << " us/board (worst " << worst_us << " us), " << solver_mines << " mines, "
+              << solver_safe << " safe cells" << std::endl
+              << "  probabilities " << probability_us << " us/board (worst " << probability_worst_us
+              << " us), largest frontier " << largest_frontier << " cells" << std::endl;
+}
+
+}  // namespace
+
+int main()
+{
+    clearbomb::Logger::instance().set_level(clearbomb::LogLevel::Warning);
+    run(16, 30, 99, 300);
+    run(50, 50, 500, 100);
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include "HttpRequestParser.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+// libFuzzer entry point. Besides crash-freedom it checks that feeding the
+// input in two pieces reaches the same verdict as feeding it whole, which is
+// the property the event loop relies on when requests arrive across reads.
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+    const std::string_view input(reinterpret_cast<const char*>(data), size);
+
+    clearbomb::HttpRequestParser whole_parser(clearbomb::HttpParserLimits{4096, 4096});
+    clearbomb::HttpRequest whole_request;
+    const auto whole = whole_parser.parse(input, whole_request);
+
+    clearbomb::HttpRequestParser split_parser(clearbomb::HttpParserLimits{4096, 4096});
+    clearbomb::HttpRequest split_request;
+    const std::size_t split = size / 2;
+    split_parser.parse(input.substr(0, split), split_request);
+    const auto resumed = split_parser.parse(input, split_request);
+
+    if (whole.status != resumed.status || whole.consumed != resumed.consumed) {
+        std::abort();
+    }
+    if (whole.status == clearbomb::HttpParseStatus::Complete) {
+        if (whole.consumed > size || whole_request.body.size() != whole_request.content_length) {
+            std::abort();
+        }
+        whole_request.keep_alive();
+        whole_request.header("Content-Type");
+        whole_request.query_parameter("session");
+    }
+    return 0;
+}
@@ -1,49 +1,194 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
+#include "Compression.hpp"
 #include "GameEngine.hpp"
+#include "HttpRequestParser.hpp"
+#include "SessionRegistry.hpp"
+#include "WorkerPool.hpp"
 
 namespace clearbomb {
 
+struct ApiServerOptions {
+    unsigned short port {8080};
+    std::size_t worker_threads {0};  // 0 selects std::thread::hardware_concurrency()
+    std::size_t max_pending_requests {1024};
+    std::size_t max_connections {16384};
+    HttpParserLimits http_limits {};
+    std::chrono::seconds keep_alive_timeout {5};
+    std::size_t max_requests_per_connection {1000};
+    // Bodies of at least this many bytes are sent gzip or deflate encoded to
+    // clients that accept it. Level is zlib's 1-9; 0 turns compression off.
+    std::size_t compression_threshold {1024};
+    int compression_level {6};
+};
+
 class ApiServer {
 public:
-    explicit ApiServer(std::shared_ptr<GameEngine> engine, unsigned short port = 8080);
+    explicit ApiServer(std::shared_ptr<SessionRegistry> sessions, ApiServerOptions options = {});
     ~ApiServer();
 
     void start();
     void stop();
 
+    // The listening port. With port 0 the kernel picks one, reported here
+    // once start() has returned.
+    unsigned short port() const noexcept { return options_.port; }
+
 private:
-    std::shared_ptr<GameEngine> engine_;
-    unsigned short port_;
+    // A server-sent event for every subscriber of one session, framed once.
+    struct SessionEvent {
+        std::string session_id;
+        std::uint64_t version;
+        std::string frame;
+    };
+
+    // Per-socket state owned exclusively by the event loop thread. Workers
+    // only ever see a copy of the parsed request and answer through
+    // post_completion(), keyed by the connection id so a recycled fd never
+    // receives a stale response.
+    struct Connection {
+        int fd {-1};
+        std::uint64_t id {0};
+        std::string read_buffer;
+        HttpRequestParser parser;
+        std::string write_buffer;
+        std::size_t write_offset {0};
+        std::size_t requests_served {0};
+        std::chrono::steady_clock::time_point last_activity;
+        bool request_in_flight {false};
+        bool close_after_write {false};
+        bool peer_closed {false};
+        // Event stream subscribers take no further requests. Events that
+        // arrive before the opening snapshot is written wait in the backlog;
+        // only those newer than the snapshot are sent.
+        std::string stream_session;
+        bool stream_open {false};
+        std::uint64_t stream_version {0};
+        std::vector<SessionEvent> stream_backlog;
+        // Set once the connection has upgraded to a WebSocket; the message
+        // buffer collects fragments until the final one arrives.
+        std::string websocket_session;
+        std::string websocket_message;
+        bool websocket_fragmented {false};
+    };
+
+    struct Completion {
+        int fd;
+        std::uint64_t connection_id;
+        std::string response;
+        bool keep_alive;
+        std::optional<std::uint64_t> stream_version {};  // set when the response opens an event stream
+    };
+
+    // A request handed to a worker together with the bytes its views point at.
+    struct PendingRequest {
+        std::string raw;
+        HttpRequest request;
+    };
+
+    struct HttpResponse {
+        int status_code {200};
+        std::string body;
+        std::string etag {};  // sent as the ETag header when set
+        std::string_view content_type {"application/json"};
+        std::string_view content_encoding {};  // set once the body is compressed
+    };
+
+    std::shared_ptr<SessionRegistry> sessions_;
+    ApiServerOptions options_;
     std::atomic<bool> running_ {false};
     std::thread server_thread_;
     int server_fd_ {-1};
-    mutable std::mutex engine_mutex_;
+    int epoll_fd_ {-1};
+    int wake_fd_ {-1};
+    std::chrono::steady_clock::time_point last_eviction_sweep_;
+    std::chrono::steady_clock::time_point last_connection_sweep_;
+    std::unique_ptr<WorkerPool> workers_;
+    std::unordered_map<int, Connection> connections_;
+    std::uint64_t next_connection_id_ {1};
+    // Guards the queues workers hand to the event loop, and the count of
+    // subscribers per session that workers check before framing an event.
+    std::mutex completions_mutex_;
+    std::vector<Completion> completions_;
+    std::vector<SessionEvent> events_;
+    std::unordered_map<std::string, std::size_t> watched_sessions_;
+    std::unordered_map<std::string, std::vector<int>> subscribers_;  // event loop only
 
     void run_event_loop();
-    void handle_client(int client_fd);
-    static std::string build_http_response(int status_code, const std::string& body);
-    static std::string build_error_response(int status_code, const std::string& message);
-    static std::string status_to_string(GameStatus status);
-
-    std::string handle_get_board() const;
-    std::string handle_post_reveal(const std::string& body);
-    std::string handle_post_flag(const std::string& body);
-    std::string handle_post_auto_mark(const std::string& body);
-    std::string handle_post_reset(const std::string& body);
-
-    static std::optional<Position> parse_position(const std::string& body);
-    static std::optional<SelectionRect> parse_selection(const std::string& body);
-    static std::optional<BoardConfig> parse_board_config(const std::string& body);
-    std::string serialize_board_snapshot(const BoardSnapshot& snapshot) const;
-    std::string serialize_cells(const std::vector<Cell>& cells) const;
-    std::string serialize_cell(const Cell& cell) const;
+    bool open_listener();
+    void accept_connections();
+    bool read_from(Connection& connection);
+    bool write_to(Connection& connection);
+    bool queue_response(Connection& connection, std::string response, bool close_after_write);
+    bool reject(Connection& connection, int status_code, const std::string& message);
+    bool dispatch_pending(Connection& connection);
+    bool upgrade_to_websocket(Connection& connection, const HttpRequest& request, std::size_t consumed);
+    bool dispatch_websocket(Connection& connection);
+    bool close_websocket(Connection& connection, std::uint16_t code, std::string_view reason);
+    void drain_completions();
+    void close_connection(int fd);
+    void close_all_connections();
+    void post_completion(Completion completion);
+    void wake_event_loop();
+
+    void subscribe(Connection& connection, const std::string& session_id);
+    void unsubscribe(Connection& connection);
+    bool open_stream(Connection& connection, std::string response, std::uint64_t version);
+    bool deliver_event(Connection& connection, const SessionEvent& event);
+    void send_stream_heartbeats();
+    bool is_watched(const std::string& session_id);
+    // Frames the moves since the given version for the session's subscribers.
+    // Called with the session lease held, so events leave in version order.
+    void publish_changes(const std::string& session_id, const GameEngine& engine, std::uint64_t since);
+
+    Completion handle_request(const HttpRequest& request, std::size_t remaining_requests);
+    std::string build_http_response(const HttpResponse& response, bool keep_alive, std::size_t remaining_requests) const;
+    static HttpResponse build_error_response(int status_code, const std::string& message);
+    static std::string session_id_of(const HttpRequest& request);
+    static HttpResponse build_reveal_response(const RevealResult& result, GameStatus status, std::uint64_t version);
+    ContentEncoding response_encoding(const HttpRequest& request) const;
+    void compress_response(HttpResponse& response, ContentEncoding encoding) const;
+    // The current snapshot in the representation and coding the client asked
+    // for. Compressed snapshots are cached on the session until it changes.
+    HttpResponse snapshot_response(const SessionRegistry::Lease& session, bool compact, ContentEncoding encoding) const;
+
+    void sweep_idle_connections();
+    void sweep_idle_sessions();
+
+    HttpResponse handle_get_board(const std::string& session_id, const HttpRequest& request) const;
+    HttpResponse handle_get_probabilities(const std::string& session_id) const;
+    HttpResponse handle_get_events(
+        const std::string& session_id,
+        const HttpRequest& request,
+        std::optional<std::uint64_t>& stream_version
+    ) const;
+    HttpResponse handle_post_reveal(const std::string& session_id, std::string_view body);
+    HttpResponse handle_post_chord(const std::string& session_id, std::string_view body);
+    HttpResponse handle_post_flag(const std::string& session_id, std::string_view body);
+    HttpResponse handle_post_auto_mark(const std::string& session_id, std::string_view body);
+    HttpResponse handle_post_batch(const std::string& session_id, std::string_view body);
+    HttpResponse handle_post_reset(const std::string& session_id, const HttpRequest& request);
+    // Answers one binary protocol message with the WebSocket frames to send.
+    std::string handle_websocket_message(const std::string& session_id, std::string_view payload);
+
+    // Payload parsers leave a description of the first problem in error.
+    static std::optional<Position> parse_position(std::string_view body, std::string& error);
+    static std::optional<SelectionRect> parse_selection(std::string_view body, std::string& error);
+    static std::optional<std::vector<Move>> parse_batch(std::string_view body, std::string& error);
+    static std::optional<BoardConfig> parse_board_config(std::string_view body, std::string& error);
 };
 
 }  // namespace clearbomb
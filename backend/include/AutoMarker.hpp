@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <vector>
 
@@ -7,10 +9,26 @@
 
 namespace clearbomb {
 
+// Hidden cells whose contents follow from the revealed numbers.
+struct Deductions {
+    std::vector<Position> mines;
+    std::vector<Position> safe_cells;
+};
+
+// Constraint-propagation solver. Every revealed number in the selection
+// becomes a constraint "these hidden neighbours hold k mines" (flags count as
+// mines). Constraints are then combined pairwise until nothing changes:
+//   - k == 0 or k == size settles every cell of a constraint;
+//   - A inside B yields the constraint B \ A with k(B) - k(A);
+//   - k(B) - k(A) == |B \ A| makes B \ A all mines and A \ B all safe.
+// Settled cells are substituted back into every constraint, so deductions
+// chain across the selection.
 class AutoMarker {
 public:
     AutoMarker() = default;
 
+    Deductions deduce(const MinesweeperBoard& board, const std::vector<Position>& selection_cells) const;
+
     std::optional<std::vector<Position>> detect_certain_mines(
         const MinesweeperBoard& board,
         std::vector<Position> selection_cells
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace clearbomb {
+
+// Standard base64 (RFC 4648) with padding.
+std::string base64_encode(std::string_view bytes);
+
+}  // namespace clearbomb
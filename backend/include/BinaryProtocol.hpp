@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GameEngine.hpp"
+
+namespace clearbomb {
+
+// Compact game protocol carried in WebSocket binary messages. Multi-byte
+// integers are little-endian; rows and columns fit a byte since boards are
+// at most 50x50.
+//
+// A client message is a sequence of operations, applied in order as one
+// batch:
+//   0x01 reveal   row column
+//   0x02 flag     row column
+//   0x03 chord    row column
+//   0x04 autoMark rowBegin colBegin rowEnd colEnd
+//   0x05 snapshot (send the whole board after the moves)
+//
+// The server answers each message with a delta when it held any moves, then
+// a snapshot when one was asked for:
+//   0x81 delta    version:u64 status:u8 flagsRemaining:u16 applied:u16
+//                 count:u16, then count x (row column cell)
+//   0x82 snapshot version:u64 status:u8 flagsRemaining:u16 rows:u8
+//                 columns:u8 mines:u16, then rows*columns cells, row-major
+//   0xff error    UTF-8 message
+//
+// A cell is one byte laid out like PackedCell: bit 0 mine, bits 1-2 state
+// (0 hidden, 1 revealed, 2 flagged), bit 3 exploded, bits 4-7 adjacent
+// mines. Only revealed cells carry anything but their state. Status is 0
+// playing, 1 victory, 2 defeat.
+enum class BinaryOp : std::uint8_t {
+    Reveal = 0x01,
+    Flag = 0x02,
+    Chord = 0x03,
+    AutoMark = 0x04,
+    Snapshot = 0x05,
+    Delta = 0x81,
+    SnapshotReply = 0x82,
+    Error = 0xff
+};
+
+struct BinaryRequest {
+    std::vector<Move> moves;
+    bool wants_snapshot {false};
+};
+
+// Leaves a description of the first problem in error.
+std::optional<BinaryRequest> decode_binary_request(std::string_view payload, std::string& error);
+
+// The client-visible byte for a cell.
+std::uint8_t binary_cell(const Cell& cell) noexcept;
+std::uint8_t binary_cell(PackedCell cell) noexcept;
+
+// Cell bytes in row-major order as (run length, cell) byte pairs, runs of at
+// most 255. Untouched areas of a board collapse to a few pairs.
+void append_run_length_cells(std::string& out, const std::vector<Cell>& cells);
+
+void append_binary_delta(std::string& out, const BatchResult& result, std::uint64_t version);
+void append_binary_snapshot(std::string& out, const GameEngine& engine);
+void append_binary_error(std::string& out, std::string_view message);
+
+}  // namespace clearbomb
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "MinesweeperBoard.hpp"
+
+namespace clearbomb {
+
+enum class AdjacencyKernel {
+    Auto,
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+struct BitBoardRevealOutcome {
+    std::size_t revealed_cells;
+    bool hit_mine;
+};
+
+// Board variant for very large grids. Mines, revealed and flagged cells are
+// bit planes (one bit per cell, 64 cells per word), and adjacency counts are
+// kept bit-sliced in four more planes. Counts are produced by adding the
+// eight shifted mine planes with carry-save adders, 64 cells per word and
+// 128/256 cells per instruction on SSE2/AVX2, so generating a 1000x1000
+// board costs a few milliseconds. Cells are only materialised by cell_at().
+class BitBoard {
+public:
+    BitBoard(std::size_t rows, std::size_t columns, std::size_t mine_count);
+    BitBoard(std::size_t rows, std::size_t columns, std::size_t mine_count, std::uint64_t seed);
+
+    BitBoardRevealOutcome reveal(Position position);
+    ToggleOutcome toggle_flag(Position position);
+    Cell cell_at(Position position) const;
+
+    bool is_mine(Position position) const;
+    int adjacent_mines(Position position) const;
+
+    // Rebuilds the count planes from the mine plane with the given kernel;
+    // Auto picks the widest one the CPU supports.
+    void recompute_adjacency(AdjacencyKernel kernel = AdjacencyKernel::Auto);
+    static bool kernel_supported(AdjacencyKernel kernel) noexcept;
+
+    std::size_t rows() const noexcept;
+    std::size_t columns() const noexcept;
+    std::size_t mine_count() const noexcept;
+    std::size_t revealed_safe_cells() const noexcept;
+    bool all_safe_cells_revealed() const noexcept;
+
+private:
+    using Plane = std::vector<std::uint64_t>;
+
+    std::size_t rows_;
+    std::size_t columns_;
+    std::size_t mine_count_;
+    // Each row spans words_per_row_ words plus one zero guard word on either
+    // side, and the plane has a zero guard row above and below, so shifted
+    // neighbour reads never need bounds checks.
+    std::size_t words_per_row_;
+    std::size_t stride_;
+    Plane mines_;
+    Plane revealed_;
+    Plane flagged_;
+    std::array<Plane, 4> counts_;
+    std::mt19937_64 rng_;
+    std::size_t revealed_safe_cells_ {0};
+
+    void place_mines();
+    void validate(Position position) const;
+    std::size_t word_index(Position position) const noexcept;
+    static std::uint64_t bit_mask(Position position) noexcept;
+};
+
+}  // namespace clearbomb
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace clearbomb {
+
+// Random source used to lay out mines. Both are fully determined by the
+// board seed; Counter is the cheaper of the two to seed and to step.
+enum class BoardGenerator {
+    Mt19937,
+    Counter
+};
+
+// Seeds are kept within the integers a JSON client can represent exactly.
+constexpr std::uint64_t kMaxBoardSeed = (std::uint64_t{1} << 53) - 1;
+
+// Counter-based generator: the n-th output is the SplitMix64 finaliser
+// applied to seed + n * golden-gamma, so seeding is free and any position in
+// the stream could be computed directly.
+class CounterRng {
+public:
+    using result_type = std::uint64_t;
+
+    explicit constexpr CounterRng(std::uint64_t seed) noexcept
+        : state_(seed)
+    {}
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr result_type operator()() noexcept
+    {
+        state_ += 0x9e3779b97f4a7c15ULL;
+        std::uint64_t mixed = state_;
+        mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebULL;
+        return mixed ^ (mixed >> 31);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+// A fresh seed from std::random_device, within kMaxBoardSeed.
+std::uint64_t random_board_seed();
+
+// The seed used for the next layout when a board regenerates or resizes
+// itself, so the whole sequence of layouts follows from the first seed.
+constexpr std::uint64_t next_board_seed(std::uint64_t seed) noexcept
+{
+    return CounterRng(seed)() & kMaxBoardSeed;
+}
+
+}  // namespace clearbomb
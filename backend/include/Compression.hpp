@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace clearbomb {
+
+enum class ContentEncoding {
+    Identity,
+    Gzip,
+    Deflate  // the zlib stream HTTP calls "deflate"
+};
+
+// The encoding to answer an Accept-Encoding header with: gzip when listed,
+// then deflate, otherwise none. Missing headers mean identity.
+ContentEncoding negotiate_content_encoding(std::string_view accept_encoding) noexcept;
+
+// The Content-Encoding token, or an empty view for Identity.
+std::string_view content_encoding_name(ContentEncoding encoding) noexcept;
+
+// Compresses body in one shot at the given zlib level (1-9). Throws
+// std::runtime_error if zlib fails.
+std::string compress_body(std::string_view body, ContentEncoding encoding, int level);
+
+}  // namespace clearbomb
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MinesweeperBoard.hpp"
+
+namespace clearbomb {
+
+// The revealed numbered cells that still border a hidden cell, kept up to
+// date move by move. Per-cell counts of hidden and flagged neighbours are
+// maintained alongside, so each reveal or flag costs a visit to the changed
+// cells' neighbourhoods and queries never rescan the board.
+class Frontier {
+public:
+    Frontier() = default;
+
+    // Recomputes everything from the board.
+    void rebuild(const MinesweeperBoard& board);
+
+    // Call after the cell at cell_index turned from Hidden to Revealed.
+    void on_revealed(const MinesweeperBoard& board, std::size_t cell_index);
+    // Call after the cell at cell_index turned from Hidden to Flagged (or back).
+    void on_flag_changed(const MinesweeperBoard& board, std::size_t cell_index, bool flagged);
+
+    // Indices (into packed_cells()) of the frontier cells, in no particular order.
+    const std::vector<std::size_t>& cells() const noexcept { return members_; }
+    bool contains(std::size_t cell_index) const noexcept { return slots_[cell_index] != kAbsent; }
+    std::size_t hidden_neighbors(std::size_t cell_index) const noexcept { return hidden_neighbors_[cell_index]; }
+    // Adjacent mines not yet accounted for by neighbouring flags.
+    int remaining_mines(const MinesweeperBoard& board, std::size_t cell_index) const noexcept;
+
+private:
+    static constexpr std::size_t kAbsent = static_cast<std::size_t>(-1);
+
+    std::vector<std::uint8_t> hidden_neighbors_;
+    std::vector<std::uint8_t> flagged_neighbors_;
+    std::vector<std::size_t> members_;
+    std::vector<std::size_t> slots_;  // position in members_, or kAbsent
+
+    void refresh(const MinesweeperBoard& board, std::size_t cell_index);
+};
+
+}  // namespace clearbomb
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <optional>
 #include <vector>
 
 #include "AutoMarker.hpp"
+#include "Frontier.hpp"
 #include "MinesweeperBoard.hpp"
+#include "ProbabilityEngine.hpp"
 
 namespace clearbomb {
 
@@ -36,10 +40,37 @@ struct FlagResult {
     bool victory;
 };
 
+// Auto-mark only places flags, and only reveals end a game, so it never
+// changes the game status.
 struct AutoMarkResult {
     std::vector<Cell> flagged_cells;
+    std::vector<Cell> safe_cells;  // hidden cells the solver proved mine-free
     std::size_t flags_remaining;
+};
+
+enum class MoveType {
+    Reveal,
+    Flag,
+    Chord,
+    AutoMark
+};
+
+// One move of a batch. AutoMark reads selection; the others read position.
+struct Move {
+    MoveType type;
+    Position position {};
+    SelectionRect selection {};
+};
+
+struct BatchResult {
+    // Final state of every cell the batch touched, each listed once in the
+    // order it was first touched.
+    std::vector<Cell> updated_cells;
+    std::size_t applied;  // moves after a game-ending one are skipped
+    bool hit_mine;
     bool victory;
+    std::size_t flags_remaining;
+    GameStatus status;
 };
 
 struct BoardSnapshot {
@@ -49,12 +80,30 @@ struct BoardSnapshot {
     std::size_t flags_remaining;
     GameStatus status;
     std::vector<Cell> cells;
+    // Replaying the same moves against a board reset with this seed and
+    // generator reproduces the game exactly.
+    std::uint64_t seed {0};
+    BoardGenerator generator {BoardGenerator::Mt19937};
+    SafeStart safe_start {SafeStart::Cell};
+    std::uint64_t version {0};
+};
+
+// Cells changed after some earlier board version, in row-major order and
+// in their current state.
+struct BoardDelta {
+    std::uint64_t version;
+    std::size_t flags_remaining;
+    GameStatus status;
+    std::vector<Cell> updated_cells;
 };
 
 struct BoardConfig {
     std::size_t rows;
     std::size_t columns;
     std::size_t mines;
+    std::optional<std::uint64_t> seed {};  // a random seed is drawn when empty
+    BoardGenerator generator {BoardGenerator::Mt19937};
+    SafeStart safe_start {SafeStart::Cell};
 };
 
 class GameEngine {
@@ -63,25 +112,54 @@ public:
     explicit GameEngine(std::unique_ptr<MinesweeperBoard> board);
 
     RevealResult reveal_cell(Position position);
+    // Reveals the unflagged neighbours of a satisfied number in one move.
+    RevealResult chord_cell(Position position);
     FlagResult toggle_flag(Position position);
     std::optional<AutoMarkResult> auto_mark(SelectionRect selection);
+    // Applies moves in order, stopping once the game ends. Every position is
+    // bounds-checked before the first move runs, so an out-of-range move
+    // rejects the whole batch with std::out_of_range.
+    BatchResult apply_batch(const std::vector<Move>& moves);
     BoardSnapshot snapshot() const;
+    // Every move that changes a cell bumps the version, and so does a reset.
+    // Versions only grow for the lifetime of the engine.
+    std::uint64_t version() const noexcept;
+    GameStatus status() const noexcept;
+    std::size_t flags_remaining() const noexcept;
+    // The cells changed since the given version, or nullopt when the change
+    // journal no longer reaches back that far (or the version was never
+    // issued), in which case the caller needs a full snapshot.
+    std::optional<BoardDelta> changes_since(std::uint64_t version) const;
+    // Exact mine probability of every hidden cell given what is on the board.
+    ProbabilityMap mine_probabilities() const;
 
     void reset(std::optional<BoardConfig> config = std::nullopt);
     const MinesweeperBoard& board() const noexcept;
+    const Frontier& frontier() const noexcept;
 
 private:
     std::unique_ptr<MinesweeperBoard> board_;
     AutoMarker auto_marker_;
+    ProbabilityEngine probability_engine_;
+    Frontier frontier_;
     BoardConfig current_config_;
+    std::uint64_t seed_ {0};
     std::size_t flags_remaining_ {0};
     bool game_over_ {false};
     GameStatus status_ {GameStatus::Playing};
-    bool first_move_done_ {false};
 
+    struct JournalEntry {
+        std::uint64_t version;
+        std::size_t cell_index;
+    };
+    std::uint64_t version_ {0};
+    std::uint64_t journal_floor_ {0};  // oldest version changes_since() can serve
+    std::deque<JournalEntry> journal_;
+
+    void record_changes(const std::vector<Cell>& cells);
+    void restart_journal();
+    RevealResult apply_reveal(Position position, RevealOutcome outcome);
     void reveal_all_mines(std::vector<Cell>& accumulator);
-    void ensure_first_move_safe(Position position);
 };
-;
 
 }  // namespace clearbomb
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace clearbomb {
+
+struct HttpHeader {
+    std::string_view name;
+    std::string_view value;
+};
+
+// A parsed request whose fields are views into the caller's receive buffer.
+// The buffer must outlive the request (or the request must be rebased onto a
+// copy of the same bytes).
+struct HttpRequest {
+    static constexpr std::size_t kMaxHeaders = 32;
+
+    std::string_view method;
+    std::string_view target;
+    std::string_view path;
+    std::string_view query;
+    std::string_view version;
+    std::array<HttpHeader, kMaxHeaders> headers {};
+    std::size_t header_count {0};
+    std::size_t content_length {0};
+    std::string_view body;
+
+    // Case-insensitive lookup of the first header with the given name.
+    std::optional<std::string_view> header(std::string_view name) const noexcept;
+    std::optional<std::string_view> query_parameter(std::string_view name) const noexcept;
+    bool keep_alive() const noexcept;
+
+    // Re-points every view from a buffer starting at old_base to the same
+    // offsets in a buffer starting at new_base.
+    void rebase(const char* old_base, const char* new_base) noexcept;
+};
+
+struct HttpParserLimits {
+    std::size_t max_header_bytes {16 * 1024};
+    std::size_t max_body_bytes {1024 * 1024};
+};
+
+enum class HttpParseStatus {
+    Complete,
+    Incomplete,
+    Invalid,
+    HeadersTooLarge,
+    BodyTooLarge
+};
+
+struct HttpParseResult {
+    HttpParseStatus status;
+    std::size_t consumed;  // bytes of the buffer belonging to the request when Complete
+    const char* error;     // static description when Invalid / too large
+};
+
+// Incremental, allocation-free HTTP/1.x request parser. Feed it the whole
+// receive buffer every time more bytes arrive; it remembers how far it has
+// already scanned for the end of the header block, so a request trickling in
+// byte by byte is still parsed in linear time. Call reset() after consuming
+// a Complete request.
+class HttpRequestParser {
+public:
+    HttpRequestParser() noexcept = default;
+    explicit HttpRequestParser(HttpParserLimits limits) noexcept;
+
+    HttpParseResult parse(std::string_view buffer, HttpRequest& request) noexcept;
+    void reset() noexcept;
+
+private:
+    HttpParserLimits limits_ {};
+    std::size_t scanned_ {0};
+
+    HttpParseResult parse_head(std::string_view head, HttpRequest& request) const noexcept;
+};
+
+bool iequals(std::string_view lhs, std::string_view rhs) noexcept;
+// True when a comma-separated header value lists the given token, ignoring case.
+bool has_list_token(std::string_view list, std::string_view token) noexcept;
+// The same for Accept-style lists, where each token may carry ;parameters.
+// A token listed with q=0 is refused rather than accepted.
+bool accepts_list_token(std::string_view list, std::string_view token) noexcept;
+
+}  // namespace clearbomb
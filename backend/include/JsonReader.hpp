@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace clearbomb {
+
+// Single-pass pull reader for small JSON request bodies. It validates the
+// document as it goes and never allocates: strings come back as views into
+// the input (escape sequences are validated but left undecoded). The first
+// error stops parsing and is kept for error_message().
+class JsonReader {
+public:
+    static constexpr std::size_t kMaxDepth = 32;
+
+    explicit JsonReader(std::string_view text) noexcept;
+
+    // Calls on_member(key) for each member of an object; the callback must
+    // consume the value with one of the read_* functions and return whether
+    // it succeeded.
+    template <typename OnMember>
+    bool read_object(OnMember&& on_member);
+
+    // Calls on_element(index) for each element of an array, with the same
+    // contract as read_object().
+    template <typename OnElement>
+    bool read_array(OnElement&& on_element);
+
+    bool read_unsigned(std::size_t& value);
+    bool read_bool(bool& value);
+    bool read_string(std::string_view& value);
+    bool skip_value();
+
+    // Succeeds when only whitespace remains after the top-level value.
+    bool finish();
+
+    bool fail(const char* message, std::string_view field = {}) noexcept;
+    bool fail_missing(std::string_view field) noexcept;
+    bool failed() const noexcept;
+    std::string error_message() const;
+
+private:
+    std::string_view text_;
+    std::size_t position_ {0};
+    std::size_t depth_ {0};
+    const char* error_ {nullptr};
+    std::string_view error_field_;
+    std::size_t error_offset_ {0};
+
+    void skip_whitespace() noexcept;
+    bool consume(char expected) noexcept;
+    bool peek(char expected) noexcept;
+    bool read_literal(std::string_view literal);
+    bool skip_number();
+    bool enter();
+    bool leave(char close);
+};
+
+// Describes one non-negative integer member of a flat request object.
+struct JsonUnsignedField {
+    std::string_view name;
+    std::size_t* value;
+    bool required {true};
+    bool present {false};
+};
+
+// Reads an object whose listed members must be non-negative integers.
+// Unknown members are skipped; duplicates and missing required members are
+// errors.
+bool read_unsigned_fields(JsonReader& reader, std::span<JsonUnsignedField> fields);
+
+// As above, but members not in fields are handed to on_other(key), which
+// must consume the value like a read_object() callback.
+template <typename OnOther>
+bool read_unsigned_fields(JsonReader& reader, std::span<JsonUnsignedField> fields, OnOther&& on_other)
+{
+    const bool parsed = reader.read_object([&reader, fields, &on_other](std::string_view key) {
+        for (auto& field : fields) {
+            if (field.name != key) {
+                continue;
+            }
+            if (field.present) {
+                return reader.fail("duplicate field", field.name);
+            }
+            field.present = true;
+            return reader.read_unsigned(*field.value);
+        }
+        return on_other(key);
+    });
+    if (!parsed || !reader.finish()) {
+        return false;
+    }
+    for (const auto& field : fields) {
+        if (field.required && !field.present) {
+            return reader.fail_missing(field.name);
+        }
+    }
+    return true;
+}
+
+template <typename OnMember>
+bool JsonReader::read_object(OnMember&& on_member)
+{
+    if (!consume('{')) {
+        return fail("expected '{'");
+    }
+    if (!enter()) {
+        return false;
+    }
+    if (peek('}')) {
+        return leave('}');
+    }
+    do {
+        std::string_view key;
+        if (!read_string(key)) {
+            return false;
+        }
+        if (!consume(':')) {
+            return fail("expected ':'");
+        }
+        if (!on_member(key)) {
+            return fail("invalid value", key);
+        }
+    } while (consume(','));
+    return leave('}');
+}
+
+template <typename OnElement>
+bool JsonReader::read_array(OnElement&& on_element)
+{
+    if (!consume('[')) {
+        return fail("expected '['");
+    }
+    if (!enter()) {
+        return false;
+    }
+    if (peek(']')) {
+        return leave(']');
+    }
+    std::size_t index = 0;
+    do {
+        if (!on_element(index++)) {
+            return fail("invalid array element");
+        }
+    } while (consume(','));
+    return leave(']');
+}
+
+}  // namespace clearbomb
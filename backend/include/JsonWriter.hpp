@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GameEngine.hpp"
+
+namespace clearbomb {
+
+std::string_view game_status_name(GameStatus status) noexcept;
+std::string_view cell_state_name(CellState state) noexcept;
+std::string_view board_generator_name(BoardGenerator generator) noexcept;
+std::string_view safe_start_name(SafeStart safe_start) noexcept;
+
+// Appends JSON fragments to a caller-owned buffer. Numbers are formatted with
+// std::to_chars and the fixed parts of each cell object are precomputed, so
+// serialising a board performs no allocations beyond growing the buffer;
+// callers that clear() and reuse the same string pay for that only once.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) noexcept;
+
+    JsonWriter& raw(std::string_view text);
+    JsonWriter& number(std::size_t value);
+    JsonWriter& number(int value);
+    // Up to six significant digits; non-finite values become null.
+    JsonWriter& number(double value);
+    JsonWriter& boolean(bool value);
+    // Quoted and escaped string value.
+    JsonWriter& string(std::string_view value);
+
+    JsonWriter& cell(const Cell& cell);
+    JsonWriter& cells(const std::vector<Cell>& cells);
+    JsonWriter& board_snapshot(const BoardSnapshot& snapshot);
+    // Same fields as board_snapshot, but "cells" is the base64 of the
+    // run-length cell bytes (see BinaryProtocol.hpp), with "encoding":"rle".
+    JsonWriter& compact_board_snapshot(const BoardSnapshot& snapshot);
+    JsonWriter& board_delta(const BoardDelta& delta);
+    JsonWriter& cell_probabilities(const std::vector<CellProbability>& cells);
+
+    // Upper bound on the bytes cells() appends for the given cell count.
+    static std::size_t cells_capacity(std::size_t count) noexcept;
+
+private:
+    std::string& out_;
+
+    // Everything in a snapshot but the cells, leaving the object open.
+    void snapshot_fields(const BoardSnapshot& snapshot);
+};
+
+}  // namespace clearbomb
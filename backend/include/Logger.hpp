@@ -1,11 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 
 namespace clearbomb {
 
@@ -17,12 +24,31 @@ enum class LogLevel {
     Critical
 };
 
+// Records below this level are compiled out of the LOG_* macros entirely.
+// Set through the CLEAR_BOMB_MIN_LOG_LEVEL CMake option.
+#ifndef CLEARBOMB_MIN_LOG_LEVEL
+#define CLEARBOMB_MIN_LOG_LEVEL 0
+#endif
+
+constexpr LogLevel kMinCompiledLogLevel = static_cast<LogLevel>(CLEARBOMB_MIN_LOG_LEVEL);
+
+struct AsyncLoggingOptions {
+    std::size_t queue_capacity {8192};  // rounded up to a power of two
+    std::chrono::milliseconds flush_interval {250};
+};
+
 class Logger {
 public:
     static Logger& instance();
+    ~Logger();
 
     void set_level(LogLevel level);
     [[nodiscard]] LogLevel level() const noexcept;
+    // Runtime filter checked by the LOG_* macros before the message is built.
+    [[nodiscard]] bool should_log(LogLevel level) const noexcept
+    {
+        return level >= level_.load(std::memory_order_relaxed);
+    }
 
     void enable_console_logging(bool enabled);
 
@@ -32,6 +58,17 @@ public:
         std::size_t max_file_size_bytes = 5 * 1024 * 1024
     );
 
+    // Moves file and console output to a background writer thread. Callers
+    // then only format their line and push it onto a lock-free queue; the
+    // writer batches writes, rotates files and flushes every flush_interval
+    // (immediately after Error and Critical records). When the queue is full
+    // records are dropped and counted rather than blocking the caller.
+    void start_async(AsyncLoggingOptions options = {});
+    // Drains every queued record, flushes and returns to synchronous logging.
+    void stop_async();
+    [[nodiscard]] bool async_enabled() const noexcept;
+    [[nodiscard]] std::uint64_t dropped_records() const noexcept;
+
     void log(
         LogLevel level,
         std::string_view module,
@@ -43,43 +80,71 @@ public:
 private:
     Logger();
 
+    class RecordQueue;
+
     struct FileTarget {
         std::string directory;
         std::string base_filename;
         std::size_t max_file_size_bytes;
     };
 
+    void write_line(std::string_view line, bool flush);
+    void flush_sinks();
     void ensure_file_target_ready(std::size_t message_payload_size);
     void open_stream_for_rotation();
-    static std::string level_to_string(LogLevel level);
-    static std::string current_timestamp_string();
-    static std::string thread_id_string();
-
+    void writer_loop(std::chrono::milliseconds flush_interval);
+    void wake_writer() noexcept;
+    static std::string_view level_to_string(LogLevel level);
+    static std::string_view current_timestamp_string();
+    static std::string_view thread_id_string();
+
+    // Guards the sinks and file target. Producers only take it while
+    // logging synchronously; in async mode only the writer thread does.
     mutable std::mutex mutex_;
-    LogLevel level_;
+    std::atomic<LogLevel> level_;
     bool console_enabled_;
     std::optional<FileTarget> file_target_;
     std::string current_date_;
+    std::time_t date_checked_at_ {0};
     int rotation_index_;
     std::string current_file_path_;
+    std::uintmax_t current_file_size_ {0};
     std::ofstream file_stream_;
+
+    std::mutex async_control_mutex_;
+    std::unique_ptr<RecordQueue> queue_;
+    std::atomic<RecordQueue*> active_queue_ {nullptr};
+    std::atomic<std::size_t> producers_in_flight_ {0};
+    std::atomic<std::uint64_t> dropped_records_ {0};
+    std::atomic<bool> flush_requested_ {false};
+    std::atomic<bool> writer_stopping_ {false};
+    std::mutex writer_mutex_;
+    std::condition_variable writer_wakeup_;
+    std::thread writer_;
 };
 
 }  // namespace clearbomb
 
 #include <sstream>
 
+// The message expression is only evaluated once both the compile-time floor
+// and the runtime level admit the record.
 #define CLEARBOMB_LOG_INTERNAL(level, module, message_expr)                           \
     do {                                                                             \
-        std::ostringstream _clearbomb_log_stream;                                    \
-        _clearbomb_log_stream << message_expr;                                       \
-        ::clearbomb::Logger::instance().log(                                         \
-            level,                                                                   \
-            module,                                                                  \
-            __func__,                                                                \
-            __LINE__,                                                                \
-            _clearbomb_log_stream.str()                                              \
-        );                                                                           \
+        if constexpr (level >= ::clearbomb::kMinCompiledLogLevel) {                  \
+            auto& _clearbomb_logger = ::clearbomb::Logger::instance();               \
+            if (_clearbomb_logger.should_log(level)) {                               \
+                std::ostringstream _clearbomb_log_stream;                            \
+                _clearbomb_log_stream << message_expr;                               \
+                _clearbomb_logger.log(                                               \
+                    level,                                                           \
+                    module,                                                          \
+                    __func__,                                                        \
+                    __LINE__,                                                        \
+                    _clearbomb_log_stream.str()                                      \
+                );                                                                   \
+            }                                                                        \
+        }                                                                            \
     } while (false)
 
 #define LOG_DEBUG(module, message) CLEARBOMB_LOG_INTERNAL(::clearbomb::LogLevel::Debug, module, message)
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
-#include <queue>
-#include <random>
+#include <cstdint>
+#include <span>
 #include <vector>
 
+#include "BoardRandom.hpp"
+
 namespace clearbomb {
 
 struct Position {
@@ -26,6 +29,68 @@ struct Cell {
     bool exploded;
 };
 
+// Board storage format: one byte per cell. Bit 0 marks a mine, bits 1-2
+// hold the CellState, bit 3 marks an exploded mine and bits 4-7 hold the
+// adjacent mine count. Cell values are only materialised at the API edge.
+class PackedCell {
+public:
+    constexpr PackedCell() noexcept = default;
+
+    constexpr bool is_mine() const noexcept { return (bits_ & kMineBit) != 0; }
+    constexpr CellState state() const noexcept
+    {
+        return static_cast<CellState>((bits_ >> kStateShift) & kStateMask);
+    }
+    constexpr bool exploded() const noexcept { return (bits_ & kExplodedBit) != 0; }
+    constexpr int adjacent_mines() const noexcept { return bits_ >> kCountShift; }
+    constexpr std::uint8_t raw() const noexcept { return bits_; }
+
+    constexpr void set_mine(bool mine) noexcept { set_bit(kMineBit, mine); }
+    constexpr void set_exploded(bool exploded) noexcept { set_bit(kExplodedBit, exploded); }
+    constexpr void set_state(CellState state) noexcept
+    {
+        bits_ = static_cast<std::uint8_t>(
+            (bits_ & ~(kStateMask << kStateShift)) | (static_cast<unsigned>(state) << kStateShift)
+        );
+    }
+    // Drops the mine, exploded and count bits but keeps the cell state.
+    constexpr void clear_layout() noexcept { bits_ &= static_cast<std::uint8_t>(kStateMask << kStateShift); }
+    constexpr void set_adjacent_mines(int count) noexcept
+    {
+        bits_ = static_cast<std::uint8_t>((bits_ & 0x0fU) | (static_cast<unsigned>(count) << kCountShift));
+    }
+
+    constexpr Cell to_cell(Position position) const noexcept
+    {
+        return Cell{position, is_mine(), adjacent_mines(), state(), exploded()};
+    }
+
+private:
+    static constexpr unsigned kMineBit = 0x01U;
+    static constexpr unsigned kStateShift = 1;
+    static constexpr unsigned kStateMask = 0x03U;
+    static constexpr unsigned kExplodedBit = 0x08U;
+    static constexpr unsigned kCountShift = 4;
+
+    std::uint8_t bits_ {0};
+
+    constexpr void set_bit(unsigned bit, bool value) noexcept
+    {
+        bits_ = static_cast<std::uint8_t>(value ? (bits_ | bit) : (bits_ & ~bit));
+    }
+};
+
+static_assert(sizeof(PackedCell) == 1);
+
+// When mines are laid out. None places them at construction; Cell and
+// Neighborhood defer placement to the first reveal and keep the revealed
+// cell (or its whole 3x3 neighbourhood, when the board has room) mine-free.
+enum class SafeStart {
+    None,
+    Cell,
+    Neighborhood
+};
+
 struct RevealOutcome {
     std::vector<Cell> revealed_cells;
     bool hit_mine;
@@ -39,22 +104,63 @@ struct ToggleOutcome {
 class MinesweeperBoard {
 public:
     MinesweeperBoard(std::size_t rows, std::size_t columns, std::size_t mine_count);
+    // The same seed and generator always produce the same mine layout.
+    MinesweeperBoard(
+        std::size_t rows,
+        std::size_t columns,
+        std::size_t mine_count,
+        std::uint64_t seed,
+        BoardGenerator generator = BoardGenerator::Mt19937,
+        SafeStart safe_start = SafeStart::Cell
+    );
     virtual ~MinesweeperBoard() = default;
 
     virtual RevealOutcome reveal(Position position);
+    // Reveals every unflagged neighbour of a revealed number whose flag count
+    // matches it. All zero regions opened this way are filled in one pass, so
+    // revealed_cells lists each cell once. Does nothing for other cells.
+    virtual RevealOutcome chord(Position position);
     virtual ToggleOutcome toggle_flag(Position position);
-    virtual const Cell& cell_at(Position position) const;
-    virtual Cell& mutable_cell(Position position);
-    virtual const std::vector<Cell>& cells() const noexcept;
+    virtual Cell cell_at(Position position) const;
+    virtual std::vector<Cell> cells() const;
     virtual std::vector<Cell> neighbors(Position position) const;
+    const std::vector<PackedCell>& packed_cells() const noexcept;
+
+    // Calls visit(neighbor_index) for each in-bounds neighbour of the cell at
+    // cell_index (an index into packed_cells()). Borders are handled by
+    // clamping the 3x3 window once, so nothing is allocated or re-checked.
+    template <typename Visitor>
+    void for_each_neighbor(std::size_t cell_index, Visitor&& visit) const
+    {
+        const std::size_t row = cell_index / columns_;
+        const std::size_t column = cell_index % columns_;
+        const std::size_t first_row = row == 0 ? 0 : row - 1;
+        const std::size_t last_row = std::min(row + 1, rows_ - 1);
+        const std::size_t first_column = column == 0 ? 0 : column - 1;
+        const std::size_t last_column = std::min(column + 1, columns_ - 1);
+        for (std::size_t neighbor_row = first_row; neighbor_row <= last_row; ++neighbor_row) {
+            const std::size_t row_begin = neighbor_row * columns_;
+            for (std::size_t neighbor_column = first_column; neighbor_column <= last_column; ++neighbor_column) {
+                if (row_begin + neighbor_column != cell_index) {
+                    visit(row_begin + neighbor_column);
+                }
+            }
+        }
+    }
+
+    // Turns every unrevealed mine face up and appends it to accumulator.
+    std::size_t reveal_mines(bool exploded, std::vector<Cell>& accumulator);
 
     virtual void resize(std::size_t rows, std::size_t columns, std::size_t mine_count);
     virtual void regenerate();
-    virtual void ensure_safe_cell(Position position);
 
     std::size_t rows() const noexcept;
     std::size_t columns() const noexcept;
     std::size_t mine_count() const noexcept;
+    std::uint64_t seed() const noexcept;
+    BoardGenerator generator() const noexcept;
+    SafeStart safe_start() const noexcept;
+    bool mines_placed() const noexcept;
     std::size_t revealed_safe_cells() const noexcept;
     std::size_t total_safe_cells() const noexcept;
     bool all_safe_cells_revealed() const noexcept;
@@ -63,12 +169,31 @@ protected:
     std::size_t rows_;
     std::size_t columns_;
     std::size_t mine_count_;
-    std::vector<Cell> cells_;
-    std::mt19937 rng_;
+    std::vector<PackedCell> cells_;
+    std::uint64_t seed_;
+    BoardGenerator generator_;
+    SafeStart safe_start_;
+    bool mines_placed_ {false};
     std::size_t revealed_safe_cells_ {0};
 
-    void populate_board();
+    // Flood-fill scratch reused across reveals: a cell counts as visited when
+    // its stamp equals the current epoch, so starting a fill never clears the
+    // buffer, and the span stack keeps its capacity.
+    std::vector<std::uint32_t> visit_stamps_;
+    std::uint32_t visit_epoch_ {0};
+    std::vector<std::size_t> span_seeds_;
+    // Indices of the mines placed by the last populate_board().
+    std::vector<std::size_t> mine_indices_;
+
+    // Lays out mines_count_ mines, never on the sorted excluded indices.
+    void populate_board(std::span<const std::size_t> excluded = {});
+    template <typename Generator>
+    void place_mines(Generator& rng, std::span<const std::size_t> excluded);
+    void place_mines_for_first_reveal(Position position);
+    void begin_visit_epoch();
+    void reveal_span_region(std::span<const std::size_t> seeds, std::vector<Cell>& revealed);
     std::size_t index(Position position) const;
+    Position position_of(std::size_t index) const noexcept;
     bool in_bounds(Position position) const noexcept;
 };
 
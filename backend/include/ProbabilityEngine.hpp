@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "MinesweeperBoard.hpp"
+
+namespace clearbomb {
+
+struct CellProbability {
+    Position position;
+    double mine_probability;
+};
+
+enum class ProbabilityStatus {
+    Exact,
+    Inconsistent,  // no mine layout agrees with the revealed numbers and flags
+    TooComplex     // a frontier component exceeded the state limit
+};
+
+struct ProbabilityMap {
+    ProbabilityStatus status {ProbabilityStatus::Exact};
+    std::vector<CellProbability> cells;  // every hidden (unflagged) cell, row-major
+    std::size_t frontier_cells {0};
+    std::size_t components {0};
+};
+
+// Exact mine probabilities over all layouts consistent with the revealed
+// numbers, the flags (counted as mines) and the board's total mine count,
+// each layout weighted equally.
+//
+// Hidden cells next to a number form the frontier. Cells that single
+// constraints settle are fixed first; the rest splits into components that
+// share no constraint. Each component is counted on its own by a dynamic
+// program over its cells in a narrow sweep order, memoised on the partial
+// mine sums of the constraints that straddle the current cell. A forward and a
+// backward pass give, for every cell, the number of solutions with it mined
+// split by the component's mine total. Components and the unconstrained
+// hidden cells are then combined through the global mine count, with the
+// binomial weights kept in log space so large boards neither overflow nor
+// underflow.
+class ProbabilityEngine {
+public:
+    static constexpr std::size_t kDefaultMaxStates = 1 << 16;
+
+    explicit ProbabilityEngine(std::size_t max_states_per_cut = kDefaultMaxStates) noexcept;
+
+    ProbabilityMap compute(const MinesweeperBoard& board) const;
+
+private:
+    std::size_t max_states_per_cut_;
+};
+
+}  // namespace clearbomb
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "GameEngine.hpp"
+
+namespace clearbomb {
+
+struct SessionRegistryOptions {
+    std::size_t shard_count {16};
+    std::size_t max_sessions_per_shard {256};
+    std::chrono::seconds idle_timeout {std::chrono::minutes(30)};
+};
+
+// Bytes derived from one version of a session's board, such as an encoded
+// snapshot. An entry is only good while its version is the engine's current
+// one; it lives and dies with the session.
+struct SessionCacheEntry {
+    std::string key;
+    std::uint64_t version {0};
+    std::string value;
+};
+
+class SessionRegistry {
+private:
+    struct Session {
+        std::mutex mutex;
+        std::unique_ptr<GameEngine> engine;
+        std::chrono::steady_clock::time_point last_access;
+        std::vector<SessionCacheEntry> cache;
+    };
+
+public:
+    // Exclusive access to one session's engine. Holding a lease only locks that
+    // session, so requests for other sessions proceed in parallel.
+    class Lease {
+    public:
+        Lease(Lease&&) noexcept = default;
+        // Unlocks the session held so far before letting go of it, so its
+        // mutex is never destroyed while locked.
+        Lease& operator=(Lease&& other) noexcept;
+
+        GameEngine& engine() const noexcept { return *session_->engine; }
+        GameEngine* operator->() const noexcept { return session_->engine.get(); }
+        std::vector<SessionCacheEntry>& cache() const noexcept { return session_->cache; }
+
+    private:
+        friend class SessionRegistry;
+        explicit Lease(std::shared_ptr<Session> session);
+
+        // Declared first so it is destroyed last, after the lock is released.
+        std::shared_ptr<Session> session_;
+        std::unique_lock<std::mutex> lock_;
+    };
+
+    static constexpr std::string_view kDefaultSessionId = "default";
+    static constexpr std::size_t kMaxSessionIdLength = 64;
+
+    explicit SessionRegistry(SessionRegistryOptions options = {});
+
+    // Returns the session's engine, creating a fresh game on first use.
+    Lease acquire(std::string_view session_id);
+
+    // Drops sessions idle for longer than the configured timeout. Sessions
+    // that are currently leased are kept.
+    std::size_t evict_idle();
+
+    std::size_t size() const;
+    const SessionRegistryOptions& options() const noexcept;
+
+    static bool is_valid_session_id(std::string_view session_id) noexcept;
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<Session>> sessions;
+    };
+
+    SessionRegistryOptions options_;
+    std::vector<Shard> shards_;
+
+    Shard& shard_for(std::string_view session_id);
+    static bool is_leased(const std::shared_ptr<Session>& session) noexcept;
+    // Drops the least recently used session nobody holds a lease on. Returns
+    // false when every session in the shard is leased.
+    bool evict_least_recent(Shard& shard);
+};
+
+}  // namespace clearbomb
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace clearbomb {
+
+// The parts of RFC 6455 a server needs: the handshake answer and the frame
+// codec. Extensions and subprotocols are not negotiated.
+
+// Sec-WebSocket-Accept for the client's Sec-WebSocket-Key:
+// base64(SHA-1(key + the protocol GUID)).
+std::string websocket_accept_key(std::string_view client_key);
+
+enum class WebSocketOpcode : std::uint8_t {
+    Continuation = 0x0,
+    Text = 0x1,
+    Binary = 0x2,
+    Close = 0x8,
+    Ping = 0x9,
+    Pong = 0xA
+};
+
+struct WebSocketFrame {
+    bool fin {true};
+    WebSocketOpcode opcode {WebSocketOpcode::Binary};
+    std::string payload;  // unmasked
+};
+
+enum class WebSocketParseStatus {
+    Complete,
+    Incomplete,
+    Invalid,
+    TooLarge
+};
+
+struct WebSocketParseResult {
+    WebSocketParseStatus status;
+    std::size_t consumed;  // bytes of the buffer belonging to the frame when Complete
+};
+
+// Parses one client frame from the front of buffer. Client frames must be
+// masked; reserved bits, unknown opcodes and fragmented or oversized control
+// frames are Invalid.
+WebSocketParseResult parse_websocket_frame(std::string_view buffer, std::size_t max_payload, WebSocketFrame& frame);
+
+// Appends a single unfragmented, unmasked server frame.
+void append_websocket_frame(std::string& out, WebSocketOpcode opcode, std::string_view payload);
+
+// Close frame payload: the status code in network order, then the reason.
+std::string websocket_close_payload(std::uint16_t code, std::string_view reason = {});
+
+}  // namespace clearbomb
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace clearbomb {
+
+// Fixed-size thread pool with a bounded job queue. Submissions beyond the
+// queue capacity are refused so callers can shed load instead of queueing
+// unbounded work.
+class WorkerPool {
+public:
+    using Job = std::function<void()>;
+
+    WorkerPool(std::size_t thread_count, std::size_t queue_capacity);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    [[nodiscard]] bool try_submit(Job job);
+    void shutdown();
+
+    std::size_t thread_count() const noexcept;
+    std::size_t pending() const;
+
+private:
+    std::size_t queue_capacity_;
+    std::vector<std::thread> threads_;
+    std::deque<Job> jobs_;
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    bool stopping_ {false};
+
+    void worker_loop();
+};
+
+}  // namespace clearbomb
@@ -0,0 +1,94 @@
+#pragma once
+
+// Shared body of the bit-sliced adjacency kernels. Included by BitBoard.cpp
+// and BitBoardAvx2.cpp; everything lives in an anonymous namespace so the
+// copy compiled with -mavx2 can never be picked by the linker for the
+// baseline build.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace clearbomb {
+namespace {
+
+template <typename V>
+inline void full_add(V a, V b, V c, V& sum, V& carry)
+{
+    const V partial = a ^ b;
+    sum = partial ^ c;
+    carry = (a & b) | (partial & c);
+}
+
+// Adds eight one-bit lanes into a four-bit count, lane-wise.
+template <typename V>
+inline void sum_eight(const V (&in)[8], V (&out)[4])
+{
+    V s1, c1, s2, c2;
+    full_add(in[0], in[1], in[2], s1, c1);
+    full_add(in[3], in[4], in[5], s2, c2);
+    const V s3 = in[6] ^ in[7];
+    const V c3 = in[6] & in[7];
+
+    V c4;
+    full_add(s1, s2, s3, out[0], c4);
+
+    V s5, c5;
+    full_add(c1, c2, c3, s5, c5);
+    out[1] = s5 ^ c4;
+    const V c6 = s5 & c4;
+
+    out[2] = c5 ^ c6;
+    out[3] = c5 & c6;
+}
+
+// Computes count planes for words [first_word, ...) of every row, as many
+// whole Lane widths as fit, and advances first_word past them so a narrower
+// kernel can finish the tail. Lane wraps a register type and provides
+// load/store, and_not, the bitwise operators and west/east: one-bit shifts
+// that pull in the edge bit of the neighbouring word.
+template <typename Lane>
+void adjacency_rows(
+    const std::uint64_t* mines,
+    std::uint64_t* const (&counts)[4],
+    std::size_t rows,
+    std::size_t words_per_row,
+    std::size_t stride,
+    std::size_t& first_word
+)
+{
+    const std::size_t available = words_per_row + 1 - first_word;
+    const std::size_t last = first_word + (available / Lane::kWords) * Lane::kWords;
+    for (std::size_t row = 1; row <= rows; ++row) {
+        const std::size_t base = row * stride;
+        for (std::size_t word = first_word; word < last; word += Lane::kWords) {
+            const std::uint64_t* up = mines + base - stride + word;
+            const std::uint64_t* middle = mines + base + word;
+            const std::uint64_t* down = mines + base + stride + word;
+
+            const Lane up_center = Lane::load(up);
+            const Lane middle_center = Lane::load(middle);
+            const Lane down_center = Lane::load(down);
+
+            const Lane in[8] = {
+                Lane::west(up_center, Lane::load(up - 1)),
+                up_center,
+                Lane::east(up_center, Lane::load(up + 1)),
+                Lane::west(middle_center, Lane::load(middle - 1)),
+                Lane::east(middle_center, Lane::load(middle + 1)),
+                Lane::west(down_center, Lane::load(down - 1)),
+                down_center,
+                Lane::east(down_center, Lane::load(down + 1)),
+            };
+            Lane out[4];
+            sum_eight(in, out);
+            for (std::size_t plane = 0; plane < 4; ++plane) {
+                // Mines themselves report no count, matching MinesweeperBoard.
+                Lane::store(counts[plane] + base + word, Lane::and_not(middle_center, out[plane]));
+            }
+        }
+    }
+    first_word = last;
+}
+
+}  // namespace
+}  // namespace clearbomb
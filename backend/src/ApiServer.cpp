@@ -1,78 +1,211 @@
 #include "ApiServer.hpp"
+#include "BinaryProtocol.hpp"
+#include "JsonReader.hpp"
+#include "JsonWriter.hpp"
 #include "Logger.hpp"
+#include "WebSocket.hpp"
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
-#include <sys/select.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <array>
 #include <cerrno>
 #include <cctype>
+#include <charconv>
 #include <cstring>
 #include <iostream>
 #include <optional>
-#include <regex>
-#include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <utility>
 
 namespace clearbomb {
 
 namespace {
-std::string reason_phrase(int status_code)
+std::string_view reason_phrase(int status_code)
 {
     switch (status_code) {
+    case 101:
+        return "Switching Protocols";
     case 200:
         return "OK";
     case 204:
         return "No Content";
+    case 304:
+        return "Not Modified";
     case 400:
         return "Bad Request";
     case 404:
         return "Not Found";
     case 405:
         return "Method Not Allowed";
+    case 409:
+        return "Conflict";
+    case 413:
+        return "Payload Too Large";
+    case 422:
+        return "Unprocessable Content";
+    case 431:
+        return "Request Header Fields Too Large";
     case 500:
         return "Internal Server Error";
+    case 503:
+        return "Service Unavailable";
     default:
         return "OK";
     }
 }
 
-std::string cell_state_to_string(CellState state)
+bool is_whitespace_only(std::string_view text)
 {
-    switch (state) {
-    case CellState::Hidden:
-        return "hidden";
-    case CellState::Revealed:
-        return "revealed";
-    case CellState::Flagged:
-        return "flagged";
+    return std::all_of(text.begin(), text.end(), [](unsigned char ch) { return std::isspace(ch) != 0; });
+}
+
+const char* format_bool(bool value)
+{
+    return value ? "true" : "false";
+}
+
+// Header values and SSE fields are plain text, so they are built with string
+// appends; JsonWriter is for JSON bodies.
+void append_decimal(std::string& out, std::uint64_t value)
+{
+    std::array<char, 20> digits {};
+    const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    out.append(digits.data(), result.ptr);
+}
+
+// Snapshots in the compact encoding (see JsonWriter::compact_board_snapshot)
+// for clients that list this media type in Accept. Everything else is JSON.
+constexpr std::string_view kJsonType = "application/json";
+constexpr std::string_view kCompactBoardType = "application/vnd.clearbomb.compact+json";
+
+bool wants_compact_board(const HttpRequest& request)
+{
+    const auto accept = request.header("Accept");
+    return accept && accepts_list_token(*accept, kCompactBoardType);
+}
+
+// The two snapshot encodings of one version are different representations,
+// so they need different tags.
+std::string make_etag(std::uint64_t version, bool compact = false)
+{
+    std::string etag = "\"";
+    append_decimal(etag, version);
+    etag.append(compact ? "c\"" : "\"");
+    return etag;
+}
+
+// Whether a snapshot ends up compressed depends on its size, which a 304 never
+// computes. So a snapshot tag is weak whenever a coding was negotiated, and a
+// 304 repeats exactly the tag of the 200 it stands in for.
+std::string snapshot_etag(std::uint64_t version, bool compact, ContentEncoding encoding)
+{
+    std::string etag = make_etag(version, compact);
+    return encoding == ContentEncoding::Identity ? etag : "W/" + etag;
+}
+
+// A delta depends on the version it starts from as well as the current one,
+// so it never shares a tag with a snapshot.
+std::string delta_etag(std::uint64_t version, std::uint64_t since)
+{
+    std::string etag = "\"";
+    append_decimal(etag, version);
+    etag.append("-d");
+    append_decimal(etag, since);
+    etag.push_back('"');
+    return etag;
+}
+
+// If-None-Match holds "*" or a comma-separated list of (possibly weak) tags.
+bool etag_matches(std::string_view if_none_match, std::string_view etag)
+{
+    while (!if_none_match.empty()) {
+        const std::size_t comma = if_none_match.find(',');
+        std::string_view candidate = if_none_match.substr(0, comma);
+        if_none_match = comma == std::string_view::npos ? std::string_view{} : if_none_match.substr(comma + 1);
+        while (!candidate.empty() && std::isspace(static_cast<unsigned char>(candidate.front())) != 0) {
+            candidate.remove_prefix(1);
+        }
+        while (!candidate.empty() && std::isspace(static_cast<unsigned char>(candidate.back())) != 0) {
+            candidate.remove_suffix(1);
+        }
+        if (candidate.starts_with("W/")) {
+            candidate.remove_prefix(2);
+        }
+        if (candidate == "*" || candidate == etag) {
+            return true;
+        }
     }
-    return "hidden";
+    return false;
 }
 
-bool is_whitespace_only(const std::string& text)
+constexpr auto kEvictionSweepInterval = std::chrono::seconds(30);
+constexpr int kLoopTickMs = 1000;
+constexpr std::size_t kMaxEventsPerWait = 256;
+constexpr std::size_t kReadChunkBytes = 16 * 1024;
+constexpr std::size_t kMaxBufferedRequests = 2;
+constexpr std::size_t kResponseHeadReserve = 320;
+constexpr std::size_t kMaxBatchMoves = 4096;
+// A subscriber with this much unsent output is dropped rather than buffered
+// for without bound; the browser's EventSource reconnects and resyncs.
+constexpr std::size_t kMaxStreamBacklogBytes = 1 << 20;
+constexpr auto kStreamHeartbeatInterval = std::chrono::seconds(15);
+
+constexpr std::string_view kStreamHead =
+    "HTTP/1.1 200 OK\r\n"
+    "Access-Control-Allow-Origin: *\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n\r\n";
+
+std::optional<std::uint64_t> parse_version(std::string_view text)
 {
-    return std::all_of(text.begin(), text.end(), [](unsigned char ch) { return std::isspace(ch) != 0; });
+    std::uint64_t value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
 }
 
-std::string format_bool(bool value)
+// The id lets a reconnecting EventSource report, via Last-Event-ID, the
+// version it had reached.
+std::string event_frame(std::string_view event, std::uint64_t version, std::string_view data)
 {
-    return value ? "true" : "false";
+    std::string frame;
+    frame.reserve(data.size() + 48);
+    frame.append("event: ").append(event).append("\nid: ");
+    append_decimal(frame, version);
+    frame.append("\ndata: ").append(data).append("\n\n");
+    return frame;
 }
 
 }  // namespace
 
-ApiServer::ApiServer(std::shared_ptr<GameEngine> engine, unsigned short port)
-    : engine_(std::move(engine))
-    , port_(port)
+ApiServer::ApiServer(std::shared_ptr<SessionRegistry> sessions, ApiServerOptions options)
+    : sessions_(std::move(sessions))
+    , options_(options)
+    , last_eviction_sweep_(std::chrono::steady_clock::now())
 {
-    if (!engine_) {
-        throw std::invalid_argument("ApiServer requires a valid GameEngine instance.");
+    if (!sessions_) {
+        throw std::invalid_argument("ApiServer requires a valid SessionRegistry instance.");
+    }
+    if (options_.worker_threads == 0) {
+        options_.worker_threads = std::max(1u, std::thread::hardware_concurrency());
     }
-    LOG_INFO("ApiServer", "Configured HTTP server on port " << port_);
+    options_.max_requests_per_connection = std::max<std::size_t>(options_.max_requests_per_connection, 1);
+    options_.compression_level = std::clamp(options_.compression_level, 0, 9);
+    LOG_INFO(
+        "ApiServer",
+        "Configured HTTP server on port " << options_.port << " with " << options_.worker_threads << " worker(s)"
+    );
 }
 
 ApiServer::~ApiServer()
@@ -88,6 +221,13 @@ void ApiServer::start()
         return;
     }
 
+    if (!open_listener()) {
+        running_ = false;
+        return;
+    }
+
+    workers_ = std::make_unique<WorkerPool>(options_.worker_threads, options_.max_pending_requests);
+
     LOG_INFO("ApiServer", "Starting server thread");
     server_thread_ = std::thread(&ApiServer::run_event_loop, this);
 }
@@ -99,24 +239,46 @@ void ApiServer::stop()
     }
 
     LOG_INFO("ApiServer", "Stopping server");
-    if (server_fd_ >= 0) {
-        ::shutdown(server_fd_, SHUT_RDWR);
-        ::close(server_fd_);
-        server_fd_ = -1;
-    }
+    wake_event_loop();
 
     if (server_thread_.joinable()) {
         server_thread_.join();
     }
+
+    // Workers may still be finishing requests; they only touch the completion
+    // queue, which is discarded once they have drained.
+    if (workers_) {
+        workers_->shutdown();
+    }
+    {
+        std::lock_guard<std::mutex> lock(completions_mutex_);
+        completions_.clear();
+    }
+
+    for (int* fd : {&server_fd_, &epoll_fd_, &wake_fd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
 }
 
-void ApiServer::run_event_loop()
+bool ApiServer::open_listener()
 {
-    server_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    const auto fail = [this](const char* what) {
+        LOG_CRITICAL("ApiServer", what << " failed on port " << options_.port << " errno=" << errno);
+        for (int* fd : {&server_fd_, &epoll_fd_, &wake_fd_}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+        return false;
+    };
+
+    server_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (server_fd_ < 0) {
-        LOG_CRITICAL("ApiServer", "Failed to create socket: errno=" << errno);
-        running_ = false;
-        return;
+        return fail("socket");
     }
 
     int enable = 1;
@@ -127,38 +289,57 @@ void ApiServer::run_event_loop()
     sockaddr_in address {};
     address.sin_family = AF_INET;
     address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(port_);
+    address.sin_port = htons(options_.port);
 
     if (bind(server_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
-        LOG_CRITICAL("ApiServer", "bind failed on port " << port_ << " errno=" << errno);
-        ::close(server_fd_);
-        server_fd_ = -1;
-        running_ = false;
-        return;
+        return fail("bind");
+    }
+    // Port 0 lets the kernel choose; record what it picked.
+    socklen_t address_length = sizeof(address);
+    if (getsockname(server_fd_, reinterpret_cast<sockaddr*>(&address), &address_length) == 0) {
+        options_.port = ntohs(address.sin_port);
     }
 
-    if (listen(server_fd_, 16) < 0) {
-        LOG_CRITICAL("ApiServer", "listen failed on port " << port_ << " errno=" << errno);
-        ::close(server_fd_);
-        server_fd_ = -1;
-        running_ = false;
-        return;
+    if (listen(server_fd_, SOMAXCONN) < 0) {
+        return fail("listen");
     }
 
-    LOG_INFO("ApiServer", "Server listening on port " << port_);
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        return fail("epoll_create1");
+    }
 
-    while (running_) {
-        fd_set read_fds;
-        FD_ZERO(&read_fds);
-        FD_SET(server_fd_, &read_fds);
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        return fail("eventfd");
+    }
+
+    epoll_event listen_event {};
+    listen_event.events = EPOLLIN | EPOLLET;
+    listen_event.data.fd = server_fd_;
+    epoll_event wake_event {};
+    wake_event.events = EPOLLIN;
+    wake_event.data.fd = wake_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, server_fd_, &listen_event) < 0 ||
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_event) < 0) {
+        return fail("epoll_ctl");
+    }
+
+    LOG_INFO("ApiServer", "Server listening on port " << options_.port);
+    return true;
+}
+
+void ApiServer::run_event_loop()
+{
+    std::vector<epoll_event> events(kMaxEventsPerWait);
 
-        timeval timeout {1, 0};
-        const int activity = select(server_fd_ + 1, &read_fds, nullptr, nullptr, &timeout);
-        if (activity < 0) {
+    while (running_) {
+        const int ready = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), kLoopTickMs);
+        if (ready < 0) {
             if (errno == EINTR) {
                 continue;
             }
-            LOG_ERROR("ApiServer", "select failed: errno=" << errno);
+            LOG_ERROR("ApiServer", "epoll_wait failed: errno=" << errno);
             break;
         }
 
@@ -166,217 +347,1026 @@ void ApiServer::run_event_loop()
             break;
         }
 
-        if (FD_ISSET(server_fd_, &read_fds)) {
-            sockaddr_in client_addr {};
-            socklen_t client_len = sizeof(client_addr);
-            int client_fd = accept(server_fd_, reinterpret_cast<sockaddr*>(&client_addr), &client_len);
-            if (client_fd < 0) {
-                LOG_WARNING("ApiServer", "accept failed: errno=" << errno);
+        for (int i = 0; i < ready; ++i) {
+            const int fd = events[static_cast<std::size_t>(i)].data.fd;
+            const std::uint32_t mask = events[static_cast<std::size_t>(i)].events;
+
+            if (fd == server_fd_) {
+                accept_connections();
+                continue;
+            }
+            if (fd == wake_fd_) {
+                std::uint64_t counter = 0;
+                [[maybe_unused]] const auto drained = ::read(wake_fd_, &counter, sizeof(counter));
+                continue;
+            }
+
+            const auto it = connections_.find(fd);
+            if (it == connections_.end()) {
+                continue;
+            }
+            if ((mask & (EPOLLERR | EPOLLHUP)) != 0) {
+                close_connection(fd);
+                continue;
+            }
+            if ((mask & (EPOLLIN | EPOLLRDHUP)) != 0 && !read_from(it->second)) {
+                continue;
+            }
+            if ((mask & EPOLLOUT) != 0) {
+                write_to(it->second);
+            }
+        }
+
+        drain_completions();
+        sweep_idle_connections();
+        sweep_idle_sessions();
+    }
+
+    close_all_connections();
+    LOG_INFO("ApiServer", "Event loop terminated");
+}
+
+void ApiServer::accept_connections()
+{
+    while (true) {
+        sockaddr_in client_addr {};
+        socklen_t client_len = sizeof(client_addr);
+        const int client_fd = ::accept4(
+            server_fd_,
+            reinterpret_cast<sockaddr*>(&client_addr),
+            &client_len,
+            SOCK_NONBLOCK | SOCK_CLOEXEC
+        );
+        if (client_fd < 0) {
+            if (errno == EINTR) {
                 continue;
             }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_WARNING("ApiServer", "accept failed: errno=" << errno);
+            }
+            return;
+        }
+
+        if (connections_.size() >= options_.max_connections) {
+            LOG_WARNING("ApiServer", "Connection limit " << options_.max_connections << " reached - refusing client");
+            ::close(client_fd);
+            continue;
+        }
+
+        char client_ip[INET_ADDRSTRLEN] = {0};
+        if (inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, sizeof(client_ip))) {
+            LOG_DEBUG("ApiServer", "Accepted connection from " << client_ip << ':' << ntohs(client_addr.sin_port));
+        } else {
+            LOG_DEBUG("ApiServer", "Accepted connection - unable to resolve client address");
+        }
+
+        int no_delay = 1;
+        setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+
+        epoll_event client_event {};
+        client_event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        client_event.data.fd = client_fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, client_fd, &client_event) < 0) {
+            LOG_WARNING("ApiServer", "epoll_ctl(ADD) failed for client_fd=" << client_fd << " errno=" << errno);
+            ::close(client_fd);
+            continue;
+        }
+
+        Connection& connection = connections_[client_fd];
+        connection = Connection{};
+        connection.parser = HttpRequestParser(options_.http_limits);
+        connection.fd = client_fd;
+        connection.id = next_connection_id_++;
+        connection.last_activity = std::chrono::steady_clock::now();
+    }
+}
 
-            char client_ip[INET_ADDRSTRLEN] = {0};
-            if (inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, sizeof(client_ip))) {
-                LOG_DEBUG("ApiServer", "Accepted connection from " << client_ip << ':' << ntohs(client_addr.sin_port));
-            } else {
-                LOG_DEBUG("ApiServer", "Accepted connection - unable to resolve client address");
+bool ApiServer::read_from(Connection& connection)
+{
+    char buffer[kReadChunkBytes];
+    while (true) {
+        const ssize_t bytes_read = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (bytes_read > 0) {
+            connection.read_buffer.append(buffer, static_cast<std::size_t>(bytes_read));
+            connection.last_activity = std::chrono::steady_clock::now();
+            const auto& limits = options_.http_limits;
+            if (connection.read_buffer.size() > kMaxBufferedRequests * (limits.max_header_bytes + limits.max_body_bytes)) {
+                LOG_WARNING("ApiServer", "Closing client_fd=" << connection.fd << " - unread input exceeds limit");
+                close_connection(connection.fd);
+                return false;
             }
+            continue;
+        }
+        if (bytes_read == 0) {
+            connection.peer_closed = true;
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        LOG_WARNING("ApiServer", "recv failed for client_fd=" << connection.fd << " errno=" << errno);
+        close_connection(connection.fd);
+        return false;
+    }
+
+    if (!dispatch_pending(connection)) {
+        return false;
+    }
+
+    if (connection.peer_closed && !connection.request_in_flight &&
+        connection.write_offset >= connection.write_buffer.size()) {
+        close_connection(connection.fd);
+        return false;
+    }
+    return true;
+}
 
-            std::thread(&ApiServer::handle_client, this, client_fd).detach();
+bool ApiServer::write_to(Connection& connection)
+{
+    while (connection.write_offset < connection.write_buffer.size()) {
+        const ssize_t bytes_sent = ::send(
+            connection.fd,
+            connection.write_buffer.data() + connection.write_offset,
+            connection.write_buffer.size() - connection.write_offset,
+            MSG_NOSIGNAL
+        );
+        if (bytes_sent > 0) {
+            connection.write_offset += static_cast<std::size_t>(bytes_sent);
+            continue;
         }
+        if (bytes_sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;  // EPOLLOUT resumes the flush once the socket drains.
+        }
+        LOG_WARNING("ApiServer", "send failed for client_fd=" << connection.fd << " errno=" << errno);
+        close_connection(connection.fd);
+        return false;
     }
 
-    if (server_fd_ >= 0) {
-        ::close(server_fd_);
-        server_fd_ = -1;
+    connection.write_buffer.clear();
+    connection.write_offset = 0;
+
+    if (connection.close_after_write || (connection.peer_closed && !connection.request_in_flight)) {
+        LOG_DEBUG("ApiServer", "Response sent and connection closed");
+        close_connection(connection.fd);
+        return false;
     }
+    return true;
+}
 
-    LOG_INFO("ApiServer", "Event loop terminated");
+bool ApiServer::queue_response(Connection& connection, std::string response, bool close_after_write)
+{
+    connection.close_after_write = connection.close_after_write || close_after_write;
+    if (connection.write_buffer.empty()) {
+        connection.write_buffer = std::move(response);
+    } else {
+        connection.write_buffer.append(response);
+    }
+    return write_to(connection);
+}
+
+bool ApiServer::reject(Connection& connection, int status_code, const std::string& message)
+{
+    return queue_response(connection, build_http_response(build_error_response(status_code, message), false, 0), true);
+}
+
+bool ApiServer::dispatch_pending(Connection& connection)
+{
+    if (connection.request_in_flight || connection.close_after_write) {
+        return true;
+    }
+    if (!connection.websocket_session.empty()) {
+        return dispatch_websocket(connection);
+    }
+    if (!connection.stream_session.empty()) {
+        connection.read_buffer.clear();
+        return true;
+    }
+
+    HttpRequest request;
+    const auto result = connection.parser.parse(connection.read_buffer, request);
+    switch (result.status) {
+    case HttpParseStatus::Complete:
+        break;
+    case HttpParseStatus::Incomplete:
+        if (connection.peer_closed && !connection.read_buffer.empty()) {
+            LOG_WARNING("ApiServer", "Rejected truncated request");
+            return reject(connection, 400, "Invalid HTTP request");
+        }
+        return true;
+    case HttpParseStatus::HeadersTooLarge:
+        LOG_WARNING("ApiServer", "Rejected request - " << result.error);
+        return reject(connection, 431, "Request headers too large");
+    case HttpParseStatus::BodyTooLarge:
+        LOG_WARNING("ApiServer", "Rejected request - " << result.error);
+        return reject(connection, 413, "Request too large");
+    case HttpParseStatus::Invalid:
+        LOG_WARNING("ApiServer", "Rejected malformed request - " << result.error);
+        return reject(connection, 400, "Invalid HTTP request");
+    }
+
+    // The handshake is a single hash and nothing after it is HTTP, so the
+    // upgrade is answered right here on the event loop.
+    if (request.method == "GET" && request.path == "/api/ws") {
+        return upgrade_to_websocket(connection, request, result.consumed);
+    }
+
+    // Hand the worker its own copy of the request bytes. When the buffer holds
+    // exactly one request (the common, non-pipelined case) it is moved rather
+    // than copied, and the parsed views are re-pointed at the new storage.
+    auto pending = std::make_shared<PendingRequest>();
+    const char* old_base = connection.read_buffer.data();
+    if (result.consumed == connection.read_buffer.size()) {
+        pending->raw = std::move(connection.read_buffer);
+        connection.read_buffer.clear();
+    } else {
+        pending->raw.assign(connection.read_buffer, 0, result.consumed);
+    }
+    pending->request = request;
+    pending->request.rebase(old_base, pending->raw.data());
+    if (!connection.read_buffer.empty()) {
+        connection.read_buffer.erase(0, result.consumed);
+    }
+    connection.parser.reset();
+    connection.request_in_flight = true;
+    ++connection.requests_served;
+
+    // The last request a connection may serve is answered with
+    // "Connection: close"; anything pipelined behind it is discarded.
+    const std::size_t remaining_requests = options_.max_requests_per_connection - connection.requests_served;
+    const int fd = connection.fd;
+    const std::uint64_t connection_id = connection.id;
+
+    // Subscribing before a worker takes the opening snapshot means every
+    // event newer than that snapshot reaches this connection.
+    if (pending->request.method == "GET" && pending->request.path == "/api/events") {
+        const std::string session_id = session_id_of(pending->request);
+        if (SessionRegistry::is_valid_session_id(session_id)) {
+            subscribe(connection, session_id);
+        }
+    }
+
+    const bool submitted = workers_->try_submit([this, fd, connection_id, remaining_requests, pending]() {
+        Completion completion = handle_request(pending->request, remaining_requests);
+        completion.fd = fd;
+        completion.connection_id = connection_id;
+        post_completion(std::move(completion));
+    });
+
+    if (!submitted) {
+        connection.request_in_flight = false;
+        unsubscribe(connection);
+        LOG_WARNING("ApiServer", "Worker queue full - shedding request on client_fd=" << fd);
+        return reject(connection, 503, "Server busy");
+    }
+    return true;
 }
 
-void ApiServer::handle_client(int client_fd)
+bool ApiServer::upgrade_to_websocket(Connection& connection, const HttpRequest& request, std::size_t consumed)
 {
-    std::string request;
-    char buffer[4096];
-    ssize_t bytes_read = 0;
+    const auto upgrade = request.header("Upgrade");
+    const auto connection_header = request.header("Connection");
+    const auto version = request.header("Sec-WebSocket-Version");
+    const auto key = request.header("Sec-WebSocket-Key");
+    const std::string session_id = session_id_of(request);
+    if (!upgrade || !has_list_token(*upgrade, "websocket") || !connection_header ||
+        !has_list_token(*connection_header, "upgrade") || version != "13" || !key || key->empty()) {
+        LOG_WARNING("ApiServer", "Rejected WebSocket upgrade on client_fd=" << connection.fd << " - bad handshake");
+        return reject(connection, 400, "Invalid WebSocket handshake");
+    }
+    if (!SessionRegistry::is_valid_session_id(session_id)) {
+        LOG_WARNING("ApiServer", "Rejected WebSocket upgrade with invalid session id");
+        return reject(connection, 400, "Invalid session id");
+    }
+
+    std::string response =
+        "HTTP/1.1 101 Switching Protocols\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: ";
+    response.append(websocket_accept_key(*key)).append("\r\n\r\n");
+
+    // The request's views point into the read buffer, so everything needed
+    // from it is copied out above before the bytes are dropped.
+    connection.read_buffer.erase(0, consumed);
+    connection.parser.reset();
+    connection.websocket_session = session_id;
+    ++connection.requests_served;
+    LOG_INFO("ApiServer", "WebSocket opened for session " << session_id << " on client_fd=" << connection.fd);
+    if (!queue_response(connection, std::move(response), false)) {
+        return false;
+    }
+    return dispatch_websocket(connection);
+}
 
-    while ((bytes_read = ::recv(client_fd, buffer, sizeof(buffer), 0)) > 0) {
-        request.append(buffer, buffer + bytes_read);
-        if (request.find("\r\n\r\n") != std::string::npos) {
+bool ApiServer::dispatch_websocket(Connection& connection)
+{
+    const std::size_t max_message = options_.http_limits.max_body_bytes;
+    while (!connection.request_in_flight && !connection.close_after_write) {
+        WebSocketFrame frame;
+        const auto result = parse_websocket_frame(connection.read_buffer, max_message, frame);
+        switch (result.status) {
+        case WebSocketParseStatus::Complete:
+            break;
+        case WebSocketParseStatus::Incomplete:
+            return true;
+        case WebSocketParseStatus::Invalid:
+            LOG_WARNING("ApiServer", "Closing WebSocket on client_fd=" << connection.fd << " - malformed frame");
+            return close_websocket(connection, 1002, "Malformed frame");
+        case WebSocketParseStatus::TooLarge:
+            return close_websocket(connection, 1009, "Message too large");
+        }
+        connection.read_buffer.erase(0, result.consumed);
+
+        switch (frame.opcode) {
+        case WebSocketOpcode::Ping: {
+            std::string pong;
+            append_websocket_frame(pong, WebSocketOpcode::Pong, frame.payload);
+            if (!queue_response(connection, std::move(pong), false)) {
+                return false;
+            }
+            continue;
+        }
+        case WebSocketOpcode::Pong:
+            continue;
+        case WebSocketOpcode::Close:
+            return close_websocket(connection, 1000, "");
+        case WebSocketOpcode::Text:
+            return close_websocket(connection, 1003, "Binary messages only");
+        case WebSocketOpcode::Binary:
+        case WebSocketOpcode::Continuation:
             break;
         }
+
+        // A continuation must follow an unfinished message and a new
+        // message must not interrupt one.
+        if ((frame.opcode == WebSocketOpcode::Continuation) != connection.websocket_fragmented) {
+            return close_websocket(connection, 1002, "Unexpected fragment");
+        }
+        connection.websocket_message.append(frame.payload);
+        if (connection.websocket_message.size() > max_message) {
+            return close_websocket(connection, 1009, "Message too large");
+        }
+        connection.websocket_fragmented = !frame.fin;
+        if (!frame.fin) {
+            continue;
+        }
+
+        // Messages are answered one at a time, in order, like pipelined requests.
+        auto message = std::make_shared<std::string>(std::move(connection.websocket_message));
+        connection.websocket_message.clear();
+        connection.request_in_flight = true;
+        const int fd = connection.fd;
+        const std::uint64_t connection_id = connection.id;
+        const bool submitted =
+            workers_->try_submit([this, fd, connection_id, session_id = connection.websocket_session, message]() {
+                post_completion(Completion{fd, connection_id, handle_websocket_message(session_id, *message), true});
+            });
+        if (!submitted) {
+            connection.request_in_flight = false;
+            LOG_WARNING("ApiServer", "Worker queue full - closing WebSocket on client_fd=" << fd);
+            return close_websocket(connection, 1013, "Server busy");
+        }
+    }
+    return true;
+}
+
+bool ApiServer::close_websocket(Connection& connection, std::uint16_t code, std::string_view reason)
+{
+    std::string frame;
+    append_websocket_frame(frame, WebSocketOpcode::Close, websocket_close_payload(code, reason));
+    return queue_response(connection, std::move(frame), true);
+}
+
+void ApiServer::post_completion(Completion completion)
+{
+    {
+        std::lock_guard<std::mutex> lock(completions_mutex_);
+        completions_.push_back(std::move(completion));
+    }
+    wake_event_loop();
+}
+
+void ApiServer::drain_completions()
+{
+    std::vector<Completion> ready;
+    std::vector<SessionEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(completions_mutex_);
+        ready.swap(completions_);
+        events.swap(events_);
+    }
+
+    for (auto& completion : ready) {
+        const auto it = connections_.find(completion.fd);
+        if (it == connections_.end() || it->second.id != completion.connection_id) {
+            LOG_DEBUG("ApiServer", "Dropping response for closed connection fd=" << completion.fd);
+            continue;
+        }
+        Connection& connection = it->second;
+        connection.request_in_flight = false;
+        connection.last_activity = std::chrono::steady_clock::now();
+        if (!connection.stream_session.empty()) {
+            if (completion.stream_version) {
+                open_stream(connection, std::move(completion.response), *completion.stream_version);
+                continue;
+            }
+            // The stream was refused; the error goes out like any response.
+            unsubscribe(connection);
+        }
+        if (!queue_response(connection, std::move(completion.response), !completion.keep_alive)) {
+            continue;
+        }
+        // Serve the next pipelined request, if one is already buffered.
+        dispatch_pending(connection);
     }
 
-    if (bytes_read < 0) {
-        LOG_WARNING("ApiServer", "recv failed for client_fd=" << client_fd << " errno=" << errno);
-        ::close(client_fd);
+    for (const auto& event : events) {
+        const auto subscribers = subscribers_.find(event.session_id);
+        if (subscribers == subscribers_.end()) {
+            continue;
+        }
+        // Delivery closes subscribers that fell behind, which edits the list.
+        const std::vector<int> fds = subscribers->second;
+        for (const int fd : fds) {
+            const auto it = connections_.find(fd);
+            if (it != connections_.end()) {
+                deliver_event(it->second, event);
+            }
+        }
+    }
+}
+
+void ApiServer::subscribe(Connection& connection, const std::string& session_id)
+{
+    connection.stream_session = session_id;
+    subscribers_[session_id].push_back(connection.fd);
+    std::lock_guard<std::mutex> lock(completions_mutex_);
+    ++watched_sessions_[session_id];
+}
+
+void ApiServer::unsubscribe(Connection& connection)
+{
+    if (connection.stream_session.empty()) {
         return;
     }
+    const auto subscribers = subscribers_.find(connection.stream_session);
+    if (subscribers != subscribers_.end()) {
+        std::erase(subscribers->second, connection.fd);
+        if (subscribers->second.empty()) {
+            subscribers_.erase(subscribers);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(completions_mutex_);
+        const auto watched = watched_sessions_.find(connection.stream_session);
+        if (watched != watched_sessions_.end() && --watched->second == 0) {
+            watched_sessions_.erase(watched);
+        }
+    }
+    connection.stream_session.clear();
+    connection.stream_open = false;
+    connection.stream_backlog.clear();
+}
+
+bool ApiServer::open_stream(Connection& connection, std::string response, std::uint64_t version)
+{
+    connection.stream_open = true;
+    connection.stream_version = version;
+    for (const auto& event : connection.stream_backlog) {
+        if (event.version > connection.stream_version) {
+            response.append(event.frame);
+            connection.stream_version = event.version;
+        }
+    }
+    connection.stream_backlog.clear();
+    LOG_INFO(
+        "ApiServer",
+        "Event stream opened for session " << connection.stream_session << " at version " << version
+    );
+    return queue_response(connection, std::move(response), false);
+}
+
+bool ApiServer::deliver_event(Connection& connection, const SessionEvent& event)
+{
+    if (!connection.stream_open) {
+        connection.stream_backlog.push_back(event);
+        return true;
+    }
+    if (event.version <= connection.stream_version) {
+        return true;
+    }
+    if (connection.write_buffer.size() - connection.write_offset > kMaxStreamBacklogBytes) {
+        LOG_WARNING("ApiServer", "Closing event stream on client_fd=" << connection.fd << " - subscriber fell behind");
+        close_connection(connection.fd);
+        return false;
+    }
+    connection.stream_version = event.version;
+    connection.last_activity = std::chrono::steady_clock::now();
+    return queue_response(connection, event.frame, false);
+}
+
+void ApiServer::send_stream_heartbeats()
+{
+    // Comment lines (pings, on WebSockets) keep proxies from timing out quiet
+    // connections and surface dead peers as send errors.
+    const auto cutoff = std::chrono::steady_clock::now() - kStreamHeartbeatInterval;
+    std::vector<int> quiet;
+    for (const auto& [fd, connection] : connections_) {
+        const bool idle_socket = !connection.websocket_session.empty() && !connection.request_in_flight;
+        if ((connection.stream_open || idle_socket) && connection.write_buffer.empty() &&
+            connection.last_activity < cutoff) {
+            quiet.push_back(fd);
+        }
+    }
+    for (const int fd : quiet) {
+        Connection& connection = connections_.at(fd);
+        connection.last_activity = std::chrono::steady_clock::now();
+        if (connection.websocket_session.empty()) {
+            queue_response(connection, ": keep-alive\n\n", false);
+        } else {
+            std::string ping;
+            append_websocket_frame(ping, WebSocketOpcode::Ping, {});
+            queue_response(connection, std::move(ping), false);
+        }
+    }
+}
+
+bool ApiServer::is_watched(const std::string& session_id)
+{
+    std::lock_guard<std::mutex> lock(completions_mutex_);
+    return watched_sessions_.contains(session_id);
+}
 
-    const auto header_end = request.find("\r\n\r\n");
-    if (header_end == std::string::npos) {
-        const auto response = build_error_response(400, "Invalid HTTP request");
-        ::send(client_fd, response.c_str(), response.size(), 0);
-        ::close(client_fd);
-        LOG_WARNING("ApiServer", "Rejected malformed request");
+void ApiServer::publish_changes(const std::string& session_id, const GameEngine& engine, std::uint64_t since)
+{
+    if (engine.version() == since || !is_watched(session_id)) {
         return;
     }
 
-    std::string headers = request.substr(0, header_end);
-    std::string body;
+    std::string data;
+    std::string_view event = "delta";
+    if (const auto delta = engine.changes_since(since)) {
+        JsonWriter(data).board_delta(*delta);
+    } else {
+        // A reset, or a move that outran the change journal.
+        event = "snapshot";
+        JsonWriter(data).board_snapshot(engine.snapshot());
+    }
+    {
+        std::lock_guard<std::mutex> lock(completions_mutex_);
+        events_.push_back(SessionEvent{session_id, engine.version(), event_frame(event, engine.version(), data)});
+    }
+    wake_event_loop();
+}
 
-    std::regex content_length_regex("Content-Length:\\s*(\\d+)", std::regex::icase);
-    std::smatch length_match;
-    std::size_t content_length = 0;
-    if (std::regex_search(headers, length_match, content_length_regex)) {
-        content_length = static_cast<std::size_t>(std::stoul(length_match[1]));
+void ApiServer::wake_event_loop()
+{
+    if (wake_fd_ < 0) {
+        return;
     }
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const auto written = ::write(wake_fd_, &one, sizeof(one));
+}
 
-    const std::size_t body_start = header_end + 4;
-    if (body_start < request.size()) {
-        body = request.substr(body_start);
+void ApiServer::close_connection(int fd)
+{
+    if (const auto it = connections_.find(fd); it != connections_.end()) {
+        unsubscribe(it->second);
     }
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections_.erase(fd);
+}
 
-    while (body.size() < content_length) {
-        bytes_read = ::recv(client_fd, buffer, sizeof(buffer), 0);
-        if (bytes_read <= 0) {
-            break;
+void ApiServer::close_all_connections()
+{
+    for (const auto& [fd, connection] : connections_) {
+        ::close(fd);
+    }
+    LOG_INFO("ApiServer", "Closed " << connections_.size() << " open connection(s)");
+    connections_.clear();
+    subscribers_.clear();
+    std::lock_guard<std::mutex> lock(completions_mutex_);
+    watched_sessions_.clear();
+}
+
+ApiServer::Completion ApiServer::handle_request(const HttpRequest& request, std::size_t remaining_requests)
+{
+    const std::string_view method = request.method;
+    const std::string_view path = request.path;
+    const std::string_view body = request.body;
+
+    const std::string session_id = session_id_of(request);
+    const bool keep_alive = remaining_requests > 0 && request.keep_alive();
+
+    HttpResponse response;
+    std::optional<std::uint64_t> stream_version;
+
+    // Coordinates are only range-checked by the board, so an out-of-bounds
+    // position surfaces here as std::out_of_range.
+    try {
+        if (method == "OPTIONS") {
+            response = HttpResponse{204, ""};
+            LOG_DEBUG("ApiServer", "Handled OPTIONS request");
+        } else if (!SessionRegistry::is_valid_session_id(session_id)) {
+            response = build_error_response(400, "Invalid session id");
+            LOG_WARNING("ApiServer", "Rejected request with invalid session id");
+        } else if (method == "GET" && path == "/api/board") {
+            response = handle_get_board(session_id, request);
+            LOG_DEBUG("ApiServer", "Handled GET /api/board");
+        } else if (method == "GET" && path == "/api/events") {
+            response = handle_get_events(session_id, request, stream_version);
+            LOG_DEBUG("ApiServer", "Handled GET /api/events");
+        } else if (method == "GET" && path == "/api/probabilities") {
+            response = handle_get_probabilities(session_id);
+            LOG_DEBUG("ApiServer", "Handled GET /api/probabilities");
+        } else if (method == "POST" && path == "/api/reveal") {
+            response = handle_post_reveal(session_id, body);
+            LOG_INFO("ApiServer", "Handled POST /api/reveal payload_size=" << body.size());
+        } else if (method == "POST" && path == "/api/chord") {
+            response = handle_post_chord(session_id, body);
+            LOG_INFO("ApiServer", "Handled POST /api/chord payload_size=" << body.size());
+        } else if (method == "POST" && path == "/api/flag") {
+            response = handle_post_flag(session_id, body);
+            LOG_INFO("ApiServer", "Handled POST /api/flag payload_size=" << body.size());
+        } else if (method == "POST" && path == "/api/auto-mark") {
+            response = handle_post_auto_mark(session_id, body);
+            LOG_INFO("ApiServer", "Handled POST /api/auto-mark payload_size=" << body.size());
+        } else if (method == "POST" && path == "/api/batch") {
+            response = handle_post_batch(session_id, body);
+            LOG_INFO("ApiServer", "Handled POST /api/batch payload_size=" << body.size());
+        } else if (method == "POST" && path == "/api/reset") {
+            response = handle_post_reset(session_id, request);
+            LOG_INFO("ApiServer", "Handled POST /api/reset payload_size=" << body.size());
+        } else {
+            response = build_error_response(404, "Endpoint not found");
+            LOG_WARNING(
+                "ApiServer",
+                "Unhandled route " << method << ' ' << path << " - returning 404"
+            );
         }
-        body.append(buffer, buffer + bytes_read);
+        if (!stream_version) {
+            compress_response(response, response_encoding(request));
+        }
+    } catch (const std::out_of_range& error) {
+        response = build_error_response(400, error.what());
+        LOG_WARNING("ApiServer", "Rejected " << method << ' ' << path << ": " << error.what());
+    } catch (const std::exception& error) {
+        response = build_error_response(500, "Internal server error");
+        LOG_ERROR("ApiServer", "Request " << method << ' ' << path << " failed: " << error.what());
     }
 
-    std::istringstream header_stream(headers);
-    std::string request_line;
-    std::getline(header_stream, request_line);
-    if (!request_line.empty() && request_line.back() == '\r') {
-        request_line.pop_back();
+    if (stream_version && response.status_code == 200) {
+        return Completion{-1, 0, std::string(kStreamHead) + response.body, true, stream_version};
     }
+    return Completion{-1, 0, build_http_response(response, keep_alive, remaining_requests), keep_alive};
+}
 
-    std::istringstream request_line_stream(request_line);
-    std::string method;
-    std::string path;
-    std::string version;
-    request_line_stream >> method >> path >> version;
+std::string ApiServer::session_id_of(const HttpRequest& request)
+{
+    // Sessions are named by the X-Session-Id header, or by ?session= for
+    // clients that cannot set headers. Anonymous callers share one game.
+    return std::string(
+        request.header("X-Session-Id")
+            .value_or(request.query_parameter("session").value_or(SessionRegistry::kDefaultSessionId))
+    );
+}
 
+std::string ApiServer::build_http_response(
+    const HttpResponse& http_response,
+    bool keep_alive,
+    std::size_t remaining_requests
+) const
+{
+    const auto& body = http_response.body;
     std::string response;
-
-    if (method == "OPTIONS") {
-        response = build_http_response(204, "");
-        LOG_DEBUG("ApiServer", "Handled OPTIONS request");
-    } else if (method == "GET" && path == "/api/board") {
-        response = handle_get_board();
-        LOG_DEBUG("ApiServer", "Handled GET /api/board");
-    } else if (method == "POST" && path == "/api/reveal") {
-        response = handle_post_reveal(body);
-        LOG_INFO("ApiServer", "Handled POST /api/reveal payload_size=" << body.size());
-    } else if (method == "POST" && path == "/api/flag") {
-        response = handle_post_flag(body);
-        LOG_INFO("ApiServer", "Handled POST /api/flag payload_size=" << body.size());
-    } else if (method == "POST" && path == "/api/auto-mark") {
-        response = handle_post_auto_mark(body);
-        LOG_INFO("ApiServer", "Handled POST /api/auto-mark payload_size=" << body.size());
-    } else if (method == "POST" && path == "/api/reset") {
-        response = handle_post_reset(body);
-        LOG_INFO("ApiServer", "Handled POST /api/reset payload_size=" << body.size());
+    response.reserve(kResponseHeadReserve + body.size());
+    response.append("HTTP/1.1 ");
+    append_decimal(response, static_cast<std::uint64_t>(http_response.status_code));
+    response.append(" ").append(reason_phrase(http_response.status_code));
+    response.append("\r\n"
+                    "Access-Control-Allow-Origin: *\r\n"
+                    "Access-Control-Allow-Headers: Content-Type, X-Session-Id, If-None-Match\r\n"
+                    "Access-Control-Allow-Methods: GET,POST,OPTIONS\r\n"
+                    "Access-Control-Expose-Headers: ETag\r\n"
+                    "Vary: Accept, Accept-Encoding\r\n"
+                    "Content-Type: ");
+    response.append(http_response.content_type).append("\r\n");
+    if (!http_response.content_encoding.empty()) {
+        response.append("Content-Encoding: ").append(http_response.content_encoding).append("\r\n");
+    }
+    if (!http_response.etag.empty()) {
+        response.append("ETag: ").append(http_response.etag).append("\r\n");
+    }
+    response.append("Content-Length: ");
+    append_decimal(response, body.size());
+    if (keep_alive) {
+        response.append("\r\nConnection: keep-alive\r\nKeep-Alive: timeout=");
+        append_decimal(response, static_cast<std::uint64_t>(options_.keep_alive_timeout.count()));
+        response.append(", max=");
+        append_decimal(response, remaining_requests);
+        response.append("\r\n\r\n");
     } else {
-        response = build_error_response(404, "Endpoint not found");
-        LOG_WARNING(
-            "ApiServer",
-            "Unhandled route " << method << ' ' << path << " - returning 404"
-        );
+        response.append("\r\nConnection: close\r\n\r\n");
     }
+    response.append(body);
+    return response;
+}
 
-    ::send(client_fd, response.c_str(), response.size(), 0);
-    ::close(client_fd);
-
-    LOG_DEBUG("ApiServer", "Response sent and connection closed");
+ApiServer::HttpResponse ApiServer::build_error_response(int status_code, const std::string& message)
+{
+    std::string payload;
+    JsonWriter(payload).raw("{\"error\":").string(message).raw("}");
+    return HttpResponse{status_code, std::move(payload)};
 }
 
-std::string ApiServer::build_http_response(int status_code, const std::string& body)
+void ApiServer::sweep_idle_connections()
 {
-    std::ostringstream response;
-    response << "HTTP/1.1 " << status_code << ' ' << reason_phrase(status_code) << "\r\n";
-    response << "Access-Control-Allow-Origin: *\r\n";
-    response << "Access-Control-Allow-Headers: Content-Type\r\n";
-    response << "Access-Control-Allow-Methods: GET,POST,OPTIONS\r\n";
-    response << "Content-Type: application/json\r\n";
-    response << "Content-Length: " << body.size() << "\r\n";
-    response << "Connection: close\r\n\r\n";
-    response << body;
-    return response.str();
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_connection_sweep_ < std::chrono::seconds(1)) {
+        return;
+    }
+    last_connection_sweep_ = now;
+
+    // Connections waiting on a worker or flushing a response are busy, not
+    // idle; everything else (keep-alive waits and half-sent requests alike)
+    // is closed once it has been silent for the keep-alive timeout.
+    const auto cutoff = now - options_.keep_alive_timeout;
+    std::vector<int> expired;
+    for (const auto& [fd, connection] : connections_) {
+        if (connection.stream_session.empty() && connection.websocket_session.empty() && !connection.request_in_flight && connection.write_buffer.empty() && connection.last_activity < cutoff) {
+            expired.push_back(fd);
+        }
+    }
+    for (const int fd : expired) {
+        close_connection(fd);
+    }
+    if (!expired.empty()) {
+        LOG_DEBUG("ApiServer", "Closed " << expired.size() << " idle keep-alive connection(s)");
+    }
+    send_stream_heartbeats();
 }
 
-std::string ApiServer::build_error_response(int status_code, const std::string& message)
+void ApiServer::sweep_idle_sessions()
 {
-    std::ostringstream payload;
-    payload << "{\"error\":\"" << message << "\"}";
-    return build_http_response(status_code, payload.str());
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_eviction_sweep_ < kEvictionSweepInterval) {
+        return;
+    }
+    last_eviction_sweep_ = now;
+    sessions_->evict_idle();
 }
 
-std::string ApiServer::status_to_string(GameStatus status)
+ApiServer::HttpResponse ApiServer::handle_get_board(const std::string& session_id, const HttpRequest& request) const
 {
-    switch (status) {
-    case GameStatus::Playing:
-        return "playing";
-    case GameStatus::Victory:
-        return "victory";
-    case GameStatus::Defeat:
-        return "defeat";
+    std::optional<std::uint64_t> since;
+    if (const auto since_text = request.query_parameter("since")) {
+        since = parse_version(*since_text);
+        if (!since) {
+            return build_error_response(400, "Invalid since parameter");
+        }
+    }
+
+    const bool compact = wants_compact_board(request);
+    const ContentEncoding encoding = response_encoding(request);
+    const auto session = sessions_->acquire(session_id);
+    // The version names the whole board state, so a client holding the
+    // current one gets neither a snapshot nor a delta. The 304 repeats the
+    // tag the snapshot would have been sent with.
+    const auto if_none_match = request.header("If-None-Match");
+    if (if_none_match && etag_matches(*if_none_match, make_etag(session->version(), compact))) {
+        LOG_DEBUG("ApiServer", "Board unchanged at version " << session->version());
+        return HttpResponse{304, "", snapshot_etag(session->version(), compact, encoding)};
+    }
+
+    std::string payload;
+    if (since) {
+        if (const auto delta = session->changes_since(*since)) {
+            LOG_DEBUG(
+                "ApiServer",
+                "Delta requested since version " << *since << " - " << delta->updated_cells.size() << " cell(s)"
+            );
+            JsonWriter(payload).board_delta(*delta);
+            return HttpResponse{200, std::move(payload), delta_etag(session->version(), *since)};
+        }
+        LOG_DEBUG("ApiServer", "Version " << *since << " is outside the change journal - sending snapshot");
     }
-    return "playing";
+
+    return snapshot_response(session, compact, encoding);
 }
 
-std::string ApiServer::handle_get_board() const
+ApiServer::HttpResponse ApiServer::snapshot_response(
+    const SessionRegistry::Lease& session,
+    bool compact,
+    ContentEncoding encoding
+) const
 {
-    std::lock_guard<std::mutex> guard(engine_mutex_);
-    const auto snapshot = engine_->snapshot();
+    const auto version = session->version();
+    const std::string_view content_type = compact ? kCompactBoardType : kJsonType;
+    std::string cache_key;
+    if (encoding != ContentEncoding::Identity) {
+        cache_key.append(content_encoding_name(encoding)).append(compact ? "+compact" : "+json");
+        for (const auto& entry : session.cache()) {
+            if (entry.key == cache_key && entry.version == version) {
+                LOG_DEBUG("ApiServer", "Serving cached " << cache_key << " snapshot for version " << version);
+                return HttpResponse{
+                    200, entry.value, snapshot_etag(version, compact, encoding), content_type,
+                    content_encoding_name(encoding)
+                };
+            }
+        }
+    }
+
+    const auto snapshot = session->snapshot();
     LOG_DEBUG(
         "ApiServer",
-        "Snapshot requested - status=" << status_to_string(snapshot.status)
+        "Snapshot requested - status=" << game_status_name(snapshot.status)
             << ", flags_remaining=" << snapshot.flags_remaining
     );
-    return build_http_response(200, serialize_board_snapshot(snapshot));
+    HttpResponse response{200, "", snapshot_etag(version, compact, encoding), content_type};
+    if (compact) {
+        JsonWriter(response.body).compact_board_snapshot(snapshot);
+    } else {
+        JsonWriter(response.body).board_snapshot(snapshot);
+    }
+    compress_response(response, encoding);
+    if (!response.content_encoding.empty()) {
+        auto& cache = session.cache();
+        const auto slot = std::find_if(cache.begin(), cache.end(), [&](const auto& entry) {
+            return entry.key == cache_key;
+        });
+        if (slot == cache.end()) {
+            cache.push_back(SessionCacheEntry{std::move(cache_key), version, response.body});
+        } else {
+            slot->version = version;
+            slot->value = response.body;
+        }
+    }
+    return response;
+}
+
+ContentEncoding ApiServer::response_encoding(const HttpRequest& request) const
+{
+    const auto accept_encoding = request.header("Accept-Encoding");
+    if (options_.compression_level == 0 || !accept_encoding) {
+        return ContentEncoding::Identity;
+    }
+    return negotiate_content_encoding(*accept_encoding);
 }
 
-std::string ApiServer::handle_post_reveal(const std::string& body)
+void ApiServer::compress_response(HttpResponse& response, ContentEncoding encoding) const
 {
-    const auto position = parse_position(body);
+    // 204 and 304 carry no body, and the headers of a 304 must describe the
+    // cached representation rather than a new one.
+    if (encoding == ContentEncoding::Identity || !response.content_encoding.empty() || response.body.empty() ||
+        response.status_code == 204 || response.status_code == 304 ||
+        response.body.size() < options_.compression_threshold) {
+        return;
+    }
+    const std::size_t original_size = response.body.size();
+    response.body = compress_body(response.body, encoding, options_.compression_level);
+    response.content_encoding = content_encoding_name(encoding);
+    // The coded bytes differ from the identity ones, so the tag can only be
+    // weak; If-None-Match compares weakly anyway.
+    if (!response.etag.empty() && !response.etag.starts_with("W/")) {
+        response.etag.insert(0, "W/");
+    }
+    LOG_DEBUG(
+        "ApiServer",
+        "Compressed " << original_size << " byte body to " << response.body.size() << " (" << response.content_encoding
+                      << ")"
+    );
+}
+
+ApiServer::HttpResponse ApiServer::handle_get_events(
+    const std::string& session_id,
+    const HttpRequest& request,
+    std::optional<std::uint64_t>& stream_version
+) const
+{
+    const auto session = sessions_->acquire(session_id);
+    const GameEngine& engine = session.engine();
+
+    // A reconnecting EventSource resumes with a delta when the change journal
+    // still reaches the last version it saw.
+    std::string data;
+    std::string_view event = "snapshot";
+    if (const auto last_event_id = request.header("Last-Event-ID")) {
+        if (const auto last_version = parse_version(*last_event_id)) {
+            if (const auto delta = engine.changes_since(*last_version)) {
+                event = "delta";
+                JsonWriter(data).board_delta(*delta);
+            }
+        }
+    }
+    if (data.empty()) {
+        JsonWriter(data).board_snapshot(engine.snapshot());
+    }
+    stream_version = engine.version();
+    return HttpResponse{200, event_frame(event, engine.version(), data)};
+}
+
+ApiServer::HttpResponse ApiServer::handle_get_probabilities(const std::string& session_id) const
+{
+    const auto session = sessions_->acquire(session_id);
+    const auto probabilities = session->mine_probabilities();
+    if (probabilities.status == ProbabilityStatus::Inconsistent) {
+        return build_error_response(409, "No mine layout matches the revealed numbers and flags");
+    }
+    if (probabilities.status == ProbabilityStatus::TooComplex) {
+        return build_error_response(422, "Frontier too complex for exact probabilities");
+    }
+
+    std::string payload;
+    JsonWriter writer(payload);
+    writer.raw("{\"frontierCells\":").number(probabilities.frontier_cells);
+    writer.raw(",\"components\":").number(probabilities.components);
+    writer.raw(",\"cells\":").cell_probabilities(probabilities.cells).raw("}");
+    return HttpResponse{200, std::move(payload)};
+}
+
+ApiServer::HttpResponse ApiServer::handle_post_reveal(const std::string& session_id, std::string_view body)
+{
+    std::string error;
+    const auto position = parse_position(body, error);
     if (!position) {
-        LOG_WARNING("ApiServer", "Rejecting reveal - invalid payload: " << body);
-        return build_error_response(400, "Invalid reveal payload");
+        LOG_WARNING("ApiServer", "Rejecting reveal - invalid payload (" << error << "): " << body);
+        return build_error_response(400, "Invalid reveal payload: " + error);
     }
 
-    std::lock_guard<std::mutex> guard(engine_mutex_);
-    const auto result = engine_->reveal_cell(*position);
-    const auto snapshot = engine_->snapshot();
+    const auto session = sessions_->acquire(session_id);
+    const auto before = session->version();
+    const auto result = session->reveal_cell(*position);
+    publish_changes(session_id, session.engine(), before);
 
     LOG_INFO(
         "ApiServer",
         "Reveal at (" << position->row << ',' << position->column << ") -> hitMine="
                        << format_bool(result.hit_mine) << ", victory=" << format_bool(result.victory)
     );
+    return build_reveal_response(result, session->status(), session->version());
+}
+
+ApiServer::HttpResponse ApiServer::handle_post_chord(const std::string& session_id, std::string_view body)
+{
+    std::string error;
+    const auto position = parse_position(body, error);
+    if (!position) {
+        LOG_WARNING("ApiServer", "Rejecting chord - invalid payload (" << error << "): " << body);
+        return build_error_response(400, "Invalid chord payload: " + error);
+    }
+
+    const auto session = sessions_->acquire(session_id);
+    const auto before = session->version();
+    const auto result = session->chord_cell(*position);
+    publish_changes(session_id, session.engine(), before);
 
-    std::ostringstream payload;
-    payload << "{\"updatedCells\":" << serialize_cells(result.updated_cells)
-            << ",\"hitMine\":" << format_bool(result.hit_mine)
-            << ",\"victory\":" << format_bool(result.victory)
-            << ",\"flagsRemaining\":" << result.flags_remaining
-            << ",\"status\":\"" << status_to_string(snapshot.status) << "\"}";
+    LOG_INFO(
+        "ApiServer",
+        "Chord at (" << position->row << ',' << position->column << ") revealed " << result.updated_cells.size()
+                     << " cell(s) -> hitMine=" << format_bool(result.hit_mine)
+                     << ", victory=" << format_bool(result.victory)
+    );
+    return build_reveal_response(result, session->status(), session->version());
+}
 
-    return build_http_response(200, payload.str());
+ApiServer::HttpResponse ApiServer::build_reveal_response(
+    const RevealResult& result,
+    GameStatus status,
+    std::uint64_t version
+)
+{
+    std::string payload;
+    JsonWriter writer(payload);
+    writer.raw("{\"updatedCells\":").cells(result.updated_cells);
+    writer.raw(",\"hitMine\":").boolean(result.hit_mine);
+    writer.raw(",\"victory\":").boolean(result.victory);
+    writer.raw(",\"flagsRemaining\":").number(result.flags_remaining);
+    writer.raw(",\"status\":\"").raw(game_status_name(status));
+    writer.raw("\",\"version\":").number(static_cast<std::size_t>(version)).raw("}");
+
+    return HttpResponse{200, std::move(payload)};
 }
 
-std::string ApiServer::handle_post_flag(const std::string& body)
+ApiServer::HttpResponse ApiServer::handle_post_flag(const std::string& session_id, std::string_view body)
 {
-    const auto position = parse_position(body);
+    std::string error;
+    const auto position = parse_position(body, error);
     if (!position) {
-        LOG_WARNING("ApiServer", "Rejecting flag - invalid payload: " << body);
-        return build_error_response(400, "Invalid flag payload");
+        LOG_WARNING("ApiServer", "Rejecting flag - invalid payload (" << error << "): " << body);
+        return build_error_response(400, "Invalid flag payload: " + error);
     }
 
-    std::lock_guard<std::mutex> guard(engine_mutex_);
-    const auto result = engine_->toggle_flag(*position);
-    const auto snapshot = engine_->snapshot();
+    const auto session = sessions_->acquire(session_id);
+    const auto before = session->version();
+    const auto result = session->toggle_flag(*position);
+    publish_changes(session_id, session.engine(), before);
 
     LOG_INFO(
         "ApiServer",
@@ -384,68 +1374,106 @@ std::string ApiServer::handle_post_flag(const std::string& body)
                             << result.flags_remaining
     );
 
-    std::ostringstream payload;
-    payload << "{\"updatedCell\":" << serialize_cell(result.updated_cell)
-            << ",\"flagsRemaining\":" << result.flags_remaining
-            << ",\"victory\":" << format_bool(result.victory)
-            << ",\"status\":\"" << status_to_string(snapshot.status) << "\"}";
+    std::string payload;
+    JsonWriter writer(payload);
+    writer.raw("{\"updatedCell\":").cell(result.updated_cell);
+    writer.raw(",\"flagsRemaining\":").number(result.flags_remaining);
+    writer.raw(",\"victory\":").boolean(result.victory);
+    writer.raw(",\"status\":\"").raw(game_status_name(session->status()));
+    writer.raw("\",\"version\":").number(static_cast<std::size_t>(session->version())).raw("}");
 
-    return build_http_response(200, payload.str());
+    return HttpResponse{200, std::move(payload)};
 }
 
-std::string ApiServer::handle_post_auto_mark(const std::string& body)
+ApiServer::HttpResponse ApiServer::handle_post_auto_mark(const std::string& session_id, std::string_view body)
 {
-    const auto selection = parse_selection(body);
+    std::string error;
+    const auto selection = parse_selection(body, error);
     if (!selection) {
-        LOG_WARNING("ApiServer", "Rejecting auto-mark - invalid payload: " << body);
-        return build_error_response(400, "Invalid selection payload");
+        LOG_WARNING("ApiServer", "Rejecting auto-mark - invalid payload (" << error << "): " << body);
+        return build_error_response(400, "Invalid selection payload: " + error);
     }
 
-    std::lock_guard<std::mutex> guard(engine_mutex_);
-    const auto auto_result = engine_->auto_mark(*selection);
-    const auto snapshot = engine_->snapshot();
+    const auto session = sessions_->acquire(session_id);
+    const auto before = session->version();
+    const auto auto_result = session->auto_mark(*selection);
+    publish_changes(session_id, session.engine(), before);
 
     if (auto_result) {
         LOG_INFO(
             "ApiServer",
-            "Auto-mark flagged " << auto_result->flagged_cells.size() << " cell(s) - flags remaining: "
+            "Auto-mark flagged " << auto_result->flagged_cells.size() << " cell(s), found "
+                                 << auto_result->safe_cells.size() << " safe - flags remaining: "
                                  << auto_result->flags_remaining
         );
     } else {
         LOG_DEBUG("ApiServer", "Auto-mark produced no new flags");
     }
 
-    std::ostringstream payload;
+    std::string payload;
+    JsonWriter writer(payload);
     if (auto_result) {
-        payload << "{\"flaggedCells\":" << serialize_cells(auto_result->flagged_cells)
-                << ",\"flagsRemaining\":" << auto_result->flags_remaining
-                << ",\"victory\":" << format_bool(auto_result->victory)
-                << ",\"status\":\"" << status_to_string(snapshot.status) << "\"}";
+        writer.raw("{\"flaggedCells\":").cells(auto_result->flagged_cells);
+        writer.raw(",\"safeCells\":").cells(auto_result->safe_cells);
+        writer.raw(",\"flagsRemaining\":").number(auto_result->flags_remaining);
     } else {
-        payload << "{\"flaggedCells\":[]"
-                << ",\"flagsRemaining\":" << snapshot.flags_remaining
-                << ",\"victory\":" << format_bool(snapshot.status == GameStatus::Victory)
-                << ",\"status\":\"" << status_to_string(snapshot.status) << "\"}";
+        writer.raw("{\"flaggedCells\":[],\"safeCells\":[]");
+        writer.raw(",\"flagsRemaining\":").number(session->flags_remaining());
+    }
+    writer.raw(",\"victory\":").boolean(session->status() == GameStatus::Victory);
+    writer.raw(",\"status\":\"").raw(game_status_name(session->status()));
+    writer.raw("\",\"version\":").number(static_cast<std::size_t>(session->version())).raw("}");
+
+    return HttpResponse{200, std::move(payload)};
+}
+
+ApiServer::HttpResponse ApiServer::handle_post_batch(const std::string& session_id, std::string_view body)
+{
+    std::string error;
+    const auto moves = parse_batch(body, error);
+    if (!moves) {
+        LOG_WARNING("ApiServer", "Rejecting batch - invalid payload (" << error << ")");
+        return build_error_response(400, "Invalid batch payload: " + error);
     }
 
-    return build_http_response(200, payload.str());
+    // One lease covers the whole batch, and the result carries the status,
+    // so no snapshot is taken.
+    const auto session = sessions_->acquire(session_id);
+    const auto before = session->version();
+    const auto result = session->apply_batch(*moves);
+    publish_changes(session_id, session.engine(), before);
+
+    std::string payload;
+    JsonWriter writer(payload);
+    writer.raw("{\"updatedCells\":").cells(result.updated_cells);
+    writer.raw(",\"applied\":").number(result.applied);
+    writer.raw(",\"hitMine\":").boolean(result.hit_mine);
+    writer.raw(",\"victory\":").boolean(result.victory);
+    writer.raw(",\"flagsRemaining\":").number(result.flags_remaining);
+    writer.raw(",\"status\":\"").raw(game_status_name(result.status));
+    writer.raw("\",\"version\":").number(static_cast<std::size_t>(session->version())).raw("}");
+
+    return HttpResponse{200, std::move(payload)};
 }
 
-std::string ApiServer::handle_post_reset(const std::string& body)
+ApiServer::HttpResponse ApiServer::handle_post_reset(const std::string& session_id, const HttpRequest& request)
 {
+    const std::string_view body = request.body;
     std::optional<BoardConfig> config;
 
     if (!body.empty() && !is_whitespace_only(body)) {
-        config = parse_board_config(body);
+        std::string error;
+        config = parse_board_config(body, error);
         if (!config) {
-            LOG_WARNING("ApiServer", "Rejecting reset - invalid configuration payload: " << body);
-            return build_error_response(400, "Invalid board configuration");
+            LOG_WARNING("ApiServer", "Rejecting reset - invalid configuration payload (" << error << "): " << body);
+            return build_error_response(400, "Invalid board configuration: " + error);
         }
     }
 
-    std::lock_guard<std::mutex> guard(engine_mutex_);
+    const auto session = sessions_->acquire(session_id);
+    const auto before = session->version();
     try {
-        engine_->reset(config);
+        session->reset(config);
     } catch (const std::invalid_argument& error) {
         LOG_WARNING("ApiServer", "Reset rejected: " << error.what());
         return build_error_response(400, error.what());
@@ -453,7 +1481,7 @@ std::string ApiServer::handle_post_reset(const std::string& body)
         LOG_ERROR("ApiServer", "Reset failed due to unexpected error");
         return build_error_response(500, "Unable to reset board");
     }
-    const auto snapshot = engine_->snapshot();
+    publish_changes(session_id, session.engine(), before);
     if (config) {
         LOG_INFO(
             "ApiServer",
@@ -462,124 +1490,241 @@ std::string ApiServer::handle_post_reset(const std::string& body)
     } else {
         LOG_INFO("ApiServer", "Board reset via API using existing configuration");
     }
-    return build_http_response(200, serialize_board_snapshot(snapshot));
+    return snapshot_response(session, wants_compact_board(request), response_encoding(request));
 }
 
-std::optional<Position> ApiServer::parse_position(const std::string& body)
+std::string ApiServer::handle_websocket_message(const std::string& session_id, std::string_view payload)
 {
-    std::regex row_regex("\"row\"\\s*:\\s*(\\d+)");
-    std::regex column_regex("\"column\"\\s*:\\s*(\\d+)");
-    std::smatch row_match;
-    std::smatch column_match;
-
-    if (!std::regex_search(body, row_match, row_regex) || !std::regex_search(body, column_match, column_regex)) {
-        return std::nullopt;
+    std::vector<std::string> replies(1);
+    std::string error;
+    const auto request = decode_binary_request(payload, error);
+    if (!request) {
+        LOG_WARNING("ApiServer", "Rejecting WebSocket message - " << error);
+        append_binary_error(replies.back(), "Invalid message: " + error);
+    } else if (request->moves.size() > kMaxBatchMoves) {
+        append_binary_error(replies.back(), "Invalid message: too many moves");
+    } else {
+        const auto session = sessions_->acquire(session_id);
+        try {
+            if (!request->moves.empty()) {
+                const auto before = session->version();
+                const auto result = session->apply_batch(request->moves);
+                publish_changes(session_id, session.engine(), before);
+                append_binary_delta(replies.back(), result, session->version());
+            }
+            if (request->wants_snapshot) {
+                if (!replies.back().empty()) {
+                    replies.emplace_back();
+                }
+                append_binary_snapshot(replies.back(), session.engine());
+            }
+        } catch (const std::out_of_range& move_error) {
+            append_binary_error(replies.back(), move_error.what());
+        } catch (const std::exception& failure) {
+            LOG_ERROR("ApiServer", "WebSocket message failed: " << failure.what());
+            replies.back().clear();
+            append_binary_error(replies.back(), "Internal server error");
+        }
+        LOG_DEBUG(
+            "ApiServer",
+            "WebSocket message applied " << request->moves.size() << " move(s) for session " << session_id
+        );
     }
 
-    Position position{
-        static_cast<std::size_t>(std::stoull(row_match[1])),
-        static_cast<std::size_t>(std::stoull(column_match[1]))
-    };
-    return position;
+    std::string frames;
+    for (const auto& reply : replies) {
+        if (!reply.empty()) {
+            append_websocket_frame(frames, WebSocketOpcode::Binary, reply);
+        }
+    }
+    return frames;
 }
 
-std::optional<SelectionRect> ApiServer::parse_selection(const std::string& body)
+std::optional<Position> ApiServer::parse_position(std::string_view body, std::string& error)
 {
-    std::regex row_begin_regex("\"rowBegin\"\\s*:\\s*(\\d+)");
-    std::regex col_begin_regex("\"colBegin\"\\s*:\\s*(\\d+)");
-    std::regex row_end_regex("\"rowEnd\"\\s*:\\s*(\\d+)");
-    std::regex col_end_regex("\"colEnd\"\\s*:\\s*(\\d+)");
-
-    std::smatch match;
-    SelectionRect rect{};
-
-    if (!std::regex_search(body, match, row_begin_regex)) {
-        return std::nullopt;
-    }
-    rect.row_begin = static_cast<std::size_t>(std::stoull(match[1]));
-
-    if (!std::regex_search(body, match, row_end_regex)) {
-        return std::nullopt;
-    }
-    rect.row_end = static_cast<std::size_t>(std::stoull(match[1]));
-
-    if (!std::regex_search(body, match, col_begin_regex)) {
+    Position position{};
+    JsonReader reader(body);
+    std::array<JsonUnsignedField, 2> fields{{
+        {"row", &position.row},
+        {"column", &position.column},
+    }};
+    if (!read_unsigned_fields(reader, fields)) {
+        error = reader.error_message();
         return std::nullopt;
     }
-    rect.col_begin = static_cast<std::size_t>(std::stoull(match[1]));
+    return position;
+}
 
-    if (!std::regex_search(body, match, col_end_regex)) {
+std::optional<SelectionRect> ApiServer::parse_selection(std::string_view body, std::string& error)
+{
+    SelectionRect rect{};
+    JsonReader reader(body);
+    std::array<JsonUnsignedField, 4> fields{{
+        {"rowBegin", &rect.row_begin},
+        {"colBegin", &rect.col_begin},
+        {"rowEnd", &rect.row_end},
+        {"colEnd", &rect.col_end},
+    }};
+    if (!read_unsigned_fields(reader, fields)) {
+        error = reader.error_message();
         return std::nullopt;
     }
-    rect.col_end = static_cast<std::size_t>(std::stoull(match[1]));
-
     return rect;
 }
 
-std::optional<BoardConfig> ApiServer::parse_board_config(const std::string& body)
+std::optional<std::vector<Move>> ApiServer::parse_batch(std::string_view body, std::string& error)
 {
-    std::regex rows_regex("\"rows\"\\s*:\\s*(\\d+)");
-    std::regex columns_regex("\"columns\"\\s*:\\s*(\\d+)");
-    std::regex mines_regex("\"mines\"\\s*:\\s*(\\d+)");
-
-    std::smatch rows_match;
-    std::smatch columns_match;
-    std::smatch mines_match;
+    std::vector<Move> moves;
+    bool moves_present = false;
+    JsonReader reader(body);
+
+    // {"op": "reveal" | "flag" | "chord", "row", "column"} or
+    // {"op": "autoMark", "rowBegin", "colBegin", "rowEnd", "colEnd"}.
+    const auto read_move = [&reader, &moves]() {
+        Move move{MoveType::Reveal};
+        bool type_present = false;
+        std::array<JsonUnsignedField, 6> fields{{
+            {"row", &move.position.row},
+            {"column", &move.position.column},
+            {"rowBegin", &move.selection.row_begin},
+            {"colBegin", &move.selection.col_begin},
+            {"rowEnd", &move.selection.row_end},
+            {"colEnd", &move.selection.col_end},
+        }};
+        const bool parsed = reader.read_object([&](std::string_view key) {
+            if (key == "op") {
+                if (type_present) {
+                    return reader.fail("duplicate field", key);
+                }
+                type_present = true;
+                std::string_view name;
+                if (!reader.read_string(name)) {
+                    return false;
+                }
+                const std::array<std::pair<std::string_view, MoveType>, 4> types{{
+                    {"reveal", MoveType::Reveal},
+                    {"flag", MoveType::Flag},
+                    {"chord", MoveType::Chord},
+                    {"autoMark", MoveType::AutoMark},
+                }};
+                for (const auto& [type_name, type] : types) {
+                    if (name == type_name) {
+                        move.type = type;
+                        return true;
+                    }
+                }
+                return reader.fail("unknown option", key);
+            }
+            for (auto& field : fields) {
+                if (field.name == key) {
+                    if (field.present) {
+                        return reader.fail("duplicate field", key);
+                    }
+                    field.present = true;
+                    return reader.read_unsigned(*field.value);
+                }
+            }
+            return reader.skip_value();
+        });
+        if (!parsed) {
+            return false;
+        }
+        if (!type_present) {
+            return reader.fail_missing("op");
+        }
+        const bool is_auto_mark = move.type == MoveType::AutoMark;
+        for (std::size_t i = 0; i < fields.size(); ++i) {
+            if ((i >= 2) == is_auto_mark && !fields[i].present) {
+                return reader.fail_missing(fields[i].name);
+            }
+        }
+        moves.push_back(move);
+        return true;
+    };
 
-    if (!std::regex_search(body, rows_match, rows_regex) ||
-        !std::regex_search(body, columns_match, columns_regex) ||
-        !std::regex_search(body, mines_match, mines_regex)) {
+    const bool parsed = reader.read_object([&](std::string_view key) {
+        if (key != "moves") {
+            return reader.skip_value();
+        }
+        if (moves_present) {
+            return reader.fail("duplicate field", key);
+        }
+        moves_present = true;
+        return reader.read_array([&](std::size_t index) {
+            if (index >= kMaxBatchMoves) {
+                return reader.fail("too many moves", key);
+            }
+            return read_move();
+        });
+    });
+    if (!parsed || !reader.finish()) {
+        error = reader.error_message();
         return std::nullopt;
     }
-
-    BoardConfig config{
-        static_cast<std::size_t>(std::stoull(rows_match[1])),
-        static_cast<std::size_t>(std::stoull(columns_match[1])),
-        static_cast<std::size_t>(std::stoull(mines_match[1]))
-    };
-    return config;
-}
-
-std::string ApiServer::serialize_board_snapshot(const BoardSnapshot& snapshot) const
-{
-    std::ostringstream payload;
-    payload << "{\"rows\":" << snapshot.rows
-            << ",\"columns\":" << snapshot.columns
-            << ",\"mines\":" << snapshot.mines
-            << ",\"flagsRemaining\":" << snapshot.flags_remaining
-            << ",\"status\":\"" << status_to_string(snapshot.status) << "\""
-            << ",\"cells\":" << serialize_cells(snapshot.cells) << "}";
-    return payload.str();
+    if (!moves_present) {
+        reader.fail_missing("moves");
+        error = reader.error_message();
+        return std::nullopt;
+    }
+    return moves;
 }
 
-std::string ApiServer::serialize_cells(const std::vector<Cell>& cells) const
+std::optional<BoardConfig> ApiServer::parse_board_config(std::string_view body, std::string& error)
 {
-    std::ostringstream buffer;
-    buffer << '[';
-    for (std::size_t i = 0; i < cells.size(); ++i) {
-        buffer << serialize_cell(cells[i]);
-        if (i + 1 < cells.size()) {
-            buffer << ',';
+    BoardConfig config{};
+    std::size_t seed = 0;
+    bool generator_present = false;
+    bool safe_start_present = false;
+    JsonReader reader(body);
+    std::array<JsonUnsignedField, 4> fields{{
+        {"rows", &config.rows},
+        {"columns", &config.columns},
+        {"mines", &config.mines},
+        {"seed", &seed, false},
+    }};
+    // Reads a string member that must name one of choices.
+    const auto read_choice = [&reader](std::string_view key, bool& present, auto choices, auto& value) {
+        if (present) {
+            return reader.fail("duplicate field", key);
+        }
+        present = true;
+        std::string_view name;
+        if (!reader.read_string(name)) {
+            return false;
         }
+        for (const auto& [choice_name, choice] : choices) {
+            if (name == choice_name) {
+                value = choice;
+                return true;
+            }
+        }
+        return reader.fail("unknown option", key);
+    };
+    const bool parsed = read_unsigned_fields(reader, fields, [&](std::string_view key) {
+        if (key == "generator") {
+            const std::array<std::pair<std::string_view, BoardGenerator>, 2> generators{{
+                {board_generator_name(BoardGenerator::Mt19937), BoardGenerator::Mt19937},
+                {board_generator_name(BoardGenerator::Counter), BoardGenerator::Counter},
+            }};
+            return read_choice(key, generator_present, generators, config.generator);
+        }
+        if (key == "safeStart") {
+            const std::array<std::pair<std::string_view, SafeStart>, 2> safe_starts{{
+                {safe_start_name(SafeStart::Cell), SafeStart::Cell},
+                {safe_start_name(SafeStart::Neighborhood), SafeStart::Neighborhood},
+            }};
+            return read_choice(key, safe_start_present, safe_starts, config.safe_start);
+        }
+        return reader.skip_value();
+    });
+    if (!parsed) {
+        error = reader.error_message();
+        return std::nullopt;
     }
-    buffer << ']';
-    return buffer.str();
-}
-
-std::string ApiServer::serialize_cell(const Cell& cell) const
-{
-    const bool mine_visible = cell.state == CellState::Revealed && cell.is_mine;
-    const int adjacent_value = (cell.state == CellState::Revealed && !cell.is_mine) ? cell.adjacent_mines : 0;
-
-    std::ostringstream out;
-    out << "{\"row\":" << cell.position.row
-        << ",\"column\":" << cell.position.column
-        << ",\"state\":\"" << cell_state_to_string(cell.state) << "\""
-        << ",\"adjacentMines\":" << adjacent_value
-        << ",\"isMine\":" << format_bool(mine_visible)
-        << ",\"exploded\":" << format_bool(cell.exploded)
-        << '}';
-    return out.str();
+    if (fields[3].present) {
+        config.seed = seed;
+    }
+    return config;
 }
 
 }  // namespace clearbomb
@@ -1,112 +1,281 @@
 #include "AutoMarker.hpp"
 #include "Logger.hpp"
 
+#include <algorithm>
+#include <array>
 #include <unordered_set>
 
 namespace clearbomb {
 
 namespace {
-struct PositionHash {
-    std::size_t operator()(const Position& position) const noexcept
-    {
-        return (position.row << 16) ^ position.column;
-    }
+// Derived constraints are always subsets of one cell's neighbourhood, so
+// eight slots suffice. Cells are kept sorted for merge-style set tests.
+struct Constraint {
+    std::array<std::size_t, 8> cells {};
+    std::size_t size {0};
+    int mines {0};
+
+    const std::size_t* begin() const noexcept { return cells.data(); }
+    const std::size_t* end() const noexcept { return cells.data() + size; }
 };
 
-const char* cell_state_name(CellState state)
+enum class Knowledge : std::uint8_t {
+    Unknown,
+    Mine,
+    Safe
+};
+
+// Bounds the work on pathological selections; real boards settle long
+// before either limit.
+constexpr std::size_t kMaxRounds = 64;
+constexpr std::size_t kMaxConstraintsPerSeed = 8;
+
+std::uint64_t constraint_key(const Constraint& constraint) noexcept
 {
-    switch (state) {
-    case CellState::Hidden:
-        return "Hidden";
-    case CellState::Revealed:
-        return "Revealed";
-    case CellState::Flagged:
-        return "Flagged";
+    std::uint64_t key = 1469598103934665603ULL ^ static_cast<std::uint64_t>(constraint.mines);
+    for (const std::size_t cell : constraint) {
+        key = (key ^ cell) * 1099511628211ULL;
     }
-    return "Unknown";
-}
+    return key;
 }
 
-std::optional<std::vector<Position>> AutoMarker::detect_certain_mines(
-    const MinesweeperBoard& board,
-    std::vector<Position> selection_cells
-) const
+// Cells of lhs that are not in rhs.
+Constraint difference(const Constraint& lhs, const Constraint& rhs) noexcept
 {
-    LOG_DEBUG(
-        "AutoMarker",
-        "Detecting certain mines within selection of " << selection_cells.size() << " cells"
-    );
+    Constraint result;
+    std::size_t j = 0;
+    for (const std::size_t cell : lhs) {
+        while (j < rhs.size && rhs.cells[j] < cell) {
+            ++j;
+        }
+        if (j == rhs.size || rhs.cells[j] != cell) {
+            result.cells[result.size++] = cell;
+        }
+    }
+    return result;
+}
 
-    std::unordered_set<std::size_t> unique_indices;
-    std::vector<Position> result;
+class Solver {
+public:
+    explicit Solver(const MinesweeperBoard& board)
+        : board_(board)
+        , packed_(board.packed_cells())
+        , knowledge_(packed_.size(), Knowledge::Unknown)
+        , watchers_(packed_.size())
+    {}
 
-    const auto rows = board.rows();
-    const auto columns = board.columns();
+    void add_number(std::size_t cell_index)
+    {
+        const PackedCell cell = packed_[cell_index];
+        if (cell.state() != CellState::Revealed || cell.adjacent_mines() <= 0) {
+            return;
+        }
+        Constraint constraint;
+        constraint.mines = cell.adjacent_mines();
+        board_.for_each_neighbor(cell_index, [&](std::size_t neighbor_index) {
+            const CellState state = packed_[neighbor_index].state();
+            if (state == CellState::Hidden) {
+                constraint.cells[constraint.size++] = neighbor_index;
+            } else if (state == CellState::Flagged) {
+                --constraint.mines;
+            }
+        });
+        if (constraint.size > 0) {
+            add(constraint);
+        }
+    }
 
-    for (const auto& position : selection_cells) {
-        if (position.row >= rows || position.column >= columns) {
-            LOG_DEBUG(
-                "AutoMarker",
-                "Skipping out-of-bounds cell (" << position.row << ',' << position.column << ")"
-            );
-            continue;
+    void solve()
+    {
+        const std::size_t constraint_limit = constraints_.size() * kMaxConstraintsPerSeed;
+        for (std::size_t round = 0; round < kMaxRounds; ++round) {
+            bool progress = settle_trivial();
+            progress = combine_pairs(constraint_limit) || progress;
+            if (!progress) {
+                break;
+            }
         }
+    }
 
-        const Cell& cell = board.cell_at(position);
-        if (cell.state != CellState::Revealed || cell.adjacent_mines <= 0) {
-            LOG_DEBUG(
-                "AutoMarker",
-                "Skipping cell (" << position.row << ',' << position.column
-                                   << ") state=" << cell_state_name(cell.state)
-                                   << " adjacent=" << cell.adjacent_mines
-            );
-            continue;
+    Deductions deductions() const
+    {
+        Deductions result;
+        const std::size_t columns = board_.columns();
+        for (const std::size_t cell : touched_) {
+            const Position position{cell / columns, cell % columns};
+            if (knowledge_[cell] == Knowledge::Mine) {
+                result.mines.push_back(position);
+            } else if (knowledge_[cell] == Knowledge::Safe) {
+                result.safe_cells.push_back(position);
+            }
         }
+        return result;
+    }
 
-        const auto neighbors = board.neighbors(position);
-        std::vector<Position> hidden_neighbors;
-        std::size_t flagged_neighbors = 0;
+private:
+    const MinesweeperBoard& board_;
+    const std::vector<PackedCell>& packed_;
+    std::vector<Knowledge> knowledge_;
+    std::vector<Constraint> constraints_;
+    std::vector<bool> retired_;
+    std::unordered_set<std::uint64_t> seen_;
+    // Constraint ids mentioning each cell, used to find overlapping pairs.
+    std::vector<std::vector<std::size_t>> watchers_;
+    std::vector<std::size_t> touched_;
 
-        for (const auto& neighbor : neighbors) {
-            if (neighbor.state == CellState::Hidden) {
-                hidden_neighbors.push_back(neighbor.position);
-            } else if (neighbor.state == CellState::Flagged) {
-                ++flagged_neighbors;
+    void add(const Constraint& constraint)
+    {
+        if (!seen_.insert(constraint_key(constraint)).second) {
+            return;
+        }
+        const std::size_t id = constraints_.size();
+        constraints_.push_back(constraint);
+        retired_.push_back(false);
+        for (const std::size_t cell : constraint) {
+            if (watchers_[cell].empty()) {
+                touched_.push_back(cell);
             }
+            watchers_[cell].push_back(id);
         }
+    }
 
-        if (hidden_neighbors.empty()) {
-            LOG_DEBUG(
-                "AutoMarker",
-                "Cell (" << position.row << ',' << position.column << ") has no hidden neighbors"
-            );
-            continue;
+    bool learn(std::size_t cell, Knowledge value)
+    {
+        if (knowledge_[cell] != Knowledge::Unknown) {
+            return false;
         }
+        knowledge_[cell] = value;
+        return true;
+    }
 
-        const auto remaining_mines = cell.adjacent_mines - static_cast<int>(flagged_neighbors);
-        if (remaining_mines <= 0) {
-            LOG_DEBUG(
-                "AutoMarker",
-                "All mines already flagged around cell (" << position.row << ',' << position.column << ")"
-            );
-            continue;
+    // Drops settled cells from a constraint, adjusting its mine count.
+    void substitute(Constraint& constraint) const
+    {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < constraint.size; ++i) {
+            const std::size_t cell = constraint.cells[i];
+            if (knowledge_[cell] == Knowledge::Mine) {
+                --constraint.mines;
+            } else if (knowledge_[cell] == Knowledge::Unknown) {
+                constraint.cells[kept++] = cell;
+            }
         }
+        constraint.size = kept;
+    }
 
-        if (remaining_mines == static_cast<int>(hidden_neighbors.size())) {
-            for (const auto& hidden : hidden_neighbors) {
-                const auto index = hidden.row * columns + hidden.column;
-                if (unique_indices.insert(index).second) {
-                    result.push_back(hidden);
+    bool settle_trivial()
+    {
+        bool progress = false;
+        for (std::size_t id = 0; id < constraints_.size(); ++id) {
+            if (retired_[id]) {
+                continue;
+            }
+            Constraint& constraint = constraints_[id];
+            substitute(constraint);
+            if (constraint.size == 0) {
+                retired_[id] = true;
+                continue;
+            }
+            const bool all_safe = constraint.mines == 0;
+            const bool all_mines = constraint.mines == static_cast<int>(constraint.size);
+            if (!all_safe && !all_mines) {
+                continue;
+            }
+            for (const std::size_t cell : constraint) {
+                progress = learn(cell, all_mines ? Knowledge::Mine : Knowledge::Safe) || progress;
+            }
+            retired_[id] = true;
+        }
+        return progress;
+    }
+
+    bool combine_pairs(std::size_t constraint_limit)
+    {
+        bool progress = false;
+        const std::size_t existing = constraints_.size();
+        std::vector<std::size_t> partners;
+        for (std::size_t a = 0; a < existing; ++a) {
+            if (retired_[a]) {
+                continue;
+            }
+            partners.clear();
+            for (const std::size_t cell : constraints_[a]) {
+                for (const std::size_t b : watchers_[cell]) {
+                    if (b != a && b < existing && !retired_[b]) {
+                        partners.push_back(b);
+                    }
                 }
             }
+            std::sort(partners.begin(), partners.end());
+            partners.erase(std::unique(partners.begin(), partners.end()), partners.end());
+
+            for (const std::size_t b : partners) {
+                // Copies: add() may reallocate constraints_.
+                Constraint lhs = constraints_[a];
+                Constraint rhs = constraints_[b];
+                substitute(lhs);
+                substitute(rhs);
+                const Constraint only_rhs = difference(rhs, lhs);
+                const Constraint only_lhs = difference(lhs, rhs);
+                const int extra_mines = rhs.mines - lhs.mines;
+
+                if (only_lhs.size == 0 && only_rhs.size > 0 && constraints_.size() < constraint_limit) {
+                    Constraint derived = only_rhs;
+                    derived.mines = extra_mines;
+                    add(derived);
+                    progress = progress || constraints_.size() > existing;
+                }
+                if (only_rhs.size > 0 && extra_mines == static_cast<int>(only_rhs.size)) {
+                    for (const std::size_t cell : only_rhs) {
+                        progress = learn(cell, Knowledge::Mine) || progress;
+                    }
+                    for (const std::size_t cell : only_lhs) {
+                        progress = learn(cell, Knowledge::Safe) || progress;
+                    }
+                }
+            }
+        }
+        return progress;
+    }
+};
+}  // namespace
+
+Deductions AutoMarker::deduce(const MinesweeperBoard& board, const std::vector<Position>& selection_cells) const
+{
+    LOG_DEBUG(
+        "AutoMarker",
+        "Solving selection of " << selection_cells.size() << " cells"
+    );
+
+    Solver solver(board);
+    const auto rows = board.rows();
+    const auto columns = board.columns();
+    for (const auto& position : selection_cells) {
+        if (position.row >= rows || position.column >= columns) {
             LOG_DEBUG(
                 "AutoMarker",
-                "Marked " << hidden_neighbors.size() << " certain mine(s) around (" << position.row << ','
-                           << position.column << ")"
+                "Skipping out-of-bounds cell (" << position.row << ',' << position.column << ")"
             );
+            continue;
         }
+        solver.add_number(position.row * columns + position.column);
     }
+    solver.solve();
+
+    Deductions result = solver.deductions();
+    LOG_DEBUG(
+        "AutoMarker",
+        "Deduced " << result.mines.size() << " mine(s) and " << result.safe_cells.size() << " safe cell(s)"
+    );
+    return result;
+}
 
+std::optional<std::vector<Position>> AutoMarker::detect_certain_mines(
+    const MinesweeperBoard& board,
+    std::vector<Position> selection_cells
+) const
+{
+    auto result = deduce(board, selection_cells).mines;
     if (result.empty()) {
         LOG_DEBUG("AutoMarker", "No certain mines found in selection");
         return std::nullopt;
@@ -0,0 +1,32 @@
+#include "Base64.hpp"
+
+#include <cstdint>
+
+namespace clearbomb {
+
+namespace {
+constexpr std::string_view kBase64Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+}
+
+std::string base64_encode(std::string_view bytes)
+{
+    std::string out;
+    out.reserve((bytes.size() + 2) / 3 * 4);
+    for (std::size_t i = 0; i < bytes.size(); i += 3) {
+        const std::size_t remaining = bytes.size() - i;
+        std::uint32_t chunk = static_cast<std::uint32_t>(static_cast<std::uint8_t>(bytes[i])) << 16;
+        if (remaining > 1) {
+            chunk |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(bytes[i + 1])) << 8;
+        }
+        if (remaining > 2) {
+            chunk |= static_cast<std::uint8_t>(bytes[i + 2]);
+        }
+        out.push_back(kBase64Alphabet[(chunk >> 18) & 0x3fU]);
+        out.push_back(kBase64Alphabet[(chunk >> 12) & 0x3fU]);
+        out.push_back(remaining > 1 ? kBase64Alphabet[(chunk >> 6) & 0x3fU] : '=');
+        out.push_back(remaining > 2 ? kBase64Alphabet[chunk & 0x3fU] : '=');
+    }
+    return out;
+}
+
+}  // namespace clearbomb
@@ -0,0 +1,156 @@
+#include "BinaryProtocol.hpp"
+
+namespace clearbomb {
+
+namespace {
+void append_u8(std::string& out, std::size_t value)
+{
+    out.push_back(static_cast<char>(value & 0xffU));
+}
+
+void append_u16(std::string& out, std::size_t value)
+{
+    append_u8(out, value);
+    append_u8(out, value >> 8);
+}
+
+void append_u64(std::string& out, std::uint64_t value)
+{
+    for (int shift = 0; shift < 64; shift += 8) {
+        append_u8(out, static_cast<std::size_t>(value >> shift));
+    }
+}
+
+void append_header(std::string& out, BinaryOp op, std::uint64_t version, GameStatus status, std::size_t flags)
+{
+    append_u8(out, static_cast<std::size_t>(op));
+    append_u64(out, version);
+    append_u8(out, static_cast<std::size_t>(status));
+    append_u16(out, flags);
+}
+}  // namespace
+
+std::optional<BinaryRequest> decode_binary_request(std::string_view payload, std::string& error)
+{
+    BinaryRequest request;
+    std::size_t offset = 0;
+    const auto read = [&](std::size_t count, std::size_t* fields) {
+        if (payload.size() - offset < count) {
+            return false;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            fields[i] = static_cast<std::uint8_t>(payload[offset + i]);
+        }
+        offset += count;
+        return true;
+    };
+
+    while (offset < payload.size()) {
+        const auto op = static_cast<BinaryOp>(static_cast<std::uint8_t>(payload[offset]));
+        const std::size_t op_offset = offset++;
+        Move move{MoveType::Reveal};
+        bool complete = true;
+        switch (op) {
+        case BinaryOp::Reveal:
+        case BinaryOp::Flag:
+        case BinaryOp::Chord: {
+            std::size_t coordinates[2] = {};
+            complete = read(2, coordinates);
+            move.type = op == BinaryOp::Reveal ? MoveType::Reveal
+                        : op == BinaryOp::Flag ? MoveType::Flag
+                                               : MoveType::Chord;
+            move.position = Position{coordinates[0], coordinates[1]};
+            break;
+        }
+        case BinaryOp::AutoMark: {
+            std::size_t bounds[4] = {};
+            complete = read(4, bounds);
+            move.type = MoveType::AutoMark;
+            move.selection = SelectionRect{bounds[0], bounds[1], bounds[2], bounds[3]};
+            break;
+        }
+        case BinaryOp::Snapshot:
+            request.wants_snapshot = true;
+            continue;
+        default:
+            error = "unknown operation at byte " + std::to_string(op_offset);
+            return std::nullopt;
+        }
+        if (!complete) {
+            error = "truncated operation at byte " + std::to_string(op_offset);
+            return std::nullopt;
+        }
+        request.moves.push_back(move);
+    }
+    return request;
+}
+
+std::uint8_t binary_cell(PackedCell cell) noexcept
+{
+    if (cell.state() == CellState::Revealed) {
+        return cell.raw();
+    }
+    PackedCell visible;
+    visible.set_state(cell.state());
+    return visible.raw();
+}
+
+std::uint8_t binary_cell(const Cell& cell) noexcept
+{
+    PackedCell packed;
+    packed.set_state(cell.state);
+    packed.set_mine(cell.is_mine);
+    packed.set_exploded(cell.exploded);
+    packed.set_adjacent_mines(cell.is_mine ? 0 : cell.adjacent_mines);
+    return binary_cell(packed);
+}
+
+void append_run_length_cells(std::string& out, const std::vector<Cell>& cells)
+{
+    std::size_t i = 0;
+    while (i < cells.size()) {
+        const std::uint8_t value = binary_cell(cells[i]);
+        std::size_t run = 1;
+        while (run < 255 && i + run < cells.size() && binary_cell(cells[i + run]) == value) {
+            ++run;
+        }
+        append_u8(out, run);
+        append_u8(out, value);
+        i += run;
+    }
+}
+
+void append_binary_delta(std::string& out, const BatchResult& result, std::uint64_t version)
+{
+    out.reserve(out.size() + 16 + result.updated_cells.size() * 3);
+    append_header(out, BinaryOp::Delta, version, result.status, result.flags_remaining);
+    append_u16(out, result.applied);
+    append_u16(out, result.updated_cells.size());
+    for (const Cell& cell : result.updated_cells) {
+        append_u8(out, cell.position.row);
+        append_u8(out, cell.position.column);
+        append_u8(out, binary_cell(cell));
+    }
+}
+
+void append_binary_snapshot(std::string& out, const GameEngine& engine)
+{
+    const MinesweeperBoard& board = engine.board();
+    const auto& packed = board.packed_cells();
+    out.reserve(out.size() + 16 + packed.size());
+    append_header(out, BinaryOp::SnapshotReply, engine.version(), engine.status(), engine.flags_remaining());
+    append_u8(out, board.rows());
+    append_u8(out, board.columns());
+    append_u16(out, board.mine_count());
+    for (const PackedCell cell : packed) {
+        out.push_back(static_cast<char>(binary_cell(cell)));
+    }
+}
+
+void append_binary_error(std::string& out, std::string_view message)
+{
+    append_u8(out, static_cast<std::size_t>(BinaryOp::Error));
+    out.append(message);
+}
+
+}  // namespace clearbomb
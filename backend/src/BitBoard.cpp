@@ -0,0 +1,342 @@
+#include "BitBoard.hpp"
+#include "AdjacencyKernel.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace clearbomb {
+
+#if defined(CLEARBOMB_HAVE_AVX2_KERNEL)
+void bitboard_adjacency_avx2(
+    const std::uint64_t* mines,
+    std::uint64_t* const (&counts)[4],
+    std::size_t rows,
+    std::size_t words_per_row,
+    std::size_t stride,
+    std::size_t& first_word
+);
+#endif
+
+namespace {
+constexpr std::size_t kBitsPerWord = 64;
+
+constexpr int kNeighborOffsets[8][2] = {
+    {-1, -1}, {-1, 0}, {-1, 1},
+    {0, -1},           {0, 1},
+    {1, -1},  {1, 0},  {1, 1}
+};
+
+struct ScalarLane {
+    static constexpr std::size_t kWords = 1;
+    std::uint64_t value;
+
+    static ScalarLane load(const std::uint64_t* source) { return {*source}; }
+    static void store(std::uint64_t* target, ScalarLane lane) { *target = lane.value; }
+    static ScalarLane west(ScalarLane center, ScalarLane previous)
+    {
+        return {(center.value << 1) | (previous.value >> 63)};
+    }
+    static ScalarLane east(ScalarLane center, ScalarLane next)
+    {
+        return {(center.value >> 1) | (next.value << 63)};
+    }
+    static ScalarLane and_not(ScalarLane mask, ScalarLane value) { return {~mask.value & value.value}; }
+    friend ScalarLane operator^(ScalarLane a, ScalarLane b) { return {a.value ^ b.value}; }
+    friend ScalarLane operator&(ScalarLane a, ScalarLane b) { return {a.value & b.value}; }
+    friend ScalarLane operator|(ScalarLane a, ScalarLane b) { return {a.value | b.value}; }
+};
+
+#if defined(__SSE2__)
+struct Sse2Lane {
+    static constexpr std::size_t kWords = 2;
+    __m128i value;
+
+    static Sse2Lane load(const std::uint64_t* source)
+    {
+        return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(source))};
+    }
+    static void store(std::uint64_t* target, Sse2Lane lane)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), lane.value);
+    }
+    static Sse2Lane west(Sse2Lane center, Sse2Lane previous)
+    {
+        return {_mm_or_si128(_mm_slli_epi64(center.value, 1), _mm_srli_epi64(previous.value, 63))};
+    }
+    static Sse2Lane east(Sse2Lane center, Sse2Lane next)
+    {
+        return {_mm_or_si128(_mm_srli_epi64(center.value, 1), _mm_slli_epi64(next.value, 63))};
+    }
+    static Sse2Lane and_not(Sse2Lane mask, Sse2Lane value) { return {_mm_andnot_si128(mask.value, value.value)}; }
+    friend Sse2Lane operator^(Sse2Lane a, Sse2Lane b) { return {_mm_xor_si128(a.value, b.value)}; }
+    friend Sse2Lane operator&(Sse2Lane a, Sse2Lane b) { return {_mm_and_si128(a.value, b.value)}; }
+    friend Sse2Lane operator|(Sse2Lane a, Sse2Lane b) { return {_mm_or_si128(a.value, b.value)}; }
+};
+#endif
+
+bool cpu_has_avx2() noexcept
+{
+#if defined(CLEARBOMB_HAVE_AVX2_KERNEL)
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+const char* kernel_name(AdjacencyKernel kernel)
+{
+    switch (kernel) {
+    case AdjacencyKernel::Auto:
+        return "auto";
+    case AdjacencyKernel::Scalar:
+        return "scalar";
+    case AdjacencyKernel::Sse2:
+        return "sse2";
+    case AdjacencyKernel::Avx2:
+        return "avx2";
+    }
+    return "unknown";
+}
+}  // namespace
+
+BitBoard::BitBoard(std::size_t rows, std::size_t columns, std::size_t mine_count)
+    : BitBoard(rows, columns, mine_count, std::random_device{}())
+{}
+
+BitBoard::BitBoard(std::size_t rows, std::size_t columns, std::size_t mine_count, std::uint64_t seed)
+    : rows_(rows)
+    , columns_(columns)
+    , mine_count_(mine_count)
+    , words_per_row_((columns + kBitsPerWord - 1) / kBitsPerWord)
+    , stride_(words_per_row_ + 2)
+    , rng_(seed)
+{
+    if (rows == 0 || columns == 0) {
+        LOG_ERROR("BitBoard", "Board creation failed - non-positive dimensions " << rows << 'x' << columns);
+        throw std::invalid_argument("Board dimensions must be positive.");
+    }
+    if (mine_count == 0 || mine_count >= rows * columns) {
+        LOG_ERROR("BitBoard", "Board creation failed - invalid mine count " << mine_count << " for " << rows * columns);
+        throw std::invalid_argument("Mine count must be between 1 and total cell count - 1.");
+    }
+
+    const std::size_t plane_words = (rows_ + 2) * stride_;
+    mines_.assign(plane_words, 0);
+    revealed_.assign(plane_words, 0);
+    flagged_.assign(plane_words, 0);
+    for (auto& plane : counts_) {
+        plane.assign(plane_words, 0);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    place_mines();
+    recompute_adjacency();
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO(
+        "BitBoard",
+        "Board populated " << rows_ << 'x' << columns_ << " with " << mine_count_ << " mines in " << elapsed << " ms"
+    );
+}
+
+void BitBoard::place_mines()
+{
+    // Rejection sampling stays O(mines) while at most half the board is
+    // mined; denser boards start full and carve out the safe cells instead.
+    const std::size_t total = rows_ * columns_;
+    const bool carve_safe_cells = mine_count_ > total / 2;
+    const std::size_t picks = carve_safe_cells ? total - mine_count_ : mine_count_;
+
+    if (carve_safe_cells) {
+        for (std::size_t row = 0; row < rows_; ++row) {
+            for (std::size_t column = 0; column < columns_; ++column) {
+                mines_[word_index(Position{row, column})] |= bit_mask(Position{row, column});
+            }
+        }
+    }
+
+    std::uniform_int_distribution<std::size_t> pick(0, total - 1);
+    std::size_t placed = 0;
+    while (placed < picks) {
+        const std::size_t cell = pick(rng_);
+        const Position position{cell / columns_, cell % columns_};
+        std::uint64_t& word = mines_[word_index(position)];
+        const std::uint64_t mask = bit_mask(position);
+        if (((word & mask) != 0) == carve_safe_cells) {
+            word ^= mask;
+            ++placed;
+        }
+    }
+}
+
+void BitBoard::recompute_adjacency(AdjacencyKernel kernel)
+{
+    if (kernel == AdjacencyKernel::Auto) {
+        kernel = cpu_has_avx2() ? AdjacencyKernel::Avx2
+                 : kernel_supported(AdjacencyKernel::Sse2) ? AdjacencyKernel::Sse2
+                                                           : AdjacencyKernel::Scalar;
+    }
+    if (!kernel_supported(kernel)) {
+        throw std::invalid_argument(std::string("Adjacency kernel not supported on this CPU: ") + kernel_name(kernel));
+    }
+
+    std::uint64_t* const counts[4] = {counts_[0].data(), counts_[1].data(), counts_[2].data(), counts_[3].data()};
+    std::size_t first_word = 1;
+#if defined(CLEARBOMB_HAVE_AVX2_KERNEL)
+    if (kernel == AdjacencyKernel::Avx2) {
+        bitboard_adjacency_avx2(mines_.data(), counts, rows_, words_per_row_, stride_, first_word);
+    }
+#endif
+#if defined(__SSE2__)
+    if (kernel != AdjacencyKernel::Scalar) {
+        adjacency_rows<Sse2Lane>(mines_.data(), counts, rows_, words_per_row_, stride_, first_word);
+    }
+#endif
+    adjacency_rows<ScalarLane>(mines_.data(), counts, rows_, words_per_row_, stride_, first_word);
+}
+
+bool BitBoard::kernel_supported(AdjacencyKernel kernel) noexcept
+{
+    switch (kernel) {
+    case AdjacencyKernel::Auto:
+    case AdjacencyKernel::Scalar:
+        return true;
+    case AdjacencyKernel::Sse2:
+#if defined(__SSE2__)
+        return true;
+#else
+        return false;
+#endif
+    case AdjacencyKernel::Avx2:
+        return cpu_has_avx2();
+    }
+    return false;
+}
+
+BitBoardRevealOutcome BitBoard::reveal(Position position)
+{
+    validate(position);
+
+    BitBoardRevealOutcome outcome{0, false};
+    const std::size_t start_word = word_index(position);
+    const std::uint64_t start_mask = bit_mask(position);
+    if (((revealed_[start_word] | flagged_[start_word]) & start_mask) != 0) {
+        return outcome;
+    }
+
+    revealed_[start_word] |= start_mask;
+    if ((mines_[start_word] & start_mask) != 0) {
+        outcome.hit_mine = true;
+        outcome.revealed_cells = 1;
+        return outcome;
+    }
+
+    std::vector<Position> pending{position};
+    while (!pending.empty()) {
+        const Position current = pending.back();
+        pending.pop_back();
+        ++outcome.revealed_cells;
+        if (adjacent_mines(current) != 0) {
+            continue;
+        }
+
+        for (const auto& offset : kNeighborOffsets) {
+            const auto row = static_cast<std::size_t>(static_cast<long>(current.row) + offset[0]);
+            const auto column = static_cast<std::size_t>(static_cast<long>(current.column) + offset[1]);
+            if (row >= rows_ || column >= columns_) {
+                continue;
+            }
+            const Position neighbor{row, column};
+            const std::size_t word = word_index(neighbor);
+            const std::uint64_t mask = bit_mask(neighbor);
+            if (((revealed_[word] | flagged_[word] | mines_[word]) & mask) != 0) {
+                continue;
+            }
+            revealed_[word] |= mask;
+            pending.push_back(neighbor);
+        }
+    }
+
+    revealed_safe_cells_ += outcome.revealed_cells;
+    return outcome;
+}
+
+ToggleOutcome BitBoard::toggle_flag(Position position)
+{
+    validate(position);
+
+    const std::size_t word = word_index(position);
+    const std::uint64_t mask = bit_mask(position);
+    if ((revealed_[word] & mask) != 0) {
+        return ToggleOutcome{cell_at(position), false};
+    }
+    flagged_[word] ^= mask;
+    return ToggleOutcome{cell_at(position), (flagged_[word] & mask) != 0};
+}
+
+Cell BitBoard::cell_at(Position position) const
+{
+    validate(position);
+
+    const std::size_t word = word_index(position);
+    const std::uint64_t mask = bit_mask(position);
+    const bool mine = (mines_[word] & mask) != 0;
+    const bool revealed = (revealed_[word] & mask) != 0;
+    const CellState state = revealed ? CellState::Revealed
+                            : (flagged_[word] & mask) != 0 ? CellState::Flagged
+                                                           : CellState::Hidden;
+    return Cell{position, mine, adjacent_mines(position), state, revealed && mine};
+}
+
+bool BitBoard::is_mine(Position position) const
+{
+    validate(position);
+    return (mines_[word_index(position)] & bit_mask(position)) != 0;
+}
+
+int BitBoard::adjacent_mines(Position position) const
+{
+    validate(position);
+    const std::size_t word = word_index(position);
+    const std::size_t shift = position.column % kBitsPerWord;
+    int count = 0;
+    for (std::size_t plane = 0; plane < counts_.size(); ++plane) {
+        count |= static_cast<int>((counts_[plane][word] >> shift) & 1U) << plane;
+    }
+    return count;
+}
+
+std::size_t BitBoard::rows() const noexcept { return rows_; }
+std::size_t BitBoard::columns() const noexcept { return columns_; }
+std::size_t BitBoard::mine_count() const noexcept { return mine_count_; }
+std::size_t BitBoard::revealed_safe_cells() const noexcept { return revealed_safe_cells_; }
+
+bool BitBoard::all_safe_cells_revealed() const noexcept
+{
+    return revealed_safe_cells_ == rows_ * columns_ - mine_count_;
+}
+
+void BitBoard::validate(Position position) const
+{
+    if (position.row >= rows_ || position.column >= columns_) {
+        throw std::out_of_range("Cell request outside of board bounds.");
+    }
+}
+
+std::size_t BitBoard::word_index(Position position) const noexcept
+{
+    return (position.row + 1) * stride_ + 1 + position.column / kBitsPerWord;
+}
+
+std::uint64_t BitBoard::bit_mask(Position position) noexcept
+{
+    return std::uint64_t{1} << (position.column % kBitsPerWord);
+}
+
+}  // namespace clearbomb
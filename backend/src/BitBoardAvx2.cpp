@@ -0,0 +1,52 @@
+// Compiled with -mavx2; only called after a runtime CPU check.
+
+#include "AdjacencyKernel.hpp"
+
+#include <immintrin.h>
+
+namespace clearbomb {
+
+namespace {
+struct Avx2Lane {
+    static constexpr std::size_t kWords = 4;
+    __m256i value;
+
+    static Avx2Lane load(const std::uint64_t* source)
+    {
+        return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source))};
+    }
+    static void store(std::uint64_t* target, Avx2Lane lane)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target), lane.value);
+    }
+    static Avx2Lane west(Avx2Lane center, Avx2Lane previous)
+    {
+        return {_mm256_or_si256(_mm256_slli_epi64(center.value, 1), _mm256_srli_epi64(previous.value, 63))};
+    }
+    static Avx2Lane east(Avx2Lane center, Avx2Lane next)
+    {
+        return {_mm256_or_si256(_mm256_srli_epi64(center.value, 1), _mm256_slli_epi64(next.value, 63))};
+    }
+    static Avx2Lane and_not(Avx2Lane mask, Avx2Lane value)
+    {
+        return {_mm256_andnot_si256(mask.value, value.value)};
+    }
+    friend Avx2Lane operator^(Avx2Lane a, Avx2Lane b) { return {_mm256_xor_si256(a.value, b.value)}; }
+    friend Avx2Lane operator&(Avx2Lane a, Avx2Lane b) { return {_mm256_and_si256(a.value, b.value)}; }
+    friend Avx2Lane operator|(Avx2Lane a, Avx2Lane b) { return {_mm256_or_si256(a.value, b.value)}; }
+};
+}  // namespace
+
+void bitboard_adjacency_avx2(
+    const std::uint64_t* mines,
+    std::uint64_t* const (&counts)[4],
+    std::size_t rows,
+    std::size_t words_per_row,
+    std::size_t stride,
+    std::size_t& first_word
+)
+{
+    adjacency_rows<Avx2Lane>(mines, counts, rows, words_per_row, stride, first_word);
+}
+
+}  // namespace clearbomb
@@ -0,0 +1,14 @@
+#include "BoardRandom.hpp"
+
+#include <random>
+
+namespace clearbomb {
+
+std::uint64_t random_board_seed()
+{
+    std::random_device device;
+    const std::uint64_t high = device();
+    return ((high << 32) | device()) & kMaxBoardSeed;
+}
+
+}  // namespace clearbomb
@@ -0,0 +1,72 @@
+#include "Compression.hpp"
+#include "HttpRequestParser.hpp"
+
+#include <zlib.h>
+
+#include <limits>
+#include <stdexcept>
+
+namespace clearbomb {
+
+namespace {
+constexpr int kWindowBits = 15;
+constexpr int kGzipWindowBits = kWindowBits + 16;
+constexpr int kMemoryLevel = 8;
+}  // namespace
+
+ContentEncoding negotiate_content_encoding(std::string_view accept_encoding) noexcept
+{
+    if (accepts_list_token(accept_encoding, "gzip")) {
+        return ContentEncoding::Gzip;
+    }
+    if (accepts_list_token(accept_encoding, "deflate")) {
+        return ContentEncoding::Deflate;
+    }
+    return ContentEncoding::Identity;
+}
+
+std::string_view content_encoding_name(ContentEncoding encoding) noexcept
+{
+    switch (encoding) {
+    case ContentEncoding::Gzip:
+        return "gzip";
+    case ContentEncoding::Deflate:
+        return "deflate";
+    case ContentEncoding::Identity:
+        break;
+    }
+    return {};
+}
+
+std::string compress_body(std::string_view body, ContentEncoding encoding, int level)
+{
+    if (encoding == ContentEncoding::Identity) {
+        return std::string(body);
+    }
+    if (body.size() > std::numeric_limits<uInt>::max()) {
+        throw std::runtime_error("Body too large to compress");
+    }
+
+    z_stream stream {};
+    const int window_bits = encoding == ContentEncoding::Gzip ? kGzipWindowBits : kWindowBits;
+    if (deflateInit2(&stream, level, Z_DEFLATED, window_bits, kMemoryLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("Unable to initialise zlib");
+    }
+
+    // deflateBound includes the wrapper, so a single deflate call always
+    // finishes.
+    std::string out(deflateBound(&stream, static_cast<uLong>(body.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data()));
+    stream.avail_in = static_cast<uInt>(body.size());
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    const int result = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        throw std::runtime_error("zlib could not finish the stream");
+    }
+    return out;
+}
+
+}  // namespace clearbomb
@@ -0,0 +1,75 @@
+#include "Frontier.hpp"
+
+namespace clearbomb {
+
+void Frontier::rebuild(const MinesweeperBoard& board)
+{
+    const auto& packed = board.packed_cells();
+    hidden_neighbors_.assign(packed.size(), 0);
+    flagged_neighbors_.assign(packed.size(), 0);
+    members_.clear();
+    slots_.assign(packed.size(), kAbsent);
+
+    for (std::size_t idx = 0; idx < packed.size(); ++idx) {
+        const CellState state = packed[idx].state();
+        if (state == CellState::Revealed) {
+            continue;
+        }
+        auto& counts = state == CellState::Hidden ? hidden_neighbors_ : flagged_neighbors_;
+        board.for_each_neighbor(idx, [&](std::size_t neighbor) { ++counts[neighbor]; });
+    }
+    for (std::size_t idx = 0; idx < packed.size(); ++idx) {
+        refresh(board, idx);
+    }
+}
+
+void Frontier::on_revealed(const MinesweeperBoard& board, std::size_t cell_index)
+{
+    board.for_each_neighbor(cell_index, [&](std::size_t neighbor) {
+        --hidden_neighbors_[neighbor];
+        refresh(board, neighbor);
+    });
+    refresh(board, cell_index);
+}
+
+void Frontier::on_flag_changed(const MinesweeperBoard& board, std::size_t cell_index, bool flagged)
+{
+    board.for_each_neighbor(cell_index, [&](std::size_t neighbor) {
+        if (flagged) {
+            --hidden_neighbors_[neighbor];
+            ++flagged_neighbors_[neighbor];
+        } else {
+            ++hidden_neighbors_[neighbor];
+            --flagged_neighbors_[neighbor];
+        }
+        refresh(board, neighbor);
+    });
+}
+
+int Frontier::remaining_mines(const MinesweeperBoard& board, std::size_t cell_index) const noexcept
+{
+    return board.packed_cells()[cell_index].adjacent_mines() - flagged_neighbors_[cell_index];
+}
+
+void Frontier::refresh(const MinesweeperBoard& board, std::size_t cell_index)
+{
+    const PackedCell cell = board.packed_cells()[cell_index];
+    const bool member = cell.state() == CellState::Revealed && !cell.is_mine() && cell.adjacent_mines() > 0 &&
+                        hidden_neighbors_[cell_index] > 0;
+    if (member == contains(cell_index)) {
+        return;
+    }
+    if (member) {
+        slots_[cell_index] = members_.size();
+        members_.push_back(cell_index);
+        return;
+    }
+    // Swap-remove keeps erasure O(1).
+    const std::size_t slot = slots_[cell_index];
+    members_[slot] = members_.back();
+    slots_[members_[slot]] = slot;
+    members_.pop_back();
+    slots_[cell_index] = kAbsent;
+}
+
+}  // namespace clearbomb
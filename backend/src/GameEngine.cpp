@@ -9,6 +9,11 @@ namespace clearbomb {
 namespace {
 constexpr std::size_t kMinDimension = 2;
 constexpr std::size_t kMaxDimension = 50;
+// Versions start at a random point so that a version a client kept from an
+// evicted session or an earlier server run is not mistaken for one issued
+// by this engine. 32 bits leave room to count up without leaving the range
+// JSON clients read exactly.
+constexpr std::uint64_t kVersionStartMask = 0xffffffffULL;
 
 const char* status_to_string(GameStatus status)
 {
@@ -25,12 +30,9 @@ const char* status_to_string(GameStatus status)
 
 BoardConfig make_config_from_board(const MinesweeperBoard& board)
 {
-    return BoardConfig{board.rows(), board.columns(), board.mine_count()};
-}
-
-std::vector<Cell> copy_cells(const std::vector<Cell>& cells)
-{
-    return cells;
+    return BoardConfig{
+        board.rows(), board.columns(), board.mine_count(), std::nullopt, board.generator(), board.safe_start()
+    };
 }
 
 std::size_t max_allowed_mines(std::size_t rows, std::size_t columns)
@@ -62,15 +64,25 @@ void validate_config(const BoardConfig& config)
     if (max_mines == 0 || config.mines > max_mines) {
         throw std::invalid_argument("Mine count must be at most rows * columns - 2.");
     }
+
+    if (config.seed && *config.seed > kMaxBoardSeed) {
+        throw std::invalid_argument("Seed must be at most 9007199254740991.");
+    }
 }
 }
 
 GameEngine::GameEngine()
-    : board_(std::make_unique<MinesweeperBoard>(16, 16, 40))
+    : board_(std::make_unique<MinesweeperBoard>(
+          16, 16, 40, random_board_seed(), BoardGenerator::Mt19937, SafeStart::Cell
+      ))
     , current_config_(make_config_from_board(*board_))
+    , seed_(board_->seed())
     , flags_remaining_(board_->mine_count())
+    , version_(random_board_seed() & kVersionStartMask)
 {
     validate_config(current_config_);
+    frontier_.rebuild(*board_);
+    restart_journal();
     LOG_INFO(
         "GameEngine",
         "Initialized with default board " << current_config_.rows << 'x' << current_config_.columns << " ("
@@ -81,11 +93,15 @@ GameEngine::GameEngine()
 GameEngine::GameEngine(std::unique_ptr<MinesweeperBoard> board)
     : board_(std::move(board))
     , current_config_(make_config_from_board(*board_))
+    , seed_(board_->seed())
     , flags_remaining_(board_->mine_count())
+    , version_(random_board_seed() & kVersionStartMask)
 {
     if (!board_) {
         throw std::invalid_argument("GameEngine requires a valid board instance.");
     }
+    frontier_.rebuild(*board_);
+    restart_journal();
     LOG_INFO(
         "GameEngine",
         "Initialized with injected board " << current_config_.rows << 'x' << current_config_.columns << " ("
@@ -105,12 +121,30 @@ RevealResult GameEngine::reveal_cell(Position position)
         return RevealResult{{}, status_ == GameStatus::Defeat, status_ == GameStatus::Victory, flags_remaining_};
     }
 
-    if (!first_move_done_) {
-        ensure_first_move_safe(position);
-        first_move_done_ = true;
+    auto result = apply_reveal(position, board_->reveal(position));
+    record_changes(result.updated_cells);
+    return result;
+}
+
+RevealResult GameEngine::chord_cell(Position position)
+{
+    LOG_DEBUG("GameEngine", "Chord requested at (" << position.row << ',' << position.column << ")");
+
+    if (game_over_) {
+        LOG_WARNING(
+            "GameEngine",
+            "Chord ignored because game already finished with status " << status_to_string(status_)
+        );
+        return RevealResult{{}, status_ == GameStatus::Defeat, status_ == GameStatus::Victory, flags_remaining_};
     }
 
-    auto outcome = board_->reveal(position);
+    auto result = apply_reveal(position, board_->chord(position));
+    record_changes(result.updated_cells);
+    return result;
+}
+
+RevealResult GameEngine::apply_reveal(Position position, RevealOutcome outcome)
+{
     auto updated_cells = std::move(outcome.revealed_cells);
 
     if (outcome.hit_mine) {
@@ -125,6 +159,10 @@ RevealResult GameEngine::reveal_cell(Position position)
         return RevealResult{std::move(updated_cells), true, false, flags_remaining_};
     }
 
+    for (const Cell& cell : updated_cells) {
+        frontier_.on_revealed(*board_, cell.position.row * board_->columns() + cell.position.column);
+    }
+
     if (board_->all_safe_cells_revealed()) {
         status_ = GameStatus::Victory;
         game_over_ = true;
@@ -169,6 +207,12 @@ FlagResult GameEngine::toggle_flag(Position position)
     }
 
     auto outcome = board_->toggle_flag(position);
+    if (outcome.flag_added || (was_flagged && outcome.updated_cell.state == CellState::Hidden)) {
+        frontier_.on_flag_changed(
+            *board_, position.row * board_->columns() + position.column, outcome.flag_added
+        );
+        record_changes({outcome.updated_cell});
+    }
 
     if (outcome.flag_added) {
         if (flags_remaining_ > 0) {
@@ -212,29 +256,36 @@ std::optional<AutoMarkResult> GameEngine::auto_mark(SelectionRect selection)
     const auto col_begin = std::min(selection.col_begin, selection.col_end);
     const auto col_end = std::min<std::size_t>(std::max(selection.col_begin, selection.col_end), board_->columns() - 1);
 
+    // Only frontier numbers constrain anything, so the selection is read off
+    // the frontier instead of scanning the rectangle.
+    const std::size_t columns = board_->columns();
     std::vector<Position> selection_cells;
-    selection_cells.reserve((row_end - row_begin + 1) * (col_end - col_begin + 1));
-    for (std::size_t row = row_begin; row <= row_end; ++row) {
-        for (std::size_t col = col_begin; col <= col_end; ++col) {
-            selection_cells.push_back(Position{row, col});
+    for (const std::size_t idx : frontier_.cells()) {
+        const Position position{idx / columns, idx % columns};
+        if (position.row >= row_begin && position.row <= row_end && position.column >= col_begin &&
+            position.column <= col_end) {
+            selection_cells.push_back(position);
         }
     }
+    std::sort(selection_cells.begin(), selection_cells.end(), [](Position lhs, Position rhs) {
+        return lhs.row != rhs.row ? lhs.row < rhs.row : lhs.column < rhs.column;
+    });
 
     if (selection_cells.empty()) {
-        LOG_DEBUG("GameEngine", "Auto-mark selection contained no valid cells");
+        LOG_DEBUG("GameEngine", "Auto-mark selection contained no frontier cells");
         return std::nullopt;
     }
 
-    auto detected = auto_marker_.detect_certain_mines(*board_, std::move(selection_cells));
-    if (!detected || detected->empty()) {
-        LOG_DEBUG("GameEngine", "Auto-mark found no certain mines");
+    const auto deductions = auto_marker_.deduce(*board_, selection_cells);
+    if (deductions.mines.empty() && deductions.safe_cells.empty()) {
+        LOG_DEBUG("GameEngine", "Auto-mark found no certain cells");
         return std::nullopt;
     }
 
     std::vector<Cell> flagged_cells;
-    flagged_cells.reserve(detected->size());
+    flagged_cells.reserve(deductions.mines.size());
 
-    for (const auto& position : *detected) {
+    for (const auto& position : deductions.mines) {
         const Cell& cell = board_->cell_at(position);
         if (cell.state != CellState::Hidden) {
             LOG_DEBUG(
@@ -249,29 +300,127 @@ std::optional<AutoMarkResult> GameEngine::auto_mark(SelectionRect selection)
         }
         auto outcome = board_->toggle_flag(position);
         if (outcome.flag_added) {
+            frontier_.on_flag_changed(*board_, position.row * columns + position.column, true);
             --flags_remaining_;
             flagged_cells.push_back(outcome.updated_cell);
         }
     }
 
-    if (flagged_cells.empty()) {
+    std::vector<Cell> safe_cells;
+    safe_cells.reserve(deductions.safe_cells.size());
+    for (const auto& position : deductions.safe_cells) {
+        safe_cells.push_back(board_->cell_at(position));
+    }
+
+    if (flagged_cells.empty() && safe_cells.empty()) {
         LOG_DEBUG("GameEngine", "Auto-mark placed no new flags");
         return std::nullopt;
     }
 
-    if (board_->all_safe_cells_revealed()) {
-        status_ = GameStatus::Victory;
-        game_over_ = true;
-        reveal_all_mines(flagged_cells);
-        LOG_INFO("GameEngine", "Victory achieved via auto-mark - all safe cells cleared");
+    record_changes(flagged_cells);
+
+    LOG_INFO(
+        "GameEngine",
+        "Auto-mark placed " << flagged_cells.size() << " flag(s) and found " << safe_cells.size()
+                            << " safe cell(s) - flags remaining: " << flags_remaining_
+    );
+
+    return AutoMarkResult{std::move(flagged_cells), std::move(safe_cells), flags_remaining_};
+}
+
+BatchResult GameEngine::apply_batch(const std::vector<Move>& moves)
+{
+    const std::size_t rows = board_->rows();
+    const std::size_t columns = board_->columns();
+    for (const Move& move : moves) {
+        if (move.type != MoveType::AutoMark && (move.position.row >= rows || move.position.column >= columns)) {
+            throw std::out_of_range("Batch move outside of board bounds.");
+        }
     }
 
+    std::vector<bool> touched(rows * columns, false);
+    std::vector<std::size_t> touched_order;
+    const auto record = [&](const std::vector<Cell>& cells) {
+        for (const Cell& cell : cells) {
+            const std::size_t idx = cell.position.row * columns + cell.position.column;
+            if (!touched[idx]) {
+                touched[idx] = true;
+                touched_order.push_back(idx);
+            }
+        }
+    };
+
+    std::size_t applied = 0;
+    for (const Move& move : moves) {
+        if (game_over_) {
+            break;
+        }
+        switch (move.type) {
+        case MoveType::Reveal:
+            record(reveal_cell(move.position).updated_cells);
+            break;
+        case MoveType::Chord:
+            record(chord_cell(move.position).updated_cells);
+            break;
+        case MoveType::Flag:
+            record({toggle_flag(move.position).updated_cell});
+            break;
+        case MoveType::AutoMark:
+            if (const auto result = auto_mark(move.selection)) {
+                record(result->flagged_cells);
+            }
+            break;
+        }
+        ++applied;
+    }
+
+    const auto& packed = board_->packed_cells();
+    std::vector<Cell> updated_cells;
+    updated_cells.reserve(touched_order.size());
+    for (const std::size_t idx : touched_order) {
+        updated_cells.push_back(packed[idx].to_cell(Position{idx / columns, idx % columns}));
+    }
     LOG_INFO(
         "GameEngine",
-        "Auto-mark placed " << flagged_cells.size() << " flag(s) - flags remaining: " << flags_remaining_
+        "Batch applied " << applied << " of " << moves.size() << " move(s), touching " << updated_cells.size()
+                         << " cell(s) - status " << status_to_string(status_)
     );
+    return BatchResult{
+        std::move(updated_cells), applied, status_ == GameStatus::Defeat, status_ == GameStatus::Victory,
+        flags_remaining_, status_
+    };
+}
+
+ProbabilityMap GameEngine::mine_probabilities() const
+{
+    auto probabilities = probability_engine_.compute(*board_);
+    if (probabilities.status == ProbabilityStatus::Inconsistent) {
+        LOG_INFO("GameEngine", "No mine layout matches the board - flags contradict the revealed numbers");
+    }
+    return probabilities;
+}
+
+std::optional<BoardDelta> GameEngine::changes_since(std::uint64_t version) const
+{
+    if (version < journal_floor_ || version > version_) {
+        return std::nullopt;
+    }
 
-    return AutoMarkResult{std::move(flagged_cells), flags_remaining_, status_ == GameStatus::Victory};
+    std::vector<std::size_t> changed;
+    for (auto it = journal_.rbegin(); it != journal_.rend() && it->version > version; ++it) {
+        changed.push_back(it->cell_index);
+    }
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+    const auto& packed = board_->packed_cells();
+    const std::size_t columns = board_->columns();
+    std::vector<Cell> updated_cells;
+    updated_cells.reserve(changed.size());
+    for (const std::size_t idx : changed) {
+        updated_cells.push_back(packed[idx].to_cell(Position{idx / columns, idx % columns}));
+    }
+    return BoardDelta{version_, flags_remaining_, status_, std::move(updated_cells)};
 }
 
 BoardSnapshot GameEngine::snapshot() const
@@ -282,25 +431,37 @@ BoardSnapshot GameEngine::snapshot() const
         .mines = board_->mine_count(),
         .flags_remaining = flags_remaining_,
         .status = status_,
-        .cells = copy_cells(board_->cells())
+        .cells = board_->cells(),
+        .seed = seed_,
+        .generator = current_config_.generator,
+        .safe_start = current_config_.safe_start,
+        .version = version_
     };
     return snap;
 }
 
 void GameEngine::reset(std::optional<BoardConfig> config)
 {
-    const BoardConfig next_config = config.value_or(current_config_);
+    BoardConfig next_config = config.value_or(current_config_);
     validate_config(next_config);
-    board_ = std::make_unique<MinesweeperBoard>(next_config.rows, next_config.columns, next_config.mines);
+    const std::uint64_t seed = next_config.seed.value_or(random_board_seed());
+    board_ = std::make_unique<MinesweeperBoard>(
+        next_config.rows, next_config.columns, next_config.mines, seed, next_config.generator, next_config.safe_start
+    );
+    // An explicit seed applies to this game only; later resets without a
+    // configuration keep the size and generator but draw a new layout.
+    next_config.seed.reset();
     current_config_ = next_config;
+    seed_ = seed;
+    frontier_.rebuild(*board_);
     flags_remaining_ = next_config.mines;
     status_ = GameStatus::Playing;
     game_over_ = false;
-    first_move_done_ = false;
+    restart_journal();
     LOG_INFO(
         "GameEngine",
         "Board reset to " << next_config.rows << 'x' << next_config.columns << " with " << next_config.mines
-                           << " mines"
+                           << " mines (seed " << seed << ")"
     );
 }
 
@@ -309,52 +470,58 @@ const MinesweeperBoard& GameEngine::board() const noexcept
     return *board_;
 }
 
-void GameEngine::ensure_first_move_safe(Position position)
+const Frontier& GameEngine::frontier() const noexcept
 {
-    constexpr std::size_t kMaxRegenerationAttempts = 16;
+    return frontier_;
+}
 
-    std::size_t attempts = 0;
-    while (board_->cell_at(position).is_mine && attempts < kMaxRegenerationAttempts) {
-        board_->regenerate();
-        ++attempts;
-    }
+std::uint64_t GameEngine::version() const noexcept
+{
+    return version_;
+}
 
-    if (board_->cell_at(position).is_mine) {
-        board_->ensure_safe_cell(position);
-    }
+GameStatus GameEngine::status() const noexcept
+{
+    return status_;
+}
 
-    if (board_->cell_at(position).is_mine) {
-        LOG_CRITICAL(
-            "GameEngine",
-            "Failed to guarantee safe first move at (" << position.row << ',' << position.column << ')'
-        );
-    } else if (attempts > 0) {
-        LOG_DEBUG(
-            "GameEngine",
-            "Regenerated board " << attempts << " time(s) to secure safe starting cell"
-        );
+std::size_t GameEngine::flags_remaining() const noexcept
+{
+    return flags_remaining_;
+}
+
+void GameEngine::record_changes(const std::vector<Cell>& cells)
+{
+    if (cells.empty()) {
+        return;
+    }
+    ++version_;
+    const std::size_t columns = board_->columns();
+    for (const Cell& cell : cells) {
+        journal_.push_back(JournalEntry{version_, cell.position.row * columns + cell.position.column});
+    }
+    // Past one entry per cell a delta is no smaller than a snapshot, so the
+    // journal keeps at most that many and forgets the oldest versions.
+    const std::size_t capacity = board_->rows() * columns;
+    while (journal_.size() > capacity) {
+        journal_floor_ = journal_.front().version;
+        journal_.pop_front();
     }
 }
 
+void GameEngine::restart_journal()
+{
+    journal_.clear();
+    ++version_;
+    journal_floor_ = version_;
+}
+
 void GameEngine::reveal_all_mines(std::vector<Cell>& accumulator)
 {
-    std::size_t revealed_mines = 0;
-    for (std::size_t row = 0; row < board_->rows(); ++row) {
-        for (std::size_t col = 0; col < board_->columns(); ++col) {
-            Position pos{row, col};
-            Cell& cell = board_->mutable_cell(pos);
-            if (!cell.is_mine) {
-                continue;
-            }
-            if (cell.state == CellState::Revealed) {
-                continue;
-            }
-            cell.state = CellState::Revealed;
-            cell.exploded = (status_ == GameStatus::Defeat);
-            accumulator.push_back(cell);
-            ++revealed_mines;
-        }
-    }
+    const std::size_t revealed_mines = board_->reveal_mines(status_ == GameStatus::Defeat, accumulator);
+    // Flags may have turned into revealed mines; a full rebuild once per game
+    // is simpler than tracking which.
+    frontier_.rebuild(*board_);
     LOG_DEBUG("GameEngine", "Revealed " << revealed_mines << " mine cells for end-of-game state");
 }
 
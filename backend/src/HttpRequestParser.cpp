@@ -0,0 +1,309 @@
+#include "HttpRequestParser.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+namespace clearbomb {
+
+namespace {
+constexpr std::string_view kLineEnd = "\r\n";
+constexpr std::string_view kHeadEnd = "\r\n\r\n";
+
+bool is_token_char(char ch) noexcept
+{
+    if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9')) {
+        return true;
+    }
+    switch (ch) {
+    case '!': case '#': case '$': case '%': case '&': case '\'': case '*': case '+':
+    case '-': case '.': case '^': case '_': case '`': case '|': case '~':
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool is_token(std::string_view text) noexcept
+{
+    return !text.empty() && std::all_of(text.begin(), text.end(), is_token_char);
+}
+
+bool is_field_value(std::string_view text) noexcept
+{
+    return std::none_of(text.begin(), text.end(), [](char ch) {
+        const auto byte = static_cast<unsigned char>(ch);
+        return (byte < 0x20 && ch != '\t') || byte == 0x7f;
+    });
+}
+
+bool is_target(std::string_view text) noexcept
+{
+    return !text.empty() && std::none_of(text.begin(), text.end(), [](char ch) {
+        const auto byte = static_cast<unsigned char>(ch);
+        return byte <= 0x20 || byte == 0x7f;
+    });
+}
+
+std::string_view trim_whitespace(std::string_view text) noexcept
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+constexpr HttpParseResult invalid(const char* error) noexcept
+{
+    return HttpParseResult{HttpParseStatus::Invalid, 0, error};
+}
+}  // namespace
+
+bool iequals(std::string_view lhs, std::string_view rhs) noexcept
+{
+    return lhs.size() == rhs.size() &&
+           std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+               const auto lower = [](char ch) { return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch; };
+               return lower(a) == lower(b);
+           });
+}
+
+bool has_list_token(std::string_view list, std::string_view token) noexcept
+{
+    while (!list.empty()) {
+        const auto comma = list.find(',');
+        if (iequals(trim_whitespace(list.substr(0, comma)), token)) {
+            return true;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        list.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+bool accepts_list_token(std::string_view list, std::string_view token) noexcept
+{
+    while (!list.empty()) {
+        const auto comma = list.find(',');
+        std::string_view item = list.substr(0, comma);
+        const auto semicolon = item.find(';');
+        if (iequals(trim_whitespace(item.substr(0, semicolon)), token)) {
+            std::string_view parameters =
+                semicolon == std::string_view::npos ? std::string_view{} : item.substr(semicolon + 1);
+            while (!parameters.empty()) {
+                const auto next = parameters.find(';');
+                const auto parameter = trim_whitespace(parameters.substr(0, next));
+                if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+                    const auto weight = parameter.substr(2);
+                    return weight.find_first_not_of("0.") != std::string_view::npos;
+                }
+                parameters = next == std::string_view::npos ? std::string_view{} : parameters.substr(next + 1);
+            }
+            return true;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        list.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+std::optional<std::string_view> HttpRequest::header(std::string_view name) const noexcept
+{
+    for (std::size_t i = 0; i < header_count; ++i) {
+        if (iequals(headers[i].name, name)) {
+            return headers[i].value;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string_view> HttpRequest::query_parameter(std::string_view name) const noexcept
+{
+    std::string_view remaining = query;
+    while (!remaining.empty()) {
+        const auto separator = remaining.find('&');
+        const auto pair = remaining.substr(0, separator);
+        const auto equals = pair.find('=');
+        if (pair.substr(0, equals) == name) {
+            return equals == std::string_view::npos ? std::string_view{} : pair.substr(equals + 1);
+        }
+        if (separator == std::string_view::npos) {
+            break;
+        }
+        remaining.remove_prefix(separator + 1);
+    }
+    return std::nullopt;
+}
+
+bool HttpRequest::keep_alive() const noexcept
+{
+    const auto connection = header("Connection");
+    if (version == "HTTP/1.1") {
+        return !(connection && has_list_token(*connection, "close"));
+    }
+    return connection && has_list_token(*connection, "keep-alive");
+}
+
+void HttpRequest::rebase(const char* old_base, const char* new_base) noexcept
+{
+    const auto move_view = [old_base, new_base](std::string_view& view) {
+        if (view.data() != nullptr) {
+            view = std::string_view(new_base + (view.data() - old_base), view.size());
+        }
+    };
+    move_view(method);
+    move_view(target);
+    move_view(path);
+    move_view(query);
+    move_view(version);
+    move_view(body);
+    for (std::size_t i = 0; i < header_count; ++i) {
+        move_view(headers[i].name);
+        move_view(headers[i].value);
+    }
+}
+
+HttpRequestParser::HttpRequestParser(HttpParserLimits limits) noexcept
+    : limits_(limits)
+{}
+
+void HttpRequestParser::reset() noexcept
+{
+    scanned_ = 0;
+}
+
+HttpParseResult HttpRequestParser::parse(std::string_view buffer, HttpRequest& request) noexcept
+{
+    // Tolerate stray CRLFs between pipelined requests (RFC 9112 section 2.2).
+    std::size_t leading = 0;
+    while (buffer.substr(leading, kLineEnd.size()) == kLineEnd) {
+        leading += kLineEnd.size();
+    }
+    if (leading > 0) {
+        auto result = parse(buffer.substr(leading), request);
+        if (result.status == HttpParseStatus::Complete) {
+            result.consumed += leading;
+        }
+        return result;
+    }
+
+    // Resume the terminator search a few bytes early in case "\r\n\r\n"
+    // straddles the previous and current reads.
+    const std::size_t search_from = scanned_ >= kHeadEnd.size() - 1 ? scanned_ - (kHeadEnd.size() - 1) : 0;
+    const std::size_t head_end = buffer.find(kHeadEnd, search_from);
+    if (head_end == std::string_view::npos) {
+        scanned_ = buffer.size();
+        if (buffer.size() > limits_.max_header_bytes) {
+            return HttpParseResult{HttpParseStatus::HeadersTooLarge, 0, "request headers exceed limit"};
+        }
+        return HttpParseResult{HttpParseStatus::Incomplete, 0, nullptr};
+    }
+
+    scanned_ = head_end;
+    const std::size_t body_start = head_end + kHeadEnd.size();
+    if (body_start > limits_.max_header_bytes) {
+        return HttpParseResult{HttpParseStatus::HeadersTooLarge, 0, "request headers exceed limit"};
+    }
+
+    request = HttpRequest{};
+    const auto head_result = parse_head(buffer.substr(0, head_end), request);
+    if (head_result.status != HttpParseStatus::Complete) {
+        return head_result;
+    }
+
+    if (request.content_length > limits_.max_body_bytes) {
+        return HttpParseResult{HttpParseStatus::BodyTooLarge, 0, "request body exceeds limit"};
+    }
+
+    if (buffer.size() - body_start < request.content_length) {
+        return HttpParseResult{HttpParseStatus::Incomplete, 0, nullptr};
+    }
+
+    request.body = buffer.substr(body_start, request.content_length);
+    return HttpParseResult{HttpParseStatus::Complete, body_start + request.content_length, nullptr};
+}
+
+HttpParseResult HttpRequestParser::parse_head(std::string_view head, HttpRequest& request) const noexcept
+{
+    const auto line_end = head.find(kLineEnd);
+    const std::string_view request_line = head.substr(0, line_end);
+    std::string_view fields = line_end == std::string_view::npos ? std::string_view{} : head.substr(line_end + 2);
+
+    const auto first_space = request_line.find(' ');
+    const auto second_space = request_line.find(' ', first_space == std::string_view::npos ? 0 : first_space + 1);
+    if (first_space == std::string_view::npos || second_space == std::string_view::npos) {
+        return invalid("malformed request line");
+    }
+
+    request.method = request_line.substr(0, first_space);
+    request.target = request_line.substr(first_space + 1, second_space - first_space - 1);
+    request.version = request_line.substr(second_space + 1);
+
+    if (!is_token(request.method)) {
+        return invalid("invalid method");
+    }
+    if (!is_target(request.target)) {
+        return invalid("invalid request target");
+    }
+    if (request.version != "HTTP/1.1" && request.version != "HTTP/1.0") {
+        return invalid("unsupported HTTP version");
+    }
+
+    const auto query_begin = request.target.find('?');
+    request.path = request.target.substr(0, query_begin);
+    if (query_begin != std::string_view::npos) {
+        request.query = request.target.substr(query_begin + 1);
+    }
+
+    bool saw_content_length = false;
+    while (!fields.empty()) {
+        const auto field_end = fields.find(kLineEnd);
+        const std::string_view line = fields.substr(0, field_end);
+        fields = field_end == std::string_view::npos ? std::string_view{} : fields.substr(field_end + 2);
+
+        if (line.empty() || line.front() == ' ' || line.front() == '\t') {
+            return invalid("obsolete header folding");
+        }
+        const auto colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            return invalid("header without colon");
+        }
+        const std::string_view name = line.substr(0, colon);
+        const std::string_view value = trim_whitespace(line.substr(colon + 1));
+        if (!is_token(name)) {
+            return invalid("invalid header name");
+        }
+        if (!is_field_value(value)) {
+            return invalid("invalid header value");
+        }
+        if (request.header_count == HttpRequest::kMaxHeaders) {
+            return HttpParseResult{HttpParseStatus::HeadersTooLarge, 0, "too many headers"};
+        }
+        request.headers[request.header_count++] = HttpHeader{name, value};
+
+        if (iequals(name, "Content-Length")) {
+            std::size_t length = 0;
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), length);
+            if (value.empty() || error != std::errc{} || end != value.data() + value.size()) {
+                return invalid("invalid Content-Length");
+            }
+            if (saw_content_length && length != request.content_length) {
+                return invalid("conflicting Content-Length headers");
+            }
+            saw_content_length = true;
+            request.content_length = length;
+        } else if (iequals(name, "Transfer-Encoding")) {
+            return invalid("Transfer-Encoding is not supported");
+        }
+    }
+
+    return HttpParseResult{HttpParseStatus::Complete, 0, nullptr};
+}
+
+}  // namespace clearbomb
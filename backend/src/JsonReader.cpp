@@ -0,0 +1,291 @@
+#include "JsonReader.hpp"
+
+#include <charconv>
+
+namespace clearbomb {
+
+namespace {
+bool is_digit(char ch) noexcept
+{
+    return ch >= '0' && ch <= '9';
+}
+
+bool is_hex_digit(char ch) noexcept
+{
+    return is_digit(ch) || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F');
+}
+}  // namespace
+
+JsonReader::JsonReader(std::string_view text) noexcept
+    : text_(text)
+{}
+
+void JsonReader::skip_whitespace() noexcept
+{
+    while (position_ < text_.size()) {
+        const char ch = text_[position_];
+        if (ch != ' ' && ch != '\t' && ch != '\n' && ch != '\r') {
+            return;
+        }
+        ++position_;
+    }
+}
+
+bool JsonReader::consume(char expected) noexcept
+{
+    if (!peek(expected)) {
+        return false;
+    }
+    ++position_;
+    return true;
+}
+
+bool JsonReader::peek(char expected) noexcept
+{
+    if (error_ != nullptr) {
+        return false;
+    }
+    skip_whitespace();
+    return position_ < text_.size() && text_[position_] == expected;
+}
+
+bool JsonReader::enter()
+{
+    if (++depth_ > kMaxDepth) {
+        return fail("nesting too deep");
+    }
+    return true;
+}
+
+bool JsonReader::leave(char close)
+{
+    if (!consume(close)) {
+        return fail(close == '}' ? "expected ',' or '}'" : "expected ',' or ']'");
+    }
+    --depth_;
+    return true;
+}
+
+bool JsonReader::read_unsigned(std::size_t& value)
+{
+    if (error_ != nullptr) {
+        return false;
+    }
+    skip_whitespace();
+    const std::size_t start = position_;
+    while (position_ < text_.size() && is_digit(text_[position_])) {
+        ++position_;
+    }
+    if (position_ == start) {
+        return fail("expected a non-negative integer");
+    }
+    if (position_ < text_.size() && (text_[position_] == '.' || text_[position_] == 'e' || text_[position_] == 'E')) {
+        return fail("expected an integer");
+    }
+    if (text_[start] == '0' && position_ - start > 1) {
+        position_ = start;
+        return fail("leading zeros are not allowed");
+    }
+    const auto [end, error] = std::from_chars(text_.data() + start, text_.data() + position_, value);
+    if (error != std::errc{}) {
+        position_ = start;
+        return fail("integer out of range");
+    }
+    static_cast<void>(end);
+    return true;
+}
+
+bool JsonReader::read_bool(bool& value)
+{
+    if (peek('t')) {
+        value = true;
+        return read_literal("true");
+    }
+    if (peek('f')) {
+        value = false;
+        return read_literal("false");
+    }
+    return fail("expected true or false");
+}
+
+bool JsonReader::read_literal(std::string_view literal)
+{
+    if (text_.substr(position_, literal.size()) != literal) {
+        return fail("invalid literal");
+    }
+    position_ += literal.size();
+    return true;
+}
+
+bool JsonReader::read_string(std::string_view& value)
+{
+    if (!consume('"')) {
+        return fail("expected string");
+    }
+    const std::size_t start = position_;
+    while (position_ < text_.size()) {
+        const char ch = text_[position_];
+        if (ch == '"') {
+            value = text_.substr(start, position_ - start);
+            ++position_;
+            return true;
+        }
+        if (static_cast<unsigned char>(ch) < 0x20) {
+            return fail("control character in string");
+        }
+        if (ch == '\\') {
+            if (++position_ >= text_.size()) {
+                break;
+            }
+            switch (text_[position_]) {
+            case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                break;
+            case 'u':
+                for (std::size_t i = 1; i <= 4; ++i) {
+                    if (position_ + i >= text_.size() || !is_hex_digit(text_[position_ + i])) {
+                        return fail("invalid \\u escape");
+                    }
+                }
+                position_ += 4;
+                break;
+            default:
+                return fail("invalid escape sequence");
+            }
+        }
+        ++position_;
+    }
+    return fail("unterminated string");
+}
+
+bool JsonReader::skip_number()
+{
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    const auto digits = [this]() {
+        const std::size_t start = position_;
+        while (position_ < text_.size() && is_digit(text_[position_])) {
+            ++position_;
+        }
+        return position_ - start;
+    };
+
+    const bool negative = position_ < text_.size() && text_[position_] == '-';
+    if (negative) {
+        ++position_;
+    }
+    const std::size_t integer_start = position_;
+    const std::size_t integer_digits = digits();
+    if (integer_digits == 0) {
+        return fail(negative ? "invalid number" : "expected a value");
+    }
+    if (integer_digits > 1 && text_[integer_start] == '0') {
+        return fail("leading zeros are not allowed");
+    }
+    if (position_ < text_.size() && text_[position_] == '.') {
+        ++position_;
+        if (digits() == 0) {
+            return fail("invalid number");
+        }
+    }
+    if (position_ < text_.size() && (text_[position_] == 'e' || text_[position_] == 'E')) {
+        ++position_;
+        if (position_ < text_.size() && (text_[position_] == '+' || text_[position_] == '-')) {
+            ++position_;
+        }
+        if (digits() == 0) {
+            return fail("invalid number");
+        }
+    }
+    return true;
+}
+
+bool JsonReader::skip_value()
+{
+    if (error_ != nullptr) {
+        return false;
+    }
+    skip_whitespace();
+    if (position_ >= text_.size()) {
+        return fail("unexpected end of input");
+    }
+    switch (text_[position_]) {
+    case '{':
+        return read_object([this](std::string_view) { return skip_value(); });
+    case '[':
+        return read_array([this](std::size_t) { return skip_value(); });
+    case '"': {
+        std::string_view ignored;
+        return read_string(ignored);
+    }
+    case 't':
+        return read_literal("true");
+    case 'f':
+        return read_literal("false");
+    case 'n':
+        return read_literal("null");
+    default:
+        return skip_number();
+    }
+}
+
+bool JsonReader::finish()
+{
+    if (error_ != nullptr) {
+        return false;
+    }
+    skip_whitespace();
+    if (position_ != text_.size()) {
+        return fail("unexpected trailing characters");
+    }
+    return true;
+}
+
+bool JsonReader::fail(const char* message, std::string_view field) noexcept
+{
+    // Keep the innermost error; outer frames only add the member name.
+    if (error_ == nullptr) {
+        error_ = message;
+        error_offset_ = position_;
+    }
+    if (error_field_.empty()) {
+        error_field_ = field;
+    }
+    return false;
+}
+
+bool JsonReader::fail_missing(std::string_view field) noexcept
+{
+    if (error_ == nullptr) {
+        error_ = "missing required field";
+        error_field_ = field;
+        error_offset_ = std::string_view::npos;
+    }
+    return false;
+}
+
+bool JsonReader::failed() const noexcept
+{
+    return error_ != nullptr;
+}
+
+std::string JsonReader::error_message() const
+{
+    if (error_ == nullptr) {
+        return {};
+    }
+    std::string message;
+    if (!error_field_.empty()) {
+        message.append("field \"").append(error_field_).append("\": ");
+    }
+    message.append(error_);
+    if (error_offset_ != std::string_view::npos) {
+        message.append(" at offset ").append(std::to_string(error_offset_));
+    }
+    return message;
+}
+
+bool read_unsigned_fields(JsonReader& reader, std::span<JsonUnsignedField> fields)
+{
+    return read_unsigned_fields(reader, fields, [&reader](std::string_view) { return reader.skip_value(); });
+}
+
+}  // namespace clearbomb
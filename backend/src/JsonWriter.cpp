@@ -0,0 +1,270 @@
+#include "JsonWriter.hpp"
+#include "Base64.hpp"
+#include "BinaryProtocol.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace clearbomb {
+
+namespace {
+// Every cell object has the same shape; only the coordinates, state,
+// adjacency digit and two booleans vary. The state fragments carry the
+// surrounding keys so each cell costs a handful of appends.
+constexpr std::string_view kCellRowPrefix = "{\"row\":";
+constexpr std::string_view kCellColumnPrefix = ",\"column\":";
+
+constexpr std::array<std::string_view, 3> kCellStateFragments = {
+    ",\"state\":\"hidden\",\"adjacentMines\":",
+    ",\"state\":\"revealed\",\"adjacentMines\":",
+    ",\"state\":\"flagged\",\"adjacentMines\":",
+};
+
+// Indexed by (isMine << 1) | exploded.
+constexpr std::array<std::string_view, 4> kCellTails = {
+    ",\"isMine\":false,\"exploded\":false}",
+    ",\"isMine\":false,\"exploded\":true}",
+    ",\"isMine\":true,\"exploded\":false}",
+    ",\"isMine\":true,\"exploded\":true}",
+};
+
+constexpr std::size_t kMaxCellBytes = kCellRowPrefix.size() + kCellColumnPrefix.size() + 2 * 20 +
+                                      kCellStateFragments[1].size() + 11 + kCellTails[3].size();
+
+std::size_t state_index(CellState state) noexcept
+{
+    switch (state) {
+    case CellState::Hidden:
+        return 0;
+    case CellState::Revealed:
+        return 1;
+    case CellState::Flagged:
+        return 2;
+    }
+    return 0;
+}
+
+template <typename Integer>
+void append_integer(std::string& out, Integer value)
+{
+    std::array<char, std::numeric_limits<Integer>::digits10 + 3> digits {};
+    const auto [end, error] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    static_cast<void>(error);
+    out.append(digits.data(), static_cast<std::size_t>(end - digits.data()));
+}
+}  // namespace
+
+std::string_view game_status_name(GameStatus status) noexcept
+{
+    switch (status) {
+    case GameStatus::Playing:
+        return "playing";
+    case GameStatus::Victory:
+        return "victory";
+    case GameStatus::Defeat:
+        return "defeat";
+    }
+    return "playing";
+}
+
+std::string_view board_generator_name(BoardGenerator generator) noexcept
+{
+    switch (generator) {
+    case BoardGenerator::Mt19937:
+        return "mt19937";
+    case BoardGenerator::Counter:
+        return "counter";
+    }
+    return "mt19937";
+}
+
+std::string_view safe_start_name(SafeStart safe_start) noexcept
+{
+    switch (safe_start) {
+    case SafeStart::None:
+        return "none";
+    case SafeStart::Cell:
+        return "cell";
+    case SafeStart::Neighborhood:
+        return "neighborhood";
+    }
+    return "cell";
+}
+
+std::string_view cell_state_name(CellState state) noexcept
+{
+    switch (state) {
+    case CellState::Hidden:
+        return "hidden";
+    case CellState::Revealed:
+        return "revealed";
+    case CellState::Flagged:
+        return "flagged";
+    }
+    return "hidden";
+}
+
+JsonWriter::JsonWriter(std::string& out) noexcept
+    : out_(out)
+{}
+
+JsonWriter& JsonWriter::raw(std::string_view text)
+{
+    out_.append(text);
+    return *this;
+}
+
+JsonWriter& JsonWriter::number(std::size_t value)
+{
+    append_integer(out_, value);
+    return *this;
+}
+
+JsonWriter& JsonWriter::number(int value)
+{
+    append_integer(out_, value);
+    return *this;
+}
+
+JsonWriter& JsonWriter::number(double value)
+{
+    if (!std::isfinite(value)) {
+        out_.append("null");
+        return *this;
+    }
+    std::array<char, 32> digits {};
+    const auto [end, error] =
+        std::to_chars(digits.data(), digits.data() + digits.size(), value, std::chars_format::general, 6);
+    static_cast<void>(error);
+    out_.append(digits.data(), static_cast<std::size_t>(end - digits.data()));
+    return *this;
+}
+
+JsonWriter& JsonWriter::boolean(bool value)
+{
+    out_.append(value ? "true" : "false");
+    return *this;
+}
+
+JsonWriter& JsonWriter::string(std::string_view value)
+{
+    constexpr std::string_view kHexDigits = "0123456789abcdef";
+    out_.push_back('"');
+    for (const char ch : value) {
+        const auto byte = static_cast<unsigned char>(ch);
+        if (ch == '"' || ch == '\\') {
+            out_.push_back('\\');
+            out_.push_back(ch);
+        } else if (byte < 0x20) {
+            out_.append("\\u00");
+            out_.push_back(kHexDigits[byte >> 4]);
+            out_.push_back(kHexDigits[byte & 0x0f]);
+        } else {
+            out_.push_back(ch);
+        }
+    }
+    out_.push_back('"');
+    return *this;
+}
+
+JsonWriter& JsonWriter::cell(const Cell& cell)
+{
+    // Mines and adjacency counts stay hidden until the cell is revealed.
+    const bool revealed = cell.state == CellState::Revealed;
+    const bool mine_visible = revealed && cell.is_mine;
+    const int adjacent_value = (revealed && !cell.is_mine) ? cell.adjacent_mines : 0;
+
+    out_.append(kCellRowPrefix);
+    append_integer(out_, cell.position.row);
+    out_.append(kCellColumnPrefix);
+    append_integer(out_, cell.position.column);
+    out_.append(kCellStateFragments[state_index(cell.state)]);
+    if (adjacent_value >= 0 && adjacent_value <= 9) {
+        out_.push_back(static_cast<char>('0' + adjacent_value));
+    } else {
+        append_integer(out_, adjacent_value);
+    }
+    out_.append(kCellTails[(mine_visible ? 2U : 0U) | (cell.exploded ? 1U : 0U)]);
+    return *this;
+}
+
+JsonWriter& JsonWriter::cells(const std::vector<Cell>& cells)
+{
+    out_.reserve(out_.size() + cells_capacity(cells.size()));
+    out_.push_back('[');
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        if (i > 0) {
+            out_.push_back(',');
+        }
+        cell(cells[i]);
+    }
+    out_.push_back(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::board_snapshot(const BoardSnapshot& snapshot)
+{
+    snapshot_fields(snapshot);
+    raw(",\"cells\":").cells(snapshot.cells);
+    out_.push_back('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::compact_board_snapshot(const BoardSnapshot& snapshot)
+{
+    std::string runs;
+    append_run_length_cells(runs, snapshot.cells);
+    snapshot_fields(snapshot);
+    raw(",\"encoding\":\"rle\",\"cells\":\"").raw(base64_encode(runs)).raw("\"}");
+    return *this;
+}
+
+void JsonWriter::snapshot_fields(const BoardSnapshot& snapshot)
+{
+    raw("{\"rows\":").number(snapshot.rows);
+    raw(",\"columns\":").number(snapshot.columns);
+    raw(",\"mines\":").number(snapshot.mines);
+    raw(",\"flagsRemaining\":").number(snapshot.flags_remaining);
+    raw(",\"status\":\"").raw(game_status_name(snapshot.status));
+    raw("\",\"seed\":").number(static_cast<std::size_t>(snapshot.seed));
+    raw(",\"generator\":\"").raw(board_generator_name(snapshot.generator));
+    raw("\",\"safeStart\":\"").raw(safe_start_name(snapshot.safe_start));
+    raw("\",\"version\":").number(static_cast<std::size_t>(snapshot.version));
+}
+
+JsonWriter& JsonWriter::board_delta(const BoardDelta& delta)
+{
+    raw("{\"version\":").number(static_cast<std::size_t>(delta.version));
+    raw(",\"flagsRemaining\":").number(delta.flags_remaining);
+    raw(",\"status\":\"").raw(game_status_name(delta.status));
+    raw("\",\"updatedCells\":").cells(delta.updated_cells);
+    out_.push_back('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::cell_probabilities(const std::vector<CellProbability>& cells)
+{
+    out_.push_back('[');
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        if (i > 0) {
+            out_.push_back(',');
+        }
+        out_.append(kCellRowPrefix);
+        append_integer(out_, cells[i].position.row);
+        out_.append(kCellColumnPrefix);
+        append_integer(out_, cells[i].position.column);
+        raw(",\"mineProbability\":").number(cells[i].mine_probability);
+        out_.push_back('}');
+    }
+    out_.push_back(']');
+    return *this;
+}
+
+std::size_t JsonWriter::cells_capacity(std::size_t count) noexcept
+{
+    return 2 + count * (kMaxCellBytes + 1);
+}
+
+}  // namespace clearbomb
@@ -1,5 +1,7 @@
 #include "Logger.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <chrono>
 #include <ctime>
 #include <filesystem>
@@ -7,6 +9,8 @@
 #include <iostream>
 #include <sstream>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace clearbomb {
 namespace {
@@ -31,8 +35,75 @@ std::string format_date(const std::tm& tm)
     return oss.str();
 }
 
+constexpr std::size_t kMaxRecordsPerBatch = 1024;
+constexpr auto kWriterIdlePoll = std::chrono::milliseconds(10);
+
 }  // namespace
 
+// Bounded multi-producer / single-consumer ring of preformatted lines
+// (Vyukov's sequence-numbered slots). Producers claim a slot with one CAS on
+// the enqueue position; the writer thread is the only consumer.
+class Logger::RecordQueue {
+public:
+    explicit RecordQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1)
+        , slots_(mask_ + 1)
+    {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Sets wake every quarter of the capacity so a burst is drained before
+    // the ring fills up, without waking the writer for every record.
+    bool try_push(std::string& line, bool& wake) noexcept
+    {
+        std::size_t position = enqueue_position_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[position & mask_];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == position) {
+                if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.line.swap(line);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    wake = (position & (mask_ >> 2)) == 0;
+                    return true;
+                }
+            } else if (sequence < position) {
+                return false;  // full: the slot still holds an unread record
+            } else {
+                position = enqueue_position_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Hands the oldest record to sink; returns false when the queue is empty.
+    template <typename Sink>
+    bool pop(Sink&& sink)
+    {
+        Slot& slot = slots_[dequeue_position_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1) {
+            return false;
+        }
+        sink(std::as_const(slot.line));
+        slot.line.clear();
+        slot.sequence.store(dequeue_position_ + mask_ + 1, std::memory_order_release);
+        ++dequeue_position_;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence {0};
+        std::string line;
+    };
+
+    const std::size_t mask_;
+    std::vector<Slot> slots_;
+    alignas(64) std::atomic<std::size_t> enqueue_position_ {0};
+    alignas(64) std::size_t dequeue_position_ {0};
+};
+
 Logger& Logger::instance()
 {
     static Logger instance;
@@ -45,16 +116,19 @@ Logger::Logger()
     , rotation_index_(0)
 {}
 
+Logger::~Logger()
+{
+    stop_async();
+}
+
 void Logger::set_level(LogLevel level)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    level_ = level;
+    level_.store(level, std::memory_order_relaxed);
 }
 
 LogLevel Logger::level() const noexcept
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return level_;
+    return level_.load(std::memory_order_relaxed);
 }
 
 void Logger::enable_console_logging(bool enabled)
@@ -76,6 +150,9 @@ void Logger::set_log_directory(const std::string& directory, std::string base_fi
     rotation_index_ = 0;
     current_date_.clear();
     current_file_path_.clear();
+    if (file_stream_.is_open()) {
+        file_stream_.close();
+    }
 
     std::error_code ec;
     std::filesystem::create_directories(directory, ec);
@@ -84,6 +161,46 @@ void Logger::set_log_directory(const std::string& directory, std::string base_fi
     }
 }
 
+void Logger::start_async(AsyncLoggingOptions options)
+{
+    std::lock_guard<std::mutex> control(async_control_mutex_);
+    if (queue_) {
+        return;
+    }
+    queue_ = std::make_unique<RecordQueue>(options.queue_capacity);
+    writer_stopping_.store(false);
+    writer_ = std::thread(&Logger::writer_loop, this, options.flush_interval);
+    active_queue_.store(queue_.get());
+}
+
+void Logger::stop_async()
+{
+    std::lock_guard<std::mutex> control(async_control_mutex_);
+    if (!queue_) {
+        return;
+    }
+    // New records go the synchronous route from here on; wait for producers
+    // that already picked up the queue before letting the writer drain it.
+    active_queue_.store(nullptr);
+    while (producers_in_flight_.load() != 0) {
+        std::this_thread::yield();
+    }
+    writer_stopping_.store(true);
+    wake_writer();
+    writer_.join();
+    queue_.reset();
+}
+
+bool Logger::async_enabled() const noexcept
+{
+    return active_queue_.load(std::memory_order_relaxed) != nullptr;
+}
+
+std::uint64_t Logger::dropped_records() const noexcept
+{
+    return dropped_records_.load(std::memory_order_relaxed);
+}
+
 void Logger::log(
     LogLevel level,
     std::string_view module,
@@ -92,76 +209,160 @@ void Logger::log(
     const std::string& message
 )
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (level < level_) {
+    if (level < level_.load(std::memory_order_relaxed)) {
         return;
     }
 
-    const std::string timestamp = current_timestamp_string();
-    const std::string level_text = level_to_string(level);
-    const std::string thread_id = thread_id_string();
+    std::string line_text;
+    line_text.reserve(64 + module.size() + function.size() + message.size());
+    line_text.append("[").append(current_timestamp_string());
+    line_text.append("] [").append(level_to_string(level));
+    line_text.append("] [").append(thread_id_string());
+    line_text.append("] [").append(module).append(".").append(function).append(":").append(std::to_string(line));
+    line_text.append("] - ").append(message);
+
+    producers_in_flight_.fetch_add(1);
+    if (RecordQueue* queue = active_queue_.load()) {
+        bool wake = false;
+        const bool queued = queue->try_push(line_text, wake);
+        producers_in_flight_.fetch_sub(1);
+        if (!queued) {
+            dropped_records_.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Routine records mostly wait for the writer's next poll; waking it
+        // per record would cost a futex call on the request thread.
+        if (level >= LogLevel::Error) {
+            flush_requested_.store(true, std::memory_order_relaxed);
+            wake_writer();
+        } else if (wake || !queued) {
+            wake_writer();
+        }
+        return;
+    }
+    producers_in_flight_.fetch_sub(1);
 
-    std::ostringstream formatted;
-    formatted << '[' << timestamp << "] [" << level_text << "] [" << thread_id << "] [" << module
-              << '.' << function << ':' << line << "] - " << message;
-    const std::string line_text = formatted.str();
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_line(line_text, true);
+}
 
+void Logger::write_line(std::string_view line, bool flush)
+{
     if (console_enabled_) {
-        std::cout << line_text << std::endl;
+        std::cout << line << '\n';
+        if (flush) {
+            std::cout.flush();
+        }
     }
 
     if (file_target_) {
-        const std::size_t payload_size = line_text.size() + 1;  // include newline
+        const std::size_t payload_size = line.size() + 1;  // include newline
         ensure_file_target_ready(payload_size);
         if (file_stream_.is_open()) {
-            file_stream_ << line_text << '\n';
-            file_stream_.flush();
+            file_stream_ << line << '\n';
+            current_file_size_ += payload_size;
+            if (flush) {
+                file_stream_.flush();
+            }
         }
     }
 }
 
-void Logger::ensure_file_target_ready(std::size_t message_payload_size)
+void Logger::flush_sinks()
 {
-    if (!file_target_) {
-        return;
+    if (console_enabled_) {
+        std::cout.flush();
+    }
+    if (file_stream_.is_open()) {
+        file_stream_.flush();
     }
+}
 
-    const auto now = std::chrono::system_clock::now();
-    const auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    const std::tm local_tm = local_time_from_time_t(now_time_t);
-    const std::string today = format_date(local_tm);
+void Logger::wake_writer() noexcept
+{
+    writer_wakeup_.notify_one();
+}
 
-    if (today != current_date_) {
-        current_date_ = today;
-        rotation_index_ = 0;
-        current_file_path_.clear();
-        if (file_stream_.is_open()) {
-            file_stream_.close();
+void Logger::writer_loop(std::chrono::milliseconds flush_interval)
+{
+    std::uint64_t reported_drops = 0;
+    auto last_flush = std::chrono::steady_clock::now();
+
+    while (true) {
+        const bool stopping = writer_stopping_.load();
+        std::size_t written = 0;
+        {
+            // Lines go through the stream buffers one by one so rotation
+            // still happens on line boundaries; only flushing is batched.
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (written < kMaxRecordsPerBatch &&
+                   queue_->pop([this](const std::string& line) { write_line(line, false); })) {
+                ++written;
+            }
+
+            const std::uint64_t drops = dropped_records_.load(std::memory_order_relaxed);
+            if (drops != reported_drops) {
+                write_line(
+                    "[Logger] Dropped " + std::to_string(drops - reported_drops) + " record(s) - async queue full",
+                    false
+                );
+                reported_drops = drops;
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (stopping || flush_requested_.exchange(false) || now - last_flush >= flush_interval) {
+                flush_sinks();
+                last_flush = now;
+            }
+        }
+
+        if (written == kMaxRecordsPerBatch) {
+            continue;
+        }
+        if (stopping) {
+            if (written == 0) {
+                break;
+            }
+            continue;
         }
+
+        std::unique_lock<std::mutex> lock(writer_mutex_);
+        writer_wakeup_.wait_for(lock, std::min<std::chrono::milliseconds>(flush_interval, kWriterIdlePoll));
     }
+}
 
-    if (!file_stream_.is_open()) {
-        open_stream_for_rotation();
+void Logger::ensure_file_target_ready(std::size_t message_payload_size)
+{
+    if (!file_target_) {
+        return;
     }
 
-    while (file_stream_.is_open()) {
-        std::uintmax_t current_size = 0;
-        std::error_code ec;
-        if (!current_file_path_.empty()) {
-            current_size = std::filesystem::file_size(current_file_path_, ec);
-            if (ec) {
-                current_size = 0;
+    // The date can only change between seconds, so skip the localtime call
+    // for the rest of a second once it has been checked.
+    const auto now_time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    if (now_time_t != date_checked_at_) {
+        date_checked_at_ = now_time_t;
+        const std::string today = format_date(local_time_from_time_t(now_time_t));
+        if (today != current_date_) {
+            current_date_ = today;
+            rotation_index_ = 0;
+            current_file_path_.clear();
+            if (file_stream_.is_open()) {
+                file_stream_.close();
             }
         }
+    }
 
-        if (file_target_->max_file_size_bytes > 0 && current_size + message_payload_size > file_target_->max_file_size_bytes) {
-            file_stream_.close();
-            ++rotation_index_;
-            open_stream_for_rotation();
-            continue;
-        }
+    if (!file_stream_.is_open()) {
+        open_stream_for_rotation();
+    }
 
-        break;
+    // Rotate on the tracked size instead of asking the filesystem per line.
+    // A fresh file always accepts at least one line, however long.
+    while (file_stream_.is_open() && file_target_->max_file_size_bytes > 0 && current_file_size_ > 0 &&
+           current_file_size_ + message_payload_size > file_target_->max_file_size_bytes) {
+        file_stream_.close();
+        ++rotation_index_;
+        open_stream_for_rotation();
     }
 }
 
@@ -190,13 +391,18 @@ void Logger::open_stream_for_rotation()
     candidate += ".log";
 
     current_file_path_ = candidate.string();
+    std::error_code ec;
+    current_file_size_ = std::filesystem::file_size(candidate, ec);
+    if (ec) {
+        current_file_size_ = 0;
+    }
     file_stream_.open(candidate, std::ios::app);
     if (!file_stream_.is_open()) {
         std::cerr << "[Logger] Failed to open log file '" << candidate.string() << "'" << std::endl;
     }
 }
 
-std::string Logger::level_to_string(LogLevel level)
+std::string_view Logger::level_to_string(LogLevel level)
 {
     switch (level) {
     case LogLevel::Debug:
@@ -213,22 +419,31 @@ std::string Logger::level_to_string(LogLevel level)
     return "INFO";
 }
 
-std::string Logger::current_timestamp_string()
+std::string_view Logger::current_timestamp_string()
 {
-    const auto now = std::chrono::system_clock::now();
-    const auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    const std::tm local_tm = local_time_from_time_t(now_time_t);
-
-    std::ostringstream oss;
-    oss << std::put_time(&local_tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+    // Reformat only when the second changes; each thread keeps its own copy.
+    thread_local std::time_t cached_time = -1;
+    thread_local std::string cached_text;
+
+    const auto now_time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    if (now_time_t != cached_time) {
+        const std::tm local_tm = local_time_from_time_t(now_time_t);
+        std::ostringstream oss;
+        oss << std::put_time(&local_tm, "%Y-%m-%d %H:%M:%S");
+        cached_text = oss.str();
+        cached_time = now_time_t;
+    }
+    return cached_text;
 }
 
-std::string Logger::thread_id_string()
+std::string_view Logger::thread_id_string()
 {
-    std::ostringstream oss;
-    oss << std::this_thread::get_id();
-    return oss.str();
+    thread_local const std::string cached = []() {
+        std::ostringstream oss;
+        oss << std::this_thread::get_id();
+        return oss.str();
+    }();
+    return cached;
 }
 
 }  // namespace clearbomb
@@ -2,26 +2,32 @@
 #include "Logger.hpp"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
-#include <numeric>
+#include <random>
 #include <stdexcept>
 
 namespace clearbomb {
 
-namespace {
-constexpr int kNeighborOffsets[8][2] = {
-    {-1, -1}, {-1, 0}, {-1, 1},
-    {0, -1},           {0, 1},
-    {1, -1},  {1, 0},  {1, 1}
-};
-}
-
 MinesweeperBoard::MinesweeperBoard(std::size_t rows, std::size_t columns, std::size_t mine_count)
+    : MinesweeperBoard(rows, columns, mine_count, random_board_seed())
+{}
+
+MinesweeperBoard::MinesweeperBoard(
+    std::size_t rows,
+    std::size_t columns,
+    std::size_t mine_count,
+    std::uint64_t seed,
+    BoardGenerator generator,
+    SafeStart safe_start
+)
     : rows_(rows)
     , columns_(columns)
     , mine_count_(mine_count)
     , cells_(rows * columns)
-    , rng_(std::random_device{}())
+    , seed_(seed)
+    , generator_(generator)
+    , safe_start_(safe_start)
 {
     if (rows == 0 || columns == 0) {
         LOG_ERROR(
@@ -38,6 +44,15 @@ MinesweeperBoard::MinesweeperBoard(std::size_t rows, std::size_t columns, std::s
         throw std::invalid_argument("Mine count must be between 1 and total cell count - 1.");
     }
 
+    if (safe_start_ != SafeStart::None) {
+        LOG_INFO(
+            "MinesweeperBoard",
+            "Board created " << rows_ << 'x' << columns_ << " with " << mine_count_
+                             << " mines placed on first reveal (seed " << seed_ << ")"
+        );
+        return;
+    }
+
     const auto start = std::chrono::steady_clock::now();
     populate_board();
     const auto end = std::chrono::steady_clock::now();
@@ -45,7 +60,7 @@ MinesweeperBoard::MinesweeperBoard(std::size_t rows, std::size_t columns, std::s
     LOG_INFO(
         "MinesweeperBoard",
         "Board populated " << rows_ << 'x' << columns_ << " with " << mine_count_ << " mines in "
-                            << duration_ms << " ms"
+                            << duration_ms << " ms (seed " << seed_ << ")"
     );
 }
 
@@ -62,22 +77,25 @@ RevealOutcome MinesweeperBoard::reveal(Position position)
     LOG_DEBUG("MinesweeperBoard", "Reveal processing at (" << position.row << ',' << position.column << ")");
 
     RevealOutcome outcome{};
-    Cell& cell = cells_.at(index(position));
+    PackedCell& cell = cells_.at(index(position));
+    if (!mines_placed_ && cell.state() == CellState::Hidden) {
+        place_mines_for_first_reveal(position);
+    }
 
-    if (cell.state == CellState::Flagged || cell.state == CellState::Revealed) {
+    if (cell.state() == CellState::Flagged || cell.state() == CellState::Revealed) {
         LOG_DEBUG(
             "MinesweeperBoard",
             "Reveal ignored due to cell already in state "
-                << (cell.state == CellState::Flagged ? "Flagged" : "Revealed")
+                << (cell.state() == CellState::Flagged ? "Flagged" : "Revealed")
         );
         return outcome;
     }
 
-    if (cell.is_mine) {
-        cell.state = CellState::Revealed;
-        cell.exploded = true;
+    if (cell.is_mine()) {
+        cell.set_state(CellState::Revealed);
+        cell.set_exploded(true);
         outcome.hit_mine = true;
-        outcome.revealed_cells.push_back(cell);
+        outcome.revealed_cells.push_back(cell.to_cell(position));
         LOG_WARNING(
             "MinesweeperBoard",
             "Mine revealed at (" << position.row << ',' << position.column << ")"
@@ -85,54 +103,91 @@ RevealOutcome MinesweeperBoard::reveal(Position position)
         return outcome;
     }
 
-    std::vector<bool> visited(cells_.size(), false);
-    std::queue<Position> frontier;
-    frontier.push(position);
-    visited[index(position)] = true;
-
-    while (!frontier.empty()) {
-        const Position current = frontier.front();
-        frontier.pop();
-
-        Cell& current_cell = cells_.at(index(current));
-        if (current_cell.state == CellState::Flagged) {
-            LOG_DEBUG(
-                "MinesweeperBoard",
-                "Skipping expansion from flagged cell at (" << current.row << ',' << current.column << ")"
-            );
-            continue;
-        }
-        if (current_cell.state != CellState::Revealed) {
-            current_cell.state = CellState::Revealed;
-            current_cell.exploded = false;
-            ++revealed_safe_cells_;
-            outcome.revealed_cells.push_back(current_cell);
-        }
+    if (cell.adjacent_mines() != 0) {
+        cell.set_state(CellState::Revealed);
+        cell.set_exploded(false);
+        ++revealed_safe_cells_;
+        outcome.revealed_cells.push_back(cell.to_cell(position));
+    } else {
+        const std::size_t start = index(position);
+        reveal_span_region(std::span<const std::size_t>(&start, 1), outcome.revealed_cells);
+    }
 
-        if (current_cell.adjacent_mines != 0) {
-            continue;
-        }
+    LOG_DEBUG(
+        "MinesweeperBoard",
+        "Reveal finished at (" << position.row << ',' << position.column << ") exposing "
+                               << outcome.revealed_cells.size() << " cells"
+    );
+    return outcome;
+}
 
-        for (const auto& neighbor_cell : neighbors(current)) {
-            const auto neighbor_index = index(neighbor_cell.position);
-            if (visited[neighbor_index]) {
-                continue;
-            }
-            visited[neighbor_index] = true;
+RevealOutcome MinesweeperBoard::chord(Position position)
+{
+    if (!in_bounds(position)) {
+        LOG_ERROR(
+            "MinesweeperBoard",
+            "Chord request out of bounds at (" << position.row << ',' << position.column << ")"
+        );
+        throw std::out_of_range("Chord position outside of board bounds.");
+    }
 
-            Cell& mutable_neighbor = cells_.at(neighbor_index);
-            if (mutable_neighbor.is_mine || mutable_neighbor.state == CellState::Flagged) {
-                continue;
-            }
+    RevealOutcome outcome{};
+    const std::size_t center = index(position);
+    const PackedCell center_cell = cells_[center];
+    if (center_cell.state() != CellState::Revealed || center_cell.is_mine() || center_cell.adjacent_mines() == 0) {
+        LOG_DEBUG(
+            "MinesweeperBoard",
+            "Chord ignored - no revealed number at (" << position.row << ',' << position.column << ")"
+        );
+        return outcome;
+    }
+    int flags = 0;
+    for_each_neighbor(center, [&](std::size_t neighbor) {
+        flags += cells_[neighbor].state() == CellState::Flagged ? 1 : 0;
+    });
+    if (flags != center_cell.adjacent_mines()) {
+        LOG_DEBUG(
+            "MinesweeperBoard",
+            "Chord ignored at (" << position.row << ',' << position.column << ") - " << flags << " flag(s) around "
+                                 << center_cell.adjacent_mines()
+        );
+        return outcome;
+    }
 
-            frontier.push(neighbor_cell.position);
+    // Numbers and mines are revealed directly; zero cells become seeds of a
+    // single fill.
+    std::array<std::size_t, 8> seeds {};
+    std::size_t seed_count = 0;
+    for_each_neighbor(center, [&](std::size_t neighbor) {
+        PackedCell& cell = cells_[neighbor];
+        if (cell.state() != CellState::Hidden) {
+            return;
         }
+        if (cell.is_mine()) {
+            cell.set_state(CellState::Revealed);
+            cell.set_exploded(true);
+            outcome.hit_mine = true;
+            outcome.revealed_cells.push_back(cell.to_cell(position_of(neighbor)));
+        } else if (cell.adjacent_mines() != 0) {
+            cell.set_state(CellState::Revealed);
+            cell.set_exploded(false);
+            ++revealed_safe_cells_;
+            outcome.revealed_cells.push_back(cell.to_cell(position_of(neighbor)));
+        } else {
+            seeds[seed_count++] = neighbor;
+        }
+    });
+    if (seed_count > 0) {
+        reveal_span_region(std::span<const std::size_t>(seeds.data(), seed_count), outcome.revealed_cells);
     }
 
+    if (outcome.hit_mine) {
+        LOG_WARNING("MinesweeperBoard", "Chord at (" << position.row << ',' << position.column << ") hit a mine");
+    }
     LOG_DEBUG(
         "MinesweeperBoard",
-        "Reveal finished at (" << position.row << ',' << position.column << ") exposing "
-                               << outcome.revealed_cells.size() << " cells"
+        "Chord finished at (" << position.row << ',' << position.column << ") exposing "
+                              << outcome.revealed_cells.size() << " cells"
     );
     return outcome;
 }
@@ -147,35 +202,35 @@ ToggleOutcome MinesweeperBoard::toggle_flag(Position position)
         throw std::out_of_range("Toggle position outside of board bounds.");
     }
 
-    Cell& cell = cells_.at(index(position));
-    if (cell.state == CellState::Revealed) {
+    PackedCell& cell = cells_.at(index(position));
+    if (cell.state() == CellState::Revealed) {
         LOG_DEBUG(
             "MinesweeperBoard",
             "Flag toggle ignored - cell already revealed at (" << position.row << ',' << position.column << ")"
         );
-        return ToggleOutcome{cell, false};
+        return ToggleOutcome{cell.to_cell(position), false};
     }
 
-    if (cell.state == CellState::Hidden) {
-        cell.state = CellState::Flagged;
-        cell.exploded = false;
+    if (cell.state() == CellState::Hidden) {
+        cell.set_state(CellState::Flagged);
+        cell.set_exploded(false);
         LOG_DEBUG(
             "MinesweeperBoard",
             "Flag placed at (" << position.row << ',' << position.column << ")"
         );
-        return ToggleOutcome{cell, true};
+        return ToggleOutcome{cell.to_cell(position), true};
     }
 
-    cell.state = CellState::Hidden;
-    cell.exploded = false;
+    cell.set_state(CellState::Hidden);
+    cell.set_exploded(false);
     LOG_DEBUG(
         "MinesweeperBoard",
         "Flag removed at (" << position.row << ',' << position.column << ")"
     );
-    return ToggleOutcome{cell, false};
+    return ToggleOutcome{cell.to_cell(position), false};
 }
 
-const Cell& MinesweeperBoard::cell_at(Position position) const
+Cell MinesweeperBoard::cell_at(Position position) const
 {
     if (!in_bounds(position)) {
         LOG_ERROR(
@@ -184,48 +239,47 @@ const Cell& MinesweeperBoard::cell_at(Position position) const
         );
         throw std::out_of_range("Cell request outside of board bounds.");
     }
-    return cells_.at(index(position));
+    return cells_[index(position)].to_cell(position);
 }
 
-Cell& MinesweeperBoard::mutable_cell(Position position)
+std::vector<Cell> MinesweeperBoard::cells() const
 {
-    if (!in_bounds(position)) {
-        LOG_ERROR(
-            "MinesweeperBoard",
-            "Mutable cell access out of bounds at (" << position.row << ',' << position.column << ")"
-        );
-        throw std::out_of_range("Cell request outside of board bounds.");
+    std::vector<Cell> result;
+    result.reserve(cells_.size());
+    for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
+        result.push_back(cells_[idx].to_cell(position_of(idx)));
     }
-    return cells_.at(index(position));
+    return result;
 }
 
-const std::vector<Cell>& MinesweeperBoard::cells() const noexcept
+const std::vector<PackedCell>& MinesweeperBoard::packed_cells() const noexcept
 {
     return cells_;
 }
 
-std::vector<Cell> MinesweeperBoard::neighbors(Position position) const
+std::size_t MinesweeperBoard::reveal_mines(bool exploded, std::vector<Cell>& accumulator)
 {
-    std::vector<Cell> result;
-    result.reserve(8);
-
-    for (const auto& offset : kNeighborOffsets) {
-        const long neighbor_row = static_cast<long>(position.row) + offset[0];
-        const long neighbor_col = static_cast<long>(position.column) + offset[1];
-        if (neighbor_row < 0 || neighbor_col < 0) {
-            continue;
-        }
-        const Position neighbor{
-            static_cast<std::size_t>(neighbor_row),
-            static_cast<std::size_t>(neighbor_col)
-        };
-        if (!in_bounds(neighbor)) {
+    std::size_t revealed = 0;
+    for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
+        PackedCell& cell = cells_[idx];
+        if (!cell.is_mine() || cell.state() == CellState::Revealed) {
             continue;
         }
-
-        result.push_back(cells_.at(index(neighbor)));
+        cell.set_state(CellState::Revealed);
+        cell.set_exploded(exploded);
+        accumulator.push_back(cell.to_cell(position_of(idx)));
+        ++revealed;
     }
+    return revealed;
+}
 
+std::vector<Cell> MinesweeperBoard::neighbors(Position position) const
+{
+    std::vector<Cell> result;
+    result.reserve(8);
+    for_each_neighbor(index(position), [&](std::size_t neighbor_index) {
+        result.push_back(cells_[neighbor_index].to_cell(position_of(neighbor_index)));
+    });
     return result;
 }
 
@@ -249,8 +303,14 @@ void MinesweeperBoard::resize(std::size_t rows, std::size_t columns, std::size_t
     rows_ = rows;
     columns_ = columns;
     mine_count_ = mine_count;
-    cells_.assign(rows * columns, Cell{});
-    regenerate();
+    cells_.assign(rows * columns, PackedCell{});
+    revealed_safe_cells_ = 0;
+    if (safe_start_ == SafeStart::None) {
+        regenerate();
+    } else {
+        seed_ = next_board_seed(seed_);
+        mines_placed_ = false;
+    }
     LOG_INFO(
         "MinesweeperBoard",
         "Board resized to " << rows_ << 'x' << columns_ << " with " << mine_count_ << " mines"
@@ -259,189 +319,191 @@ void MinesweeperBoard::resize(std::size_t rows, std::size_t columns, std::size_t
 
 void MinesweeperBoard::regenerate()
 {
-    rng_.seed(std::random_device{}());
+    seed_ = next_board_seed(seed_);
+    std::fill(cells_.begin(), cells_.end(), PackedCell{});
+    revealed_safe_cells_ = 0;
     populate_board();
     LOG_DEBUG(
         "MinesweeperBoard",
-        "Board regenerated with layout shuffle - mine count " << mine_count_
+        "Board regenerated with layout shuffle - mine count " << mine_count_ << ", seed " << seed_
     );
 }
 
-void MinesweeperBoard::ensure_safe_cell(Position position)
+std::size_t MinesweeperBoard::rows() const noexcept { return rows_; }
+std::size_t MinesweeperBoard::columns() const noexcept { return columns_; }
+std::size_t MinesweeperBoard::mine_count() const noexcept { return mine_count_; }
+std::uint64_t MinesweeperBoard::seed() const noexcept { return seed_; }
+BoardGenerator MinesweeperBoard::generator() const noexcept { return generator_; }
+SafeStart MinesweeperBoard::safe_start() const noexcept { return safe_start_; }
+bool MinesweeperBoard::mines_placed() const noexcept { return mines_placed_; }
+std::size_t MinesweeperBoard::revealed_safe_cells() const noexcept { return revealed_safe_cells_; }
+std::size_t MinesweeperBoard::total_safe_cells() const noexcept { return rows_ * columns_ - mine_count_; }
+
+bool MinesweeperBoard::all_safe_cells_revealed() const noexcept
+{
+    return revealed_safe_cells_ == total_safe_cells();
+}
+
+void MinesweeperBoard::populate_board(std::span<const std::size_t> excluded)
 {
-    if (!in_bounds(position)) {
-        LOG_ERROR(
-            "MinesweeperBoard",
-            "Safe-cell request out of bounds at (" << position.row << ',' << position.column << ")"
-        );
-        throw std::out_of_range("Safe-cell request outside of board bounds.");
+    if (rows_ == 0 || columns_ == 0) {
+        LOG_CRITICAL("MinesweeperBoard", "Populate called without valid dimensions");
+        throw std::logic_error("Board dimensions must be set before population.");
     }
 
-    const std::size_t target_index = index(position);
-    Cell& target_cell = cells_.at(target_index);
-    if (!target_cell.is_mine) {
-        return;
+    for (auto& cell : cells_) {
+        cell.clear_layout();
     }
-
-    std::size_t replacement_index = cells_.size();
-    for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
-        if (!cells_[idx].is_mine) {
-            replacement_index = idx;
-            break;
-        }
+    if (generator_ == BoardGenerator::Counter) {
+        CounterRng rng(seed_);
+        place_mines(rng, excluded);
+    } else {
+        std::mt19937_64 rng(seed_);
+        place_mines(rng, excluded);
     }
 
-    if (replacement_index == cells_.size()) {
-        LOG_CRITICAL(
-            "MinesweeperBoard",
-            "Unable to relocate mine from (" << position.row << ',' << position.column
-                                            << ") - no safe cells available"
-        );
-        return;
+    for (const std::size_t mine : mine_indices_) {
+        for_each_neighbor(mine, [this](std::size_t neighbor_index) {
+            PackedCell& neighbor_cell = cells_[neighbor_index];
+            if (!neighbor_cell.is_mine()) {
+                neighbor_cell.set_adjacent_mines(neighbor_cell.adjacent_mines() + 1);
+            }
+        });
     }
 
-    const auto adjust_neighbors = [&](Position center, int delta) {
-        for (const auto& offset : kNeighborOffsets) {
-            const long neighbor_row = static_cast<long>(center.row) + offset[0];
-            const long neighbor_col = static_cast<long>(center.column) + offset[1];
-            if (neighbor_row < 0 || neighbor_col < 0) {
-                continue;
-            }
-            const Position neighbor{
-                static_cast<std::size_t>(neighbor_row),
-                static_cast<std::size_t>(neighbor_col)
-            };
-            if (!in_bounds(neighbor)) {
-                continue;
-            }
+    mines_placed_ = true;
+    LOG_DEBUG(
+        "MinesweeperBoard",
+        "Board population complete - " << mine_count_ << " mines distributed"
+    );
+}
 
-            Cell& neighbor_cell = cells_.at(index(neighbor));
-            if (neighbor_cell.is_mine) {
-                continue;
-            }
-            neighbor_cell.adjacent_mines += delta;
-            if (neighbor_cell.adjacent_mines < 0) {
-                neighbor_cell.adjacent_mines = 0;
+// Floyd's sampling: one draw per mine, using the board itself as the set of
+// already chosen cells, so the cost is O(mine_count) whatever the board size.
+// Draws are ranks among the cells that are not excluded.
+template <typename Generator>
+void MinesweeperBoard::place_mines(Generator& rng, std::span<const std::size_t> excluded)
+{
+    const auto cell_of_rank = [excluded](std::size_t rank) {
+        for (const std::size_t skipped : excluded) {
+            if (skipped > rank) {
+                break;
             }
+            ++rank;
         }
+        return rank;
     };
 
-    const auto recompute_adjacency = [&](Position center) {
-        int count = 0;
-        for (const auto& offset : kNeighborOffsets) {
-            const long neighbor_row = static_cast<long>(center.row) + offset[0];
-            const long neighbor_col = static_cast<long>(center.column) + offset[1];
-            if (neighbor_row < 0 || neighbor_col < 0) {
-                continue;
-            }
-            const Position neighbor{
-                static_cast<std::size_t>(neighbor_row),
-                static_cast<std::size_t>(neighbor_col)
-            };
-            if (!in_bounds(neighbor)) {
-                continue;
-            }
-            if (cells_.at(index(neighbor)).is_mine) {
-                ++count;
-            }
+    const std::size_t candidates = cells_.size() - excluded.size();
+    mine_indices_.clear();
+    mine_indices_.reserve(mine_count_);
+    for (std::size_t upper = candidates - mine_count_; upper < candidates; ++upper) {
+        std::size_t candidate = cell_of_rank(std::uniform_int_distribution<std::size_t>(0, upper)(rng));
+        if (cells_[candidate].is_mine()) {
+            candidate = cell_of_rank(upper);
         }
-        return count;
-    };
-
-    const Position replacement_position = cells_.at(replacement_index).position;
-
-    adjust_neighbors(position, -1);
-
-    target_cell.is_mine = false;
-    target_cell.state = CellState::Hidden;
-    target_cell.exploded = false;
-    target_cell.adjacent_mines = recompute_adjacency(position);
-
-    adjust_neighbors(replacement_position, +1);
+        cells_[candidate].set_mine(true);
+        mine_indices_.push_back(candidate);
+    }
+}
 
-    Cell& replacement_cell = cells_.at(replacement_index);
-    replacement_cell.is_mine = true;
-    replacement_cell.adjacent_mines = 0;
-    replacement_cell.state = CellState::Hidden;
-    replacement_cell.exploded = false;
+void MinesweeperBoard::place_mines_for_first_reveal(Position position)
+{
+    std::array<std::size_t, 9> excluded {};
+    std::size_t excluded_count = 0;
+    const std::size_t target = index(position);
+    excluded[excluded_count++] = target;
+    if (safe_start_ == SafeStart::Neighborhood) {
+        for_each_neighbor(target, [&](std::size_t neighbor_index) { excluded[excluded_count++] = neighbor_index; });
+        if (cells_.size() - excluded_count < mine_count_) {
+            LOG_DEBUG(
+                "MinesweeperBoard",
+                "Board too dense to keep the neighbourhood of (" << position.row << ',' << position.column
+                                                                 << ") clear - protecting the cell only"
+            );
+            excluded_count = 1;
+        }
+    }
+    std::sort(excluded.begin(), excluded.begin() + static_cast<std::ptrdiff_t>(excluded_count));
 
+    populate_board(std::span<const std::size_t>(excluded.data(), excluded_count));
     LOG_DEBUG(
         "MinesweeperBoard",
-        "Relocated mine from (" << position.row << ',' << position.column << ") to ("
-                                << replacement_position.row << ',' << replacement_position.column << ')'
+        "Mines placed around first reveal at (" << position.row << ',' << position.column << ')'
     );
 }
 
-std::size_t MinesweeperBoard::rows() const noexcept { return rows_; }
-std::size_t MinesweeperBoard::columns() const noexcept { return columns_; }
-std::size_t MinesweeperBoard::mine_count() const noexcept { return mine_count_; }
-std::size_t MinesweeperBoard::revealed_safe_cells() const noexcept { return revealed_safe_cells_; }
-std::size_t MinesweeperBoard::total_safe_cells() const noexcept { return rows_ * columns_ - mine_count_; }
-
-bool MinesweeperBoard::all_safe_cells_revealed() const noexcept
-{
-    return revealed_safe_cells_ == total_safe_cells();
-}
-
-void MinesweeperBoard::populate_board()
+void MinesweeperBoard::begin_visit_epoch()
 {
-    if (rows_ == 0 || columns_ == 0) {
-        LOG_CRITICAL("MinesweeperBoard", "Populate called without valid dimensions");
-        throw std::logic_error("Board dimensions must be set before population.");
+    if (visit_stamps_.size() != cells_.size()) {
+        visit_stamps_.assign(cells_.size(), 0);
+        visit_epoch_ = 0;
     }
-
-    std::vector<std::size_t> indices(rows_ * columns_);
-    std::iota(indices.begin(), indices.end(), 0);
-    std::shuffle(indices.begin(), indices.end(), rng_);
-
-    std::vector<bool> mine_mask(rows_ * columns_, false);
-    for (std::size_t i = 0; i < mine_count_; ++i) {
-        mine_mask[indices[i]] = true;
+    if (++visit_epoch_ == 0) {
+        std::fill(visit_stamps_.begin(), visit_stamps_.end(), 0);
+        visit_epoch_ = 1;
     }
+}
 
-    for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
-        const bool is_mine = mine_mask[idx];
-        cells_[idx] = Cell{
-            .position = Position{idx / columns_, idx % columns_},
-            .is_mine = is_mine,
-            .adjacent_mines = 0,
-            .state = CellState::Hidden,
-            .exploded = false
-        };
-    }
+// Scanline fill over the 8-connected region of unflagged zero cells
+// containing seed. Each popped seed is widened into a maximal horizontal span
+// of zero cells; the span and its one-cell border in the rows above and below
+// are revealed, and unvisited zero runs in that border become new seeds. Every
+// border cell of a zero cell is safe, so only flags stop the reveal.
+void MinesweeperBoard::reveal_span_region(std::span<const std::size_t> seeds, std::vector<Cell>& revealed)
+{
+    begin_visit_epoch();
+    const auto opens_region = [this](std::size_t idx) {
+        const PackedCell cell = cells_[idx];
+        return !cell.is_mine() && cell.adjacent_mines() == 0 && cell.state() != CellState::Flagged &&
+               visit_stamps_[idx] != visit_epoch_;
+    };
 
-    for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
-        if (!cells_[idx].is_mine) {
+    span_seeds_.assign(seeds.begin(), seeds.end());
+    while (!span_seeds_.empty()) {
+        const std::size_t current = span_seeds_.back();
+        span_seeds_.pop_back();
+        if (!opens_region(current)) {
             continue;
         }
 
-        const auto position = cells_[idx].position;
-        for (const auto& offset : kNeighborOffsets) {
-            const long neighbor_row = static_cast<long>(position.row) + offset[0];
-            const long neighbor_col = static_cast<long>(position.column) + offset[1];
-            if (neighbor_row < 0 || neighbor_col < 0) {
-                continue;
-            }
-            const Position neighbor{
-                static_cast<std::size_t>(neighbor_row),
-                static_cast<std::size_t>(neighbor_col)
-            };
-            if (!in_bounds(neighbor)) {
-                continue;
-            }
+        const std::size_t row = current / columns_;
+        const std::size_t row_begin = row * columns_;
+        std::size_t left = current;
+        while (left > row_begin && opens_region(left - 1)) {
+            --left;
+        }
+        std::size_t right = current;
+        while (right + 1 < row_begin + columns_ && opens_region(right + 1)) {
+            ++right;
+        }
+        for (std::size_t idx = left; idx <= right; ++idx) {
+            visit_stamps_[idx] = visit_epoch_;
+        }
 
-            Cell& neighbor_cell = cells_.at(index(neighbor));
-            if (!neighbor_cell.is_mine) {
-                ++neighbor_cell.adjacent_mines;
+        const std::size_t first_column = left - row_begin == 0 ? 0 : left - row_begin - 1;
+        const std::size_t last_column = std::min(right - row_begin + 1, columns_ - 1);
+        const std::size_t first_row = row == 0 ? 0 : row - 1;
+        const std::size_t last_row = std::min(row + 1, rows_ - 1);
+        for (std::size_t border_row = first_row; border_row <= last_row; ++border_row) {
+            bool in_run = false;
+            for (std::size_t column = first_column; column <= last_column; ++column) {
+                const std::size_t idx = border_row * columns_ + column;
+                PackedCell& cell = cells_[idx];
+                if (cell.state() == CellState::Hidden) {
+                    cell.set_state(CellState::Revealed);
+                    cell.set_exploded(false);
+                    ++revealed_safe_cells_;
+                    revealed.push_back(cell.to_cell(Position{border_row, column}));
+                }
+                const bool opens = border_row != row && opens_region(idx);
+                if (opens && !in_run) {
+                    span_seeds_.push_back(idx);
+                }
+                in_run = opens;
             }
         }
     }
-
-    revealed_safe_cells_ = 0;
-    LOG_DEBUG(
-        "MinesweeperBoard",
-        "Board population complete - " << mine_count_ << " mines distributed"
-    );
 }
 
 std::size_t MinesweeperBoard::index(Position position) const
@@ -456,6 +518,11 @@ std::size_t MinesweeperBoard::index(Position position) const
     return position.row * columns_ + position.column;
 }
 
+Position MinesweeperBoard::position_of(std::size_t index) const noexcept
+{
+    return Position{index / columns_, index % columns_};
+}
+
 bool MinesweeperBoard::in_bounds(Position position) const noexcept
 {
     return position.row < rows_ && position.column < columns_;
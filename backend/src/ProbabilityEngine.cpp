@@ -0,0 +1,588 @@
+#include "ProbabilityEngine.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+
+namespace clearbomb {
+
+namespace {
+// Solution counts indexed by mine total: values[i] counts the solutions with
+// offset + i mines. Zero runs at either end are never stored.
+struct Counts {
+    std::size_t offset {0};
+    std::vector<double> values;
+};
+
+void accumulate(Counts& into, const Counts& from, std::size_t shift)
+{
+    if (from.values.empty()) {
+        return;
+    }
+    const std::size_t low = from.offset + shift;
+    const std::size_t high = low + from.values.size();
+    if (into.values.empty()) {
+        into.offset = low;
+        into.values = from.values;
+        return;
+    }
+    if (low < into.offset) {
+        into.values.insert(into.values.begin(), into.offset - low, 0.0);
+        into.offset = low;
+    }
+    if (high > into.offset + into.values.size()) {
+        into.values.resize(high - into.offset, 0.0);
+    }
+    for (std::size_t i = 0; i < from.values.size(); ++i) {
+        into.values[low - into.offset + i] += from.values[i];
+    }
+}
+
+Counts convolve(const Counts& lhs, const Counts& rhs)
+{
+    Counts result;
+    if (lhs.values.empty() || rhs.values.empty()) {
+        return result;
+    }
+    result.offset = lhs.offset + rhs.offset;
+    result.values.assign(lhs.values.size() + rhs.values.size() - 1, 0.0);
+    for (std::size_t i = 0; i < lhs.values.size(); ++i) {
+        for (std::size_t j = 0; j < rhs.values.size(); ++j) {
+            result.values[i + j] += lhs.values[i] * rhs.values[j];
+        }
+    }
+    return result;
+}
+
+Counts unit_counts()
+{
+    return Counts{0, {1.0}};
+}
+
+double log_choose(std::size_t n, std::size_t k)
+{
+    return std::lgamma(static_cast<double>(n) + 1.0) - std::lgamma(static_cast<double>(k) + 1.0) -
+           std::lgamma(static_cast<double>(n - k) + 1.0);
+}
+
+struct LocalConstraint {
+    std::vector<std::size_t> vars;  // ascending positions in the sweep order
+    int mines {0};
+};
+
+// States between two consecutive cells of the sweep, keyed by the partial
+// mine sums (one byte each, in constraint id order) of the constraints that
+// have cells on both sides of the cut.
+using Layer = std::unordered_map<std::string, Counts>;
+
+class Sweep {
+public:
+    Sweep(std::size_t var_count, const std::vector<LocalConstraint>& constraints)
+        : constraints_(constraints)
+        , touching_(var_count)
+        , crossing_(var_count + 1)
+    {
+        for (std::size_t id = 0; id < constraints_.size(); ++id) {
+            const auto& vars = constraints_[id].vars;
+            for (const std::size_t var : vars) {
+                touching_[var].push_back(id);
+            }
+            for (std::size_t cut = vars.front() + 1; cut <= vars.back(); ++cut) {
+                crossing_[cut].push_back(id);
+            }
+        }
+    }
+
+    const std::vector<std::size_t>& crossing(std::size_t cut) const noexcept { return crossing_[cut]; }
+
+    // Adds to next every state of layer (the cut before var) extended by
+    // giving var the value mined, dropping states that break a constraint.
+    void advance(const Layer& layer, std::size_t var, bool mined, Layer& next) const
+    {
+        const auto& from = crossing_[var];
+        const auto& to = crossing_[var + 1];
+        const auto slot_in = [](const std::vector<std::size_t>& ids, std::size_t id) -> std::ptrdiff_t {
+            const auto it = std::lower_bound(ids.begin(), ids.end(), id);
+            return it != ids.end() && *it == id ? it - ids.begin() : -1;
+        };
+
+        struct Touch {
+            int mines;
+            int remaining;  // cells of the constraint after var
+            std::ptrdiff_t from_slot;
+            std::ptrdiff_t to_slot;
+        };
+        std::vector<Touch> touches;
+        for (const std::size_t id : touching_[var]) {
+            const auto& vars = constraints_[id].vars;
+            const auto after = vars.end() - std::upper_bound(vars.begin(), vars.end(), var);
+            touches.push_back(Touch{constraints_[id].mines, static_cast<int>(after), slot_in(from, id), slot_in(to, id)});
+        }
+        std::vector<std::pair<std::size_t, std::size_t>> carried;
+        for (std::size_t slot = 0; slot < to.size(); ++slot) {
+            if (!std::binary_search(touching_[var].begin(), touching_[var].end(), to[slot])) {
+                carried.emplace_back(static_cast<std::size_t>(slot_in(from, to[slot])), slot);
+            }
+        }
+
+        const int value = mined ? 1 : 0;
+        std::string key(to.size(), '\0');
+        for (const auto& [state, counts] : layer) {
+            for (const auto& [from_slot, to_slot] : carried) {
+                key[to_slot] = state[from_slot];
+            }
+            bool consistent = true;
+            for (const Touch& touch : touches) {
+                const int sum = (touch.from_slot >= 0 ? state[static_cast<std::size_t>(touch.from_slot)] : 0) + value;
+                if (touch.to_slot < 0) {
+                    consistent = sum == touch.mines;
+                } else {
+                    consistent = sum <= touch.mines && sum + touch.remaining >= touch.mines;
+                    key[static_cast<std::size_t>(touch.to_slot)] = static_cast<char>(sum);
+                }
+                if (!consistent) {
+                    break;
+                }
+            }
+            if (consistent) {
+                accumulate(next[key], counts, mined ? 1 : 0);
+            }
+        }
+    }
+
+private:
+    const std::vector<LocalConstraint>& constraints_;
+    std::vector<std::vector<std::size_t>> touching_;  // constraint ids per var, ascending
+    std::vector<std::vector<std::size_t>> crossing_;  // constraint ids per cut, ascending
+};
+
+struct ComponentCounts {
+    Counts totals;
+    std::vector<Counts> mined;  // per var: solutions with that var mined
+};
+
+// Counts the solutions of one component. Returns false when a layer grows
+// past max_states.
+bool count_component(
+    std::size_t var_count,
+    const std::vector<LocalConstraint>& constraints,
+    std::size_t max_states,
+    ComponentCounts& out
+)
+{
+    // The backward pass is the forward pass over the reversed order; its
+    // layer k covers the last k vars and shares the crossing constraints of
+    // forward cut var_count - k.
+    std::vector<LocalConstraint> reversed = constraints;
+    for (auto& constraint : reversed) {
+        for (auto& var : constraint.vars) {
+            var = var_count - 1 - var;
+        }
+        std::reverse(constraint.vars.begin(), constraint.vars.end());
+    }
+    const Sweep forward(var_count, constraints);
+    const Sweep backward(var_count, reversed);
+
+    std::vector<Layer> suffixes(var_count + 1);
+    suffixes[0].emplace(std::string(), unit_counts());
+    for (std::size_t k = 0; k < var_count; ++k) {
+        backward.advance(suffixes[k], k, false, suffixes[k + 1]);
+        backward.advance(suffixes[k], k, true, suffixes[k + 1]);
+        if (suffixes[k + 1].size() > max_states) {
+            return false;
+        }
+    }
+
+    out.mined.assign(var_count, Counts{});
+    Layer prefix;
+    prefix.emplace(std::string(), unit_counts());
+    std::string wanted;
+    for (std::size_t var = 0; var < var_count; ++var) {
+        Layer with_mine;
+        forward.advance(prefix, var, true, with_mine);
+
+        // A prefix state joins the suffix states whose sums complete every
+        // crossing constraint.
+        const auto& crossing = forward.crossing(var + 1);
+        const Layer& suffix = suffixes[var_count - var - 1];
+        for (const auto& [state, counts] : with_mine) {
+            wanted.assign(state.size(), '\0');
+            for (std::size_t slot = 0; slot < state.size(); ++slot) {
+                wanted[slot] = static_cast<char>(constraints[crossing[slot]].mines - state[slot]);
+            }
+            const auto match = suffix.find(wanted);
+            if (match != suffix.end()) {
+                accumulate(out.mined[var], convolve(counts, match->second), 0);
+            }
+        }
+
+        Layer next;
+        forward.advance(prefix, var, false, next);
+        for (const auto& [state, counts] : with_mine) {
+            accumulate(next[state], counts, 0);
+        }
+        if (next.size() > max_states) {
+            return false;
+        }
+        prefix = std::move(next);
+    }
+
+    const auto complete = prefix.find(std::string());
+    if (complete != prefix.end()) {
+        out.totals = complete->second;
+    }
+    return true;
+}
+
+// Orders a component's vars so that few constraints straddle any cut. Each
+// step takes, among the vars touching a constraint that is already open, the
+// one that opens the fewest new constraints net of those it closes.
+// placed_in (per constraint) and queued (per var) are scratch shared by all
+// components; components are disjoint, so they never need clearing.
+std::vector<std::size_t> sweep_order(
+    const std::vector<std::size_t>& vars,
+    const std::vector<LocalConstraint>& constraints,
+    const std::vector<std::vector<std::size_t>>& constraints_of,
+    std::vector<std::size_t>& placed_in,
+    std::vector<bool>& queued
+)
+{
+    std::vector<std::size_t> order;
+    order.reserve(vars.size());
+    std::vector<std::size_t> candidates;
+    const auto score = [&](std::size_t var) {
+        int opened = 0;
+        for (const std::size_t id : constraints_of[var]) {
+            const std::size_t placed = placed_in[id];
+            const std::size_t size = constraints[id].vars.size();
+            opened += placed == 0 && size > 1 ? 1 : 0;
+            opened -= placed + 1 == size ? 1 : 0;
+        }
+        return opened;
+    };
+
+    // Start from the var in the fewest constraints, usually an end of the
+    // frontier.
+    std::size_t next = *std::min_element(vars.begin(), vars.end(), [&](std::size_t lhs, std::size_t rhs) {
+        return constraints_of[lhs].size() < constraints_of[rhs].size();
+    });
+    queued[next] = true;
+    while (true) {
+        order.push_back(next);
+        for (const std::size_t id : constraints_of[next]) {
+            if (placed_in[id]++ == 0) {
+                for (const std::size_t other : constraints[id].vars) {
+                    if (!queued[other]) {
+                        queued[other] = true;
+                        candidates.push_back(other);
+                    }
+                }
+            }
+        }
+        if (candidates.empty()) {
+            break;
+        }
+        std::size_t best = 0;
+        int best_score = score(candidates[0]);
+        for (std::size_t i = 1; i < candidates.size() && best_score > -1; ++i) {
+            const int candidate_score = score(candidates[i]);
+            if (candidate_score < best_score) {
+                best = i;
+                best_score = candidate_score;
+            }
+        }
+        next = candidates[best];
+        candidates.erase(candidates.begin() + static_cast<std::ptrdiff_t>(best));
+    }
+    return order;
+}
+
+std::size_t find_root(std::vector<std::size_t>& parents, std::size_t var)
+{
+    while (parents[var] != var) {
+        parents[var] = parents[parents[var]];
+        var = parents[var];
+    }
+    return var;
+}
+}  // namespace
+
+ProbabilityEngine::ProbabilityEngine(std::size_t max_states_per_cut) noexcept
+    : max_states_per_cut_(max_states_per_cut)
+{}
+
+ProbabilityMap ProbabilityEngine::compute(const MinesweeperBoard& board) const
+{
+    const auto& packed = board.packed_cells();
+    const std::size_t columns = board.columns();
+    ProbabilityMap result;
+
+    const auto is_known_mine = [](PackedCell cell) {
+        return cell.state() == CellState::Flagged || (cell.state() == CellState::Revealed && cell.is_mine());
+    };
+
+    // Frontier vars are numbered in row-major order of first appearance.
+    constexpr std::size_t kNoVar = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> var_of(packed.size(), kNoVar);
+    std::vector<std::size_t> frontier;
+    std::vector<LocalConstraint> constraints;
+    std::size_t known_mines = 0;
+    std::size_t hidden_cells = 0;
+    for (std::size_t idx = 0; idx < packed.size(); ++idx) {
+        const PackedCell cell = packed[idx];
+        known_mines += is_known_mine(cell) ? 1 : 0;
+        hidden_cells += cell.state() == CellState::Hidden ? 1 : 0;
+        if (cell.state() != CellState::Revealed || cell.is_mine()) {
+            continue;
+        }
+        LocalConstraint constraint;
+        constraint.mines = cell.adjacent_mines();
+        board.for_each_neighbor(idx, [&](std::size_t neighbor) {
+            const PackedCell neighbor_cell = packed[neighbor];
+            if (is_known_mine(neighbor_cell)) {
+                --constraint.mines;
+            } else if (neighbor_cell.state() == CellState::Hidden) {
+                if (var_of[neighbor] == kNoVar) {
+                    var_of[neighbor] = frontier.size();
+                    frontier.push_back(neighbor);
+                }
+                constraint.vars.push_back(var_of[neighbor]);
+            }
+        });
+        if (constraint.mines < 0 || constraint.mines > static_cast<int>(constraint.vars.size())) {
+            result.status = ProbabilityStatus::Inconsistent;
+            return result;
+        }
+        if (!constraint.vars.empty()) {
+            constraints.push_back(std::move(constraint));
+        }
+    }
+    if (known_mines > board.mine_count()) {
+        result.status = ProbabilityStatus::Inconsistent;
+        return result;
+    }
+
+    // Constraints with k == 0 or k == size settle their cells outright.
+    // Fixing those first and substituting them back cuts most frontiers into
+    // small pieces before anything is counted.
+    constexpr signed char kUnsettled = -1;
+    std::vector<signed char> settled(frontier.size(), kUnsettled);
+    for (bool progress = true; progress;) {
+        progress = false;
+        for (const auto& constraint : constraints) {
+            int mines = constraint.mines;
+            int unknown = 0;
+            for (const std::size_t var : constraint.vars) {
+                mines -= settled[var] == 1 ? 1 : 0;
+                unknown += settled[var] == kUnsettled ? 1 : 0;
+            }
+            if (mines < 0 || mines > unknown) {
+                result.status = ProbabilityStatus::Inconsistent;
+                return result;
+            }
+            if (unknown > 0 && (mines == 0 || mines == unknown)) {
+                for (const std::size_t var : constraint.vars) {
+                    if (settled[var] == kUnsettled) {
+                        settled[var] = mines == 0 ? 0 : 1;
+                    }
+                }
+                progress = true;
+            }
+        }
+    }
+    std::size_t settled_mines = 0;
+    for (const signed char value : settled) {
+        settled_mines += value == 1 ? 1 : 0;
+    }
+    std::erase_if(constraints, [&](LocalConstraint& constraint) {
+        std::erase_if(constraint.vars, [&](std::size_t var) {
+            constraint.mines -= settled[var] == 1 ? 1 : 0;
+            return settled[var] != kUnsettled;
+        });
+        return constraint.vars.empty();
+    });
+
+    // Components: vars linked by a shared constraint.
+    std::vector<std::size_t> parents(frontier.size());
+    std::iota(parents.begin(), parents.end(), std::size_t{0});
+    for (const auto& constraint : constraints) {
+        for (const std::size_t var : constraint.vars) {
+            parents[find_root(parents, var)] = find_root(parents, constraint.vars.front());
+        }
+    }
+    std::vector<std::vector<std::size_t>> constraints_of(frontier.size());
+    for (std::size_t id = 0; id < constraints.size(); ++id) {
+        for (const std::size_t var : constraints[id].vars) {
+            constraints_of[var].push_back(id);
+        }
+    }
+
+    struct Component {
+        std::vector<std::size_t> vars;  // frontier vars in sweep order
+        std::vector<std::size_t> constraints;
+        ComponentCounts counts;
+    };
+    std::vector<Component> components;
+    std::vector<std::size_t> component_of(frontier.size(), kNoVar);
+    for (std::size_t var = 0; var < frontier.size(); ++var) {
+        if (settled[var] != kUnsettled) {
+            continue;
+        }
+        const std::size_t root = find_root(parents, var);
+        if (component_of[root] == kNoVar) {
+            component_of[root] = components.size();
+            components.emplace_back();
+        }
+        components[component_of[root]].vars.push_back(var);
+    }
+    for (std::size_t id = 0; id < constraints.size(); ++id) {
+        components[component_of[find_root(parents, constraints[id].vars.front())]].constraints.push_back(id);
+    }
+
+    std::vector<std::size_t> placed_in(constraints.size(), 0);
+    std::vector<bool> queued(frontier.size(), false);
+    std::vector<std::size_t> position_of(frontier.size(), kNoVar);
+    for (auto& component : components) {
+        component.vars = sweep_order(component.vars, constraints, constraints_of, placed_in, queued);
+        for (std::size_t position = 0; position < component.vars.size(); ++position) {
+            position_of[component.vars[position]] = position;
+        }
+
+        std::vector<LocalConstraint> local;
+        local.reserve(component.constraints.size());
+        for (const std::size_t id : component.constraints) {
+            LocalConstraint constraint{{}, constraints[id].mines};
+            for (const std::size_t var : constraints[id].vars) {
+                constraint.vars.push_back(position_of[var]);
+            }
+            std::sort(constraint.vars.begin(), constraint.vars.end());
+            local.push_back(std::move(constraint));
+        }
+
+        if (!count_component(component.vars.size(), local, max_states_per_cut_, component.counts)) {
+            LOG_WARNING(
+                "ProbabilityEngine",
+                "Frontier component of " << component.vars.size() << " cell(s) exceeded " << max_states_per_cut_
+                                         << " states"
+            );
+            result.status = ProbabilityStatus::TooComplex;
+            return result;
+        }
+        if (component.counts.totals.values.empty()) {
+            result.status = ProbabilityStatus::Inconsistent;
+            return result;
+        }
+        // Only ratios matter, so each component is scaled to keep products
+        // of many components within double range.
+        const double scale =
+            *std::max_element(component.counts.totals.values.begin(), component.counts.totals.values.end());
+        for (auto& value : component.counts.totals.values) {
+            value /= scale;
+        }
+        for (auto& mined : component.counts.mined) {
+            for (auto& value : mined.values) {
+                value /= scale;
+            }
+        }
+    }
+
+    // Frontier totals, and for each component the totals of all the others.
+    std::vector<Counts> prefix_products{unit_counts()};
+    for (const auto& component : components) {
+        prefix_products.push_back(convolve(prefix_products.back(), component.counts.totals));
+    }
+    std::vector<Counts> suffix_products(components.size() + 1, unit_counts());
+    for (std::size_t j = components.size(); j-- > 0;) {
+        suffix_products[j] = convolve(components[j].counts.totals, suffix_products[j + 1]);
+    }
+    const Counts& frontier_totals = prefix_products.back();
+
+    if (known_mines + settled_mines > board.mine_count()) {
+        result.status = ProbabilityStatus::Inconsistent;
+        return result;
+    }
+    const std::size_t remaining = board.mine_count() - known_mines - settled_mines;
+    const std::size_t unconstrained = hidden_cells - frontier.size();
+    // weights[i]: ways to place the remaining mines off the frontier when it
+    // holds frontier_totals.offset + i of them, relative to the largest.
+    std::vector<double> log_weights(frontier_totals.values.size(), -std::numeric_limits<double>::infinity());
+    for (std::size_t i = 0; i < log_weights.size(); ++i) {
+        const std::size_t frontier_mines = frontier_totals.offset + i;
+        if (frontier_mines <= remaining && remaining - frontier_mines <= unconstrained) {
+            log_weights[i] = log_choose(unconstrained, remaining - frontier_mines);
+        }
+    }
+    const double max_log_weight = *std::max_element(log_weights.begin(), log_weights.end());
+    if (!std::isfinite(max_log_weight)) {
+        result.status = ProbabilityStatus::Inconsistent;
+        return result;
+    }
+    std::vector<double> weights(log_weights.size());
+    double total_weight = 0.0;
+    double unconstrained_mines = 0.0;
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        weights[i] = std::exp(log_weights[i] - max_log_weight);
+        const double layouts = frontier_totals.values[i] * weights[i];
+        total_weight += layouts;
+        if (layouts > 0.0) {
+            unconstrained_mines += layouts * static_cast<double>(remaining - frontier_totals.offset - i);
+        }
+    }
+    if (total_weight <= 0.0) {
+        result.status = ProbabilityStatus::Inconsistent;
+        return result;
+    }
+
+    std::vector<double> var_probability(frontier.size(), 0.0);
+    for (std::size_t var = 0; var < frontier.size(); ++var) {
+        var_probability[var] = settled[var] == 1 ? 1.0 : 0.0;
+    }
+    for (std::size_t j = 0; j < components.size(); ++j) {
+        const Counts others = convolve(prefix_products[j], suffix_products[j + 1]);
+        const Counts& totals = components[j].counts.totals;
+        // completion[m]: weight of everything outside component j given that
+        // it holds totals.offset + m mines.
+        std::vector<double> completion(totals.values.size(), 0.0);
+        for (std::size_t m = 0; m < completion.size(); ++m) {
+            for (std::size_t k = 0; k < others.values.size(); ++k) {
+                const std::size_t frontier_mines = totals.offset + m + others.offset + k;
+                completion[m] += others.values[k] * weights[frontier_mines - frontier_totals.offset];
+            }
+        }
+        const auto& vars = components[j].vars;
+        for (std::size_t position = 0; position < vars.size(); ++position) {
+            const Counts& mined = components[j].counts.mined[position];
+            double weight = 0.0;
+            for (std::size_t i = 0; i < mined.values.size(); ++i) {
+                weight += mined.values[i] * completion[mined.offset + i - totals.offset];
+            }
+            var_probability[vars[position]] = std::clamp(weight / total_weight, 0.0, 1.0);
+        }
+    }
+    const double unconstrained_probability =
+        unconstrained == 0 ? 0.0
+                           : std::clamp(unconstrained_mines / (total_weight * static_cast<double>(unconstrained)), 0.0, 1.0);
+
+    result.cells.reserve(hidden_cells);
+    for (std::size_t idx = 0; idx < packed.size(); ++idx) {
+        if (packed[idx].state() != CellState::Hidden) {
+            continue;
+        }
+        const double probability = var_of[idx] == kNoVar ? unconstrained_probability : var_probability[var_of[idx]];
+        result.cells.push_back(CellProbability{Position{idx / columns, idx % columns}, probability});
+    }
+    result.frontier_cells = frontier.size();
+    result.components = components.size();
+    LOG_DEBUG(
+        "ProbabilityEngine",
+        "Computed probabilities for " << result.cells.size() << " hidden cell(s) - frontier "
+                                      << result.frontier_cells << " in " << result.components << " component(s)"
+    );
+    return result;
+}
+
+}  // namespace clearbomb
@@ -0,0 +1,157 @@
+#include "SessionRegistry.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace clearbomb {
+
+SessionRegistry::Lease::Lease(std::shared_ptr<Session> session)
+    : session_(std::move(session))
+    , lock_(session_->mutex)
+{
+    if (!session_->engine) {
+        session_->engine = std::make_unique<GameEngine>();
+    }
+}
+
+SessionRegistry::Lease& SessionRegistry::Lease::operator=(Lease&& other) noexcept
+{
+    if (this != &other) {
+        lock_ = std::move(other.lock_);
+        session_ = std::move(other.session_);
+    }
+    return *this;
+}
+
+SessionRegistry::SessionRegistry(SessionRegistryOptions options)
+    : options_(options)
+    , shards_(std::max<std::size_t>(options.shard_count, 1))
+{
+    options_.shard_count = shards_.size();
+    if (options_.max_sessions_per_shard == 0) {
+        throw std::invalid_argument("SessionRegistry requires room for at least one session per shard.");
+    }
+    LOG_INFO(
+        "SessionRegistry",
+        "Configured " << options_.shard_count << " shard(s), " << options_.max_sessions_per_shard
+                      << " session(s) per shard, idle timeout " << options_.idle_timeout.count() << " s"
+    );
+}
+
+SessionRegistry::Lease SessionRegistry::acquire(std::string_view session_id)
+{
+    if (!is_valid_session_id(session_id)) {
+        throw std::invalid_argument("Session id must be 1-64 characters of [A-Za-z0-9_-].");
+    }
+
+    Shard& shard = shard_for(session_id);
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        auto it = shard.sessions.find(std::string(session_id));
+        if (it == shard.sessions.end()) {
+            while (shard.sessions.size() >= options_.max_sessions_per_shard) {
+                if (!evict_least_recent(shard)) {
+                    LOG_WARNING(
+                        "SessionRegistry",
+                        "Every session in the shard is leased - admitting '" << session_id << "' over the limit"
+                    );
+                    break;
+                }
+            }
+            it = shard.sessions.emplace(std::string(session_id), std::make_shared<Session>()).first;
+            LOG_INFO("SessionRegistry", "Created session '" << session_id << "'");
+        }
+        it->second->last_access = std::chrono::steady_clock::now();
+        session = it->second;
+    }
+
+    // The engine is built (or locked) outside the shard mutex so a slow board
+    // generation never blocks lookups for unrelated sessions.
+    return Lease(std::move(session));
+}
+
+std::size_t SessionRegistry::evict_idle()
+{
+    const auto cutoff = std::chrono::steady_clock::now() - options_.idle_timeout;
+    std::size_t evicted = 0;
+
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        for (auto it = shard.sessions.begin(); it != shard.sessions.end();) {
+            if (it->second->last_access < cutoff && !is_leased(it->second)) {
+                LOG_DEBUG("SessionRegistry", "Evicting idle session '" << it->first << "'");
+                it = shard.sessions.erase(it);
+                ++evicted;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (evicted > 0) {
+        LOG_INFO("SessionRegistry", "Evicted " << evicted << " idle session(s)");
+    }
+    return evicted;
+}
+
+std::size_t SessionRegistry::size() const
+{
+    std::size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        total += shard.sessions.size();
+    }
+    return total;
+}
+
+const SessionRegistryOptions& SessionRegistry::options() const noexcept
+{
+    return options_;
+}
+
+bool SessionRegistry::is_valid_session_id(std::string_view session_id) noexcept
+{
+    if (session_id.empty() || session_id.size() > kMaxSessionIdLength) {
+        return false;
+    }
+    return std::all_of(session_id.begin(), session_id.end(), [](char ch) {
+        return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '-' ||
+               ch == '_';
+    });
+}
+
+SessionRegistry::Shard& SessionRegistry::shard_for(std::string_view session_id)
+{
+    const std::size_t hash = std::hash<std::string_view>{}(session_id);
+    return shards_[hash % shards_.size()];
+}
+
+bool SessionRegistry::is_leased(const std::shared_ptr<Session>& session) noexcept
+{
+    // The shard holds one reference; any other belongs to a lease, or to an
+    // acquire about to take one. New references are only handed out under the
+    // shard mutex, so an unleased session cannot become leased while we look.
+    return session.use_count() > 1;
+}
+
+bool SessionRegistry::evict_least_recent(Shard& shard)
+{
+    auto oldest = shard.sessions.end();
+    for (auto it = shard.sessions.begin(); it != shard.sessions.end(); ++it) {
+        if (!is_leased(it->second) &&
+            (oldest == shard.sessions.end() || it->second->last_access < oldest->second->last_access)) {
+            oldest = it;
+        }
+    }
+    if (oldest == shard.sessions.end()) {
+        return false;
+    }
+    LOG_WARNING("SessionRegistry", "Shard full - evicting least recently used session '" << oldest->first << "'");
+    shard.sessions.erase(oldest);
+    return true;
+}
+
+}  // namespace clearbomb
@@ -0,0 +1,180 @@
+#include "WebSocket.hpp"
+#include "Base64.hpp"
+
+#include <array>
+
+namespace clearbomb {
+
+namespace {
+constexpr std::string_view kHandshakeGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+constexpr std::size_t kMaxControlPayload = 125;
+
+constexpr std::uint32_t rotate_left(std::uint32_t value, int bits) noexcept
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// Only ever hashes a handshake key, so a straightforward implementation is
+// plenty.
+std::array<std::uint8_t, 20> sha1(std::string_view input)
+{
+    std::array<std::uint32_t, 5> state{0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U, 0xC3D2E1F0U};
+
+    std::string message(input);
+    const std::uint64_t bit_length = static_cast<std::uint64_t>(input.size()) * 8;
+    message.push_back(static_cast<char>(0x80));
+    while (message.size() % 64 != 56) {
+        message.push_back('\0');
+    }
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        message.push_back(static_cast<char>((bit_length >> shift) & 0xffU));
+    }
+
+    for (std::size_t block = 0; block < message.size(); block += 64) {
+        std::array<std::uint32_t, 80> words{};
+        for (std::size_t i = 0; i < 16; ++i) {
+            for (std::size_t byte = 0; byte < 4; ++byte) {
+                words[i] = (words[i] << 8) | static_cast<std::uint8_t>(message[block + i * 4 + byte]);
+            }
+        }
+        for (std::size_t i = 16; i < 80; ++i) {
+            words[i] = rotate_left(words[i - 3] ^ words[i - 8] ^ words[i - 14] ^ words[i - 16], 1);
+        }
+
+        auto [a, b, c, d, e] = state;
+        for (std::size_t i = 0; i < 80; ++i) {
+            std::uint32_t f = 0;
+            std::uint32_t k = 0;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999U;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1U;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDCU;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6U;
+            }
+            const std::uint32_t next = rotate_left(a, 5) + f + e + k + words[i];
+            e = d;
+            d = c;
+            c = rotate_left(b, 30);
+            b = a;
+            a = next;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+
+    std::array<std::uint8_t, 20> digest{};
+    for (std::size_t i = 0; i < 20; ++i) {
+        digest[i] = static_cast<std::uint8_t>(state[i / 4] >> (24 - 8 * (i % 4)));
+    }
+    return digest;
+}
+
+bool is_known_opcode(unsigned opcode) noexcept
+{
+    return opcode <= 0x2 || (opcode >= 0x8 && opcode <= 0xA);
+}
+}  // namespace
+
+std::string websocket_accept_key(std::string_view client_key)
+{
+    std::string input(client_key);
+    input.append(kHandshakeGuid);
+    const auto digest = sha1(input);
+    return base64_encode(std::string_view(reinterpret_cast<const char*>(digest.data()), digest.size()));
+}
+
+WebSocketParseResult parse_websocket_frame(std::string_view buffer, std::size_t max_payload, WebSocketFrame& frame)
+{
+    constexpr WebSocketParseResult incomplete{WebSocketParseStatus::Incomplete, 0};
+    constexpr WebSocketParseResult invalid{WebSocketParseStatus::Invalid, 0};
+
+    if (buffer.size() < 2) {
+        return incomplete;
+    }
+    const auto first = static_cast<std::uint8_t>(buffer[0]);
+    const auto second = static_cast<std::uint8_t>(buffer[1]);
+    const unsigned opcode = first & 0x0fU;
+    if ((first & 0x70U) != 0 || !is_known_opcode(opcode) || (second & 0x80U) == 0) {
+        return invalid;
+    }
+    const bool fin = (first & 0x80U) != 0;
+    const bool control = opcode >= 0x8;
+
+    std::size_t offset = 2;
+    std::uint64_t length = second & 0x7fU;
+    if (length >= 126) {
+        const std::size_t extended = length == 126 ? 2 : 8;
+        if (buffer.size() < offset + extended) {
+            return incomplete;
+        }
+        length = 0;
+        for (std::size_t i = 0; i < extended; ++i) {
+            length = (length << 8) | static_cast<std::uint8_t>(buffer[offset + i]);
+        }
+        offset += extended;
+        if ((length >> 63) != 0) {
+            return invalid;
+        }
+    }
+    if (control && (!fin || length > kMaxControlPayload)) {
+        return invalid;
+    }
+    if (length > max_payload) {
+        return WebSocketParseResult{WebSocketParseStatus::TooLarge, 0};
+    }
+
+    const std::size_t payload_size = static_cast<std::size_t>(length);
+    if (buffer.size() < offset + 4 + payload_size) {
+        return incomplete;
+    }
+    const std::string_view mask = buffer.substr(offset, 4);
+    offset += 4;
+
+    frame.fin = fin;
+    frame.opcode = static_cast<WebSocketOpcode>(opcode);
+    frame.payload.assign(buffer.substr(offset, payload_size));
+    for (std::size_t i = 0; i < payload_size; ++i) {
+        frame.payload[i] = static_cast<char>(frame.payload[i] ^ mask[i % 4]);
+    }
+    return WebSocketParseResult{WebSocketParseStatus::Complete, offset + payload_size};
+}
+
+void append_websocket_frame(std::string& out, WebSocketOpcode opcode, std::string_view payload)
+{
+    out.push_back(static_cast<char>(0x80U | static_cast<unsigned>(opcode)));
+    const std::size_t size = payload.size();
+    if (size < 126) {
+        out.push_back(static_cast<char>(size));
+    } else if (size <= 0xffff) {
+        out.push_back(static_cast<char>(126));
+        out.push_back(static_cast<char>((size >> 8) & 0xffU));
+        out.push_back(static_cast<char>(size & 0xffU));
+    } else {
+        out.push_back(static_cast<char>(127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<char>((static_cast<std::uint64_t>(size) >> shift) & 0xffU));
+        }
+    }
+    out.append(payload);
+}
+
+std::string websocket_close_payload(std::uint16_t code, std::string_view reason)
+{
+    std::string payload;
+    payload.push_back(static_cast<char>(code >> 8));
+    payload.push_back(static_cast<char>(code & 0xffU));
+    payload.append(reason.substr(0, kMaxControlPayload - 2));
+    return payload;
+}
+
+}  // namespace clearbomb
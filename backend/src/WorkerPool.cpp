@@ -0,0 +1,92 @@
+#include "WorkerPool.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace clearbomb {
+
+WorkerPool::WorkerPool(std::size_t thread_count, std::size_t queue_capacity)
+    : queue_capacity_(std::max<std::size_t>(queue_capacity, 1))
+{
+    const std::size_t count = std::max<std::size_t>(thread_count, 1);
+    threads_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        threads_.emplace_back(&WorkerPool::worker_loop, this);
+    }
+    LOG_INFO("WorkerPool", "Started " << count << " worker(s) with queue capacity " << queue_capacity_);
+}
+
+WorkerPool::~WorkerPool()
+{
+    shutdown();
+}
+
+bool WorkerPool::try_submit(Job job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || jobs_.size() >= queue_capacity_) {
+            return false;
+        }
+        jobs_.push_back(std::move(job));
+    }
+    available_.notify_one();
+    return true;
+}
+
+void WorkerPool::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    available_.notify_all();
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    LOG_INFO("WorkerPool", "All workers stopped");
+}
+
+std::size_t WorkerPool::thread_count() const noexcept
+{
+    return threads_.size();
+}
+
+std::size_t WorkerPool::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size();
+}
+
+void WorkerPool::worker_loop()
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        try {
+            job();
+        } catch (const std::exception& error) {
+            LOG_ERROR("WorkerPool", "Job failed with exception: " << error.what());
+        } catch (...) {
+            LOG_ERROR("WorkerPool", "Job failed with unknown exception");
+        }
+    }
+}
+
+}  // namespace clearbomb
@@ -1,6 +1,8 @@
 #include "ApiServer.hpp"
-#include "GameEngine.hpp"
 #include "Logger.hpp"
+#include "SessionRegistry.hpp"
+
+#include <sys/resource.h>
 
 #include <chrono>
 #include <filesystem>
@@ -8,6 +10,22 @@
 #include <memory>
 #include <thread>
 
+namespace {
+// Each idle keep-alive client costs one descriptor, so lift the soft limit to
+// the hard limit instead of the usual 1024 default.
+void raise_descriptor_limit()
+{
+    rlimit limit {};
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur >= limit.rlim_max) {
+        return;
+    }
+    limit.rlim_cur = limit.rlim_max;
+    if (setrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        LOG_INFO("Application", "Raised open file limit to " << limit.rlim_cur);
+    }
+}
+}  // namespace
+
 int main(int argc, char* argv[])
 {
     using namespace clearbomb;
@@ -23,6 +41,9 @@ int main(int argc, char* argv[])
         LOG_WARNING("Application", "Unable to configure file logging: " << error.what());
     }
 
+    // Keep console and file I/O off the request path.
+    logger.start_async();
+
     unsigned short port = 8080;
     if (argc > 1) {
         try {
@@ -36,8 +57,13 @@ int main(int argc, char* argv[])
         }
     }
 
-    auto engine = std::make_shared<GameEngine>();
-    ApiServer server{engine, port};
+    raise_descriptor_limit();
+
+    ApiServerOptions options;
+    options.port = port;
+
+    auto sessions = std::make_shared<SessionRegistry>();
+    ApiServer server{sessions, options};
 
     server.start();
     LOG_INFO("Application", "Clear Bomb server running on port " << port);
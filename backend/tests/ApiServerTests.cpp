@@ -0,0 +1,159 @@
+#include "ApiServer.hpp"
+#include "Logger.hpp"
+#include "SessionRegistry.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace {
+struct Reply {
+    int status {0};
+    std::string head;
+    std::string body;
+
+    std::optional<std::string> header(std::string_view name) const
+    {
+        const std::string key = "\r\n" + std::string(name) + ": ";
+        const auto start = head.find(key);
+        if (start == std::string::npos) {
+            return std::nullopt;
+        }
+        const auto value = start + key.size();
+        return head.substr(value, head.find("\r\n", value) - value);
+    }
+};
+
+// One request per connection, read until the server closes it.
+Reply exchange(unsigned short port, const std::string& request)
+{
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    assert(fd >= 0);
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    const int connected = ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    assert(connected == 0);
+
+    std::size_t sent = 0;
+    while (sent < request.size()) {
+        const auto written = ::send(fd, request.data() + sent, request.size() - sent, 0);
+        assert(written > 0);
+        sent += static_cast<std::size_t>(written);
+    }
+    std::string raw;
+    char buffer[4096];
+    ssize_t received = 0;
+    while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        raw.append(buffer, static_cast<std::size_t>(received));
+    }
+    ::close(fd);
+
+    Reply reply;
+    const auto split = raw.find("\r\n\r\n");
+    assert(split != std::string::npos);
+    reply.head = raw.substr(0, split + 2);
+    reply.body = raw.substr(split + 4);
+    reply.status = std::stoi(raw.substr(9, 3));
+    return reply;
+}
+
+std::string get_board(const std::string& extra_headers)
+{
+    return "GET /api/board HTTP/1.1\r\nHost: test\r\nX-Session-Id: compression\r\nConnection: close\r\n" +
+           extra_headers + "\r\n";
+}
+
+// A threshold of zero would compress any body, which is exactly when an
+// empty 204 or 304 must still be left alone.
+void test_conditional_get_with_gzip(unsigned short port)
+{
+    const Reply first = exchange(port, get_board("Accept-Encoding: gzip\r\n"));
+    assert(first.status == 200);
+    assert(first.header("Content-Encoding") == std::string("gzip"));
+    const auto etag = first.header("ETag");
+    assert(etag && etag->starts_with("W/\""));
+    assert(first.header("Content-Length") == std::to_string(first.body.size()));
+
+    // Served from the session's cache until the board changes.
+    const Reply again = exchange(port, get_board("Accept-Encoding: gzip\r\n"));
+    assert(again.body == first.body && again.header("ETag") == etag);
+
+    const Reply unchanged = exchange(port, get_board("Accept-Encoding: gzip\r\nIf-None-Match: " + *etag + "\r\n"));
+    assert(unchanged.status == 304);
+    assert(unchanged.body.empty());
+    assert(unchanged.header("Content-Length") == std::string("0"));
+    assert(!unchanged.header("Content-Encoding"));
+    assert(unchanged.header("ETag") == etag);
+
+    const Reply identity = exchange(port, get_board("If-None-Match: " + *etag + "\r\n"));
+    assert(identity.status == 304 && identity.body.empty());
+    assert(identity.header("ETag") == etag->substr(2));
+}
+
+// A JSON delta must not go out under the snapshot's tag, least of all the
+// compact snapshot's.
+void test_delta_has_its_own_etag(unsigned short port)
+{
+    const std::string session = "X-Session-Id: delta\r\nConnection: close\r\n";
+    const Reply snapshot = exchange(port, "GET /api/board HTTP/1.1\r\nHost: test\r\n" + session + "\r\n");
+    const auto version_at = snapshot.body.find("\"version\":") + 10;
+    const std::string since = snapshot.body.substr(version_at, snapshot.body.find_first_of(",}", version_at) - version_at);
+
+    const std::string move = "{\"row\":0,\"column\":0}";
+    const Reply flagged = exchange(
+        port, "POST /api/flag HTTP/1.1\r\nHost: test\r\n" + session + "Content-Length: " +
+                  std::to_string(move.size()) + "\r\n\r\n" + move
+    );
+    assert(flagged.status == 200);
+
+    const Reply delta = exchange(
+        port, "GET /api/board?since=" + since + " HTTP/1.1\r\nHost: test\r\n"
+                  "Accept: application/vnd.clearbomb.compact+json\r\n" + session + "\r\n"
+    );
+    assert(delta.status == 200);
+    assert(delta.body.find("\"updatedCells\"") != std::string::npos);
+    assert(delta.header("Content-Type") == std::string("application/json"));
+    const auto etag = delta.header("ETag");
+    assert(etag && etag->ends_with("-d" + since + "\""));
+}
+
+void test_empty_responses_are_not_compressed(unsigned short port)
+{
+    const Reply preflight =
+        exchange(port, "OPTIONS /api/board HTTP/1.1\r\nHost: test\r\nAccept-Encoding: gzip\r\nConnection: close\r\n\r\n");
+    assert(preflight.status == 204);
+    assert(preflight.body.empty());
+    assert(!preflight.header("Content-Encoding"));
+}
+}  // namespace
+
+int main()
+{
+    clearbomb::Logger::instance().set_level(clearbomb::LogLevel::Warning);
+
+    clearbomb::ApiServerOptions options;
+    options.port = 0;
+    options.worker_threads = 2;
+    options.compression_threshold = 0;
+    clearbomb::ApiServer server(std::make_shared<clearbomb::SessionRegistry>(), options);
+    server.start();
+    assert(server.port() != 0);
+
+    test_conditional_get_with_gzip(server.port());
+    test_delta_has_its_own_etag(server.port());
+    test_empty_responses_are_not_compressed(server.port());
+    server.stop();
+
+    std::cout << "ApiServer tests completed successfully." << std::endl;
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include "AutoMarker.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+using clearbomb::AutoMarker;
+using clearbomb::CellState;
+using clearbomb::PackedCell;
+using clearbomb::Position;
+
+// Board built from a picture: '*' hidden mine, 'F' flagged mine, '.' hidden
+// safe cell, 'o' revealed safe cell.
+class LayoutBoard : public clearbomb::MinesweeperBoard {
+public:
+    explicit LayoutBoard(const std::vector<std::string>& picture)
+        : MinesweeperBoard(
+              picture.size(), picture.front().size(), count_mines(picture), 0, clearbomb::BoardGenerator::Mt19937,
+              clearbomb::SafeStart::Cell
+          )
+    {
+        for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
+            const char symbol = picture[idx / columns_][idx % columns_];
+            cells_[idx].set_mine(symbol == '*' || symbol == 'F');
+            cells_[idx].set_state(
+                symbol == 'F' ? CellState::Flagged : symbol == 'o' ? CellState::Revealed : CellState::Hidden
+            );
+        }
+        for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
+            int count = 0;
+            for_each_neighbor(idx, [&](std::size_t neighbor) { count += cells_[neighbor].is_mine() ? 1 : 0; });
+            cells_[idx].set_adjacent_mines(cells_[idx].is_mine() ? 0 : count);
+        }
+        mines_placed_ = true;
+    }
+
+private:
+    static std::size_t count_mines(const std::vector<std::string>& picture)
+    {
+        std::size_t mines = 0;
+        for (const auto& row : picture) {
+            mines += static_cast<std::size_t>(std::count_if(row.begin(), row.end(), [](char symbol) {
+                return symbol == '*' || symbol == 'F';
+            }));
+        }
+        return mines;
+    }
+};
+
+std::vector<Position> whole_board(const clearbomb::MinesweeperBoard& board)
+{
+    std::vector<Position> positions;
+    for (std::size_t row = 0; row < board.rows(); ++row) {
+        for (std::size_t column = 0; column < board.columns(); ++column) {
+            positions.push_back(Position{row, column});
+        }
+    }
+    return positions;
+}
+
+[[maybe_unused]] std::vector<std::size_t> indices(const std::vector<Position>& positions, std::size_t columns)
+{
+    std::vector<std::size_t> result;
+    for (const auto& position : positions) {
+        result.push_back(position.row * columns + position.column);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void test_subset_rule_solves_one_one_two_one_one()
+{
+    // No single number settles anything here; (1,0) inside (1,1) proves
+    // (0,2) safe, after which the 2 and the outer 1s settle the rest.
+    const LayoutBoard board({".*.*.", "ooooo", "ooooo"});
+    const auto deductions = AutoMarker{}.deduce(board, whole_board(board));
+    assert(indices(deductions.mines, 5) == (std::vector<std::size_t>{1, 3}));
+    assert(indices(deductions.safe_cells, 5) == (std::vector<std::size_t>{0, 2, 4}));
+}
+
+void test_flags_count_as_mines()
+{
+    const LayoutBoard board({"F.*", "ooo"});
+    const auto deductions = AutoMarker{}.deduce(board, whole_board(board));
+    assert(indices(deductions.mines, 3) == (std::vector<std::size_t>{2}));
+    assert(indices(deductions.safe_cells, 3) == (std::vector<std::size_t>{1}));
+}
+
+void test_selection_limits_constraints()
+{
+    const LayoutBoard board({".*.*.", "ooooo", "ooooo"});
+    const auto deductions = AutoMarker{}.deduce(board, {Position{1, 0}, Position{2, 4}});
+    assert(deductions.mines.empty() && deductions.safe_cells.empty());
+    assert(!AutoMarker{}.detect_certain_mines(board, {Position{1, 0}}));
+}
+
+// Plays seeded games using only the solver's deductions and checks that
+// every deduction is right and that it finds at least what the single-cell
+// rule finds.
+void test_deductions_are_sound_on_real_games()
+{
+    std::size_t solved = 0;
+    for (std::uint64_t seed = 0; seed < 40; ++seed) {
+        clearbomb::MinesweeperBoard board(
+            16, 30, 99, seed, clearbomb::BoardGenerator::Counter, clearbomb::SafeStart::Neighborhood
+        );
+        board.reveal(Position{8, 15});
+        const auto& packed = board.packed_cells();
+
+        // Every round flags or reveals at least one cell, so a board can't
+        // take more rounds than it has cells.
+        bool settled = false;
+        for (std::size_t round = 0; round < packed.size(); ++round) {
+            const auto deductions = AutoMarker{}.deduce(board, whole_board(board));
+            for (const auto& mine : deductions.mines) {
+                assert(packed[mine.row * 30 + mine.column].is_mine());
+            }
+            for (const auto& safe : deductions.safe_cells) {
+                assert(!packed[safe.row * 30 + safe.column].is_mine());
+            }
+
+            for (std::size_t idx = 0; idx < packed.size(); ++idx) {
+                const PackedCell cell = packed[idx];
+                if (cell.state() != CellState::Revealed || cell.adjacent_mines() == 0) {
+                    continue;
+                }
+                std::size_t unknown = 0;
+                int remaining = cell.adjacent_mines();
+                board.for_each_neighbor(idx, [&](std::size_t neighbor) {
+                    unknown += packed[neighbor].state() == CellState::Hidden ? 1 : 0;
+                    remaining -= packed[neighbor].state() == CellState::Flagged ? 1 : 0;
+                });
+                if (unknown > 0 && (remaining == 0 || remaining == static_cast<int>(unknown))) {
+                    board.for_each_neighbor(idx, [&](std::size_t neighbor) {
+                        if (packed[neighbor].state() == CellState::Hidden) {
+                            const Position position{neighbor / 30, neighbor % 30};
+                            const auto& found = remaining == 0 ? deductions.safe_cells : deductions.mines;
+                            assert(std::any_of(found.begin(), found.end(), [&](Position other) {
+                                return other.row == position.row && other.column == position.column;
+                            }));
+                        }
+                    });
+                }
+            }
+
+            if (deductions.mines.empty() && deductions.safe_cells.empty()) {
+                settled = true;
+                break;
+            }
+            for (const auto& mine : deductions.mines) {
+                board.toggle_flag(mine);
+            }
+            for (const auto& safe : deductions.safe_cells) {
+                const auto outcome = board.reveal(safe);
+                assert(!outcome.hit_mine);
+            }
+        }
+        assert(settled);
+        solved += board.all_safe_cells_revealed() ? 1 : 0;
+    }
+    assert(solved > 0);
+}
+}  // namespace
+
+int main()
+{
+    test_subset_rule_solves_one_one_two_one_one();
+    test_flags_count_as_mines();
+    test_selection_limits_constraints();
+    test_deductions_are_sound_on_real_games();
+
+    std::cout << "AutoMarker tests completed successfully." << std::endl;
+    return 0;
+}
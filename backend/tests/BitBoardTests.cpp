@@ -0,0 +1,184 @@
+#include "BitBoard.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+
+namespace {
+using clearbomb::AdjacencyKernel;
+using clearbomb::BitBoard;
+using clearbomb::CellState;
+using clearbomb::Position;
+
+constexpr std::array<AdjacencyKernel, 3> kKernels{AdjacencyKernel::Scalar, AdjacencyKernel::Sse2, AdjacencyKernel::Avx2};
+
+[[maybe_unused]] int naive_count(const BitBoard& board, Position position)
+{
+    int count = 0;
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            if (dr == 0 && dc == 0) {
+                continue;
+            }
+            const auto row = static_cast<std::size_t>(static_cast<long>(position.row) + dr);
+            const auto column = static_cast<std::size_t>(static_cast<long>(position.column) + dc);
+            if (row < board.rows() && column < board.columns() && board.is_mine(Position{row, column})) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+void assert_counts_match_layout(const BitBoard& board)
+{
+    std::size_t mines = 0;
+    for (std::size_t row = 0; row < board.rows(); ++row) {
+        for (std::size_t column = 0; column < board.columns(); ++column) {
+            const Position position{row, column};
+            if (board.is_mine(position)) {
+                ++mines;
+                assert(board.adjacent_mines(position) == 0);
+            } else {
+                assert(board.adjacent_mines(position) == naive_count(board, position));
+            }
+        }
+    }
+    assert(mines == board.mine_count());
+}
+
+void test_kernels_match_naive_count()
+{
+    // Odd widths exercise partial words and the narrower kernels' tails.
+    const std::array<std::array<std::size_t, 3>, 7> shapes{{
+        {1, 2, 1}, {3, 64, 40}, {2, 65, 100}, {37, 131, 900}, {5, 257, 1200}, {64, 63, 3900}, {120, 700, 20000}
+    }};
+    std::uint64_t seed = 1;
+    for (const auto& shape : shapes) {
+        BitBoard board(shape[0], shape[1], shape[2], seed++);
+        assert_counts_match_layout(board);
+        for (const auto kernel : kKernels) {
+            if (!BitBoard::kernel_supported(kernel)) {
+                continue;
+            }
+            board.recompute_adjacency(kernel);
+            assert_counts_match_layout(board);
+        }
+    }
+}
+
+void test_dense_and_sparse_boards_place_exact_mine_count()
+{
+    BitBoard dense(30, 90, 30 * 90 - 1, 7);
+    assert_counts_match_layout(dense);
+    BitBoard sparse(30, 90, 1, 7);
+    assert_counts_match_layout(sparse);
+}
+
+void test_same_seed_same_layout()
+{
+    BitBoard first(40, 100, 500, 42);
+    BitBoard second(40, 100, 500, 42);
+    for (std::size_t row = 0; row < first.rows(); ++row) {
+        for (std::size_t column = 0; column < first.columns(); ++column) {
+            assert(first.is_mine(Position{row, column}) == second.is_mine(Position{row, column}));
+        }
+    }
+}
+
+void test_reveal_and_flag()
+{
+    BitBoard board(1, 5, 1, 3);
+    std::size_t mine_column = 0;
+    while (!board.is_mine(Position{0, mine_column})) {
+        ++mine_column;
+    }
+
+    // Flagged cells are not revealed, and revealed cells cannot be flagged.
+    const std::size_t far_column = mine_column < 2 ? 4 : 0;
+    const auto flagged = board.toggle_flag(Position{0, far_column});
+    assert(flagged.flag_added && flagged.updated_cell.state == CellState::Flagged);
+    const auto blocked = board.reveal(Position{0, far_column});
+    assert(blocked.revealed_cells == 0);
+    const auto unflagged = board.toggle_flag(Position{0, far_column});
+    assert(!unflagged.flag_added);
+
+    const auto opened = board.reveal(Position{0, far_column});
+    assert(!opened.hit_mine && opened.revealed_cells > 0);
+    assert(board.cell_at(Position{0, far_column}).state == CellState::Revealed);
+    const auto refused = board.toggle_flag(Position{0, far_column});
+    assert(!refused.flag_added && refused.updated_cell.state == CellState::Revealed);
+
+    std::size_t safe_total = board.revealed_safe_cells();
+    for (std::size_t column = 0; column < board.columns(); ++column) {
+        if (column != mine_column) {
+            safe_total += board.reveal(Position{0, column}).revealed_cells;
+        }
+    }
+    assert(safe_total == 4 && board.all_safe_cells_revealed());
+
+    const auto boom = board.reveal(Position{0, mine_column});
+    assert(boom.hit_mine);
+    assert(board.cell_at(Position{0, mine_column}).exploded);
+}
+
+void test_flood_fill_opens_zero_region()
+{
+    BitBoard board(200, 300, 1, 11);
+    Position mine{0, 0};
+    for (std::size_t row = 0; row < board.rows(); ++row) {
+        for (std::size_t column = 0; column < board.columns(); ++column) {
+            if (board.is_mine(Position{row, column})) {
+                mine = Position{row, column};
+            }
+        }
+    }
+    const Position far{mine.row < 100 ? 199U : 0U, mine.column < 150 ? 299U : 0U};
+    const auto outcome = board.reveal(far);
+    assert(!outcome.hit_mine);
+    assert(outcome.revealed_cells == 200 * 300 - 1);
+    assert(board.all_safe_cells_revealed());
+}
+
+void test_rejects_invalid_arguments()
+{
+    bool threw = false;
+    try {
+        BitBoard board(0, 10, 1);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        BitBoard board(4, 4, 16);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    BitBoard board(4, 4, 2, 5);
+    threw = false;
+    try {
+        board.reveal(Position{4, 0});
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+}
+}  // namespace
+
+int main()
+{
+    test_kernels_match_naive_count();
+    test_dense_and_sparse_boards_place_exact_mine_count();
+    test_same_seed_same_layout();
+    test_reveal_and_flag();
+    test_flood_fill_opens_zero_region();
+    test_rejects_invalid_arguments();
+
+    std::cout << "BitBoard tests completed successfully." << std::endl;
+    return 0;
+}
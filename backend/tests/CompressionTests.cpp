@@ -0,0 +1,69 @@
+#include "Compression.hpp"
+
+#include <zlib.h>
+
+#include <cassert>
+#include <iostream>
+#include <string>
+
+namespace {
+using clearbomb::ContentEncoding;
+
+// Inflates either wrapper; windowBits 15 + 32 detects gzip or zlib headers.
+[[maybe_unused]] std::string inflate_body(const std::string& compressed)
+{
+    z_stream stream {};
+    const int initialised = inflateInit2(&stream, 15 + 32);
+    assert(initialised == Z_OK);
+    std::string out(1 << 20, '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+    stream.avail_in = static_cast<uInt>(compressed.size());
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    const int finished = inflate(&stream, Z_FINISH);
+    assert(finished == Z_STREAM_END);
+    out.resize(stream.total_out);
+    inflateEnd(&stream);
+    return out;
+}
+
+void test_negotiation()
+{
+    assert(clearbomb::negotiate_content_encoding("gzip, deflate, br") == ContentEncoding::Gzip);
+    assert(clearbomb::negotiate_content_encoding("deflate, GZIP;q=0.5") == ContentEncoding::Gzip);
+    assert(clearbomb::negotiate_content_encoding("gzip;q=0, deflate") == ContentEncoding::Deflate);
+    assert(clearbomb::negotiate_content_encoding("br, identity") == ContentEncoding::Identity);
+    assert(clearbomb::negotiate_content_encoding("") == ContentEncoding::Identity);
+    assert(clearbomb::content_encoding_name(ContentEncoding::Gzip) == "gzip");
+    assert(clearbomb::content_encoding_name(ContentEncoding::Identity).empty());
+}
+
+void test_round_trips()
+{
+    std::string body;
+    for (int i = 0; i < 2000; ++i) {
+        body += "{\"row\":" + std::to_string(i % 50) + ",\"state\":\"hidden\"},";
+    }
+
+    const std::string gzip = clearbomb::compress_body(body, ContentEncoding::Gzip, 6);
+    assert(static_cast<unsigned char>(gzip[0]) == 0x1f && static_cast<unsigned char>(gzip[1]) == 0x8b);
+    assert(gzip.size() * 10 < body.size());
+    assert(inflate_body(gzip) == body);
+
+    const std::string deflate = clearbomb::compress_body(body, ContentEncoding::Deflate, 1);
+    assert((static_cast<unsigned char>(deflate[0]) & 0x0fU) == Z_DEFLATED);
+    assert(inflate_body(deflate) == body);
+
+    assert(inflate_body(clearbomb::compress_body("", ContentEncoding::Gzip, 9)).empty());
+    assert(clearbomb::compress_body("abc", ContentEncoding::Identity, 6) == "abc");
+}
+}  // namespace
+
+int main()
+{
+    test_negotiation();
+    test_round_trips();
+
+    std::cout << "Compression tests completed successfully." << std::endl;
+    return 0;
+}
@@ -1,7 +1,12 @@
 #include "GameEngine.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
 
 namespace {
 void test_reset_changes_board_dimensions()
@@ -46,6 +51,606 @@ void test_first_move_is_safe()
         auto result = engine.reveal_cell(clearbomb::Position{0, 0});
         assert(!result.hit_mine);
     }
+
+    // Injected boards built without a SafeStart defer their mines as well,
+    // even when nearly every cell is mined.
+    for (int iteration = 0; iteration < 50; ++iteration) {
+        clearbomb::GameEngine injected(std::make_unique<clearbomb::MinesweeperBoard>(3, 3, 8));
+        const auto result = injected.reveal_cell(clearbomb::Position{1, 1});
+        assert(!result.hit_mine);
+    }
+}
+
+void test_packed_cell_round_trip()
+{
+    clearbomb::PackedCell packed;
+    packed.set_mine(true);
+    packed.set_adjacent_mines(8);
+    packed.set_state(clearbomb::CellState::Flagged);
+    packed.set_exploded(true);
+    assert(packed.is_mine() && packed.exploded());
+    assert(packed.adjacent_mines() == 8 && packed.state() == clearbomb::CellState::Flagged);
+
+    packed.set_state(clearbomb::CellState::Revealed);
+    packed.set_mine(false);
+    const auto cell = packed.to_cell(clearbomb::Position{4, 7});
+    assert(cell.position.row == 4 && cell.position.column == 7);
+    assert(!cell.is_mine && cell.exploded && cell.adjacent_mines == 8 && cell.state == clearbomb::CellState::Revealed);
+}
+
+void test_board_adjacency_matches_layout()
+{
+    clearbomb::MinesweeperBoard board(
+        20, 30, 150, clearbomb::random_board_seed(), clearbomb::BoardGenerator::Mt19937, clearbomb::SafeStart::None
+    );
+    const auto cells = board.cells();
+    assert(cells.size() == 600);
+
+    std::size_t mines = 0;
+    for (const auto& cell : cells) {
+        assert(board.cell_at(cell.position).is_mine == cell.is_mine);
+        if (cell.is_mine) {
+            ++mines;
+            continue;
+        }
+        int expected = 0;
+        for (const auto& neighbor : board.neighbors(cell.position)) {
+            expected += neighbor.is_mine ? 1 : 0;
+        }
+        assert(cell.adjacent_mines == expected);
+    }
+    assert(mines == 150);
+}
+
+void test_for_each_neighbor_clamps_at_borders()
+{
+    for (const auto& [rows, columns] : {std::pair<std::size_t, std::size_t>{1, 7}, {6, 1}, {5, 9}}) {
+        clearbomb::MinesweeperBoard board(rows, columns, 2);
+        for (std::size_t idx = 0; idx < rows * columns; ++idx) {
+            const clearbomb::Position position{idx / columns, idx % columns};
+            std::vector<std::size_t> expected;
+            for (const auto& neighbor : board.neighbors(position)) {
+                expected.push_back(neighbor.position.row * columns + neighbor.position.column);
+            }
+            std::vector<std::size_t> visited;
+            board.for_each_neighbor(idx, [&](std::size_t neighbor_index) { visited.push_back(neighbor_index); });
+            std::sort(expected.begin(), expected.end());
+            assert(visited == expected);
+
+            const std::size_t row_span = std::min<std::size_t>(position.row + 1, rows - 1) - (position.row == 0 ? 0 : position.row - 1) + 1;
+            const std::size_t column_span = std::min<std::size_t>(position.column + 1, columns - 1) - (position.column == 0 ? 0 : position.column - 1) + 1;
+            assert(visited.size() == row_span * column_span - 1);
+        }
+    }
+}
+
+[[maybe_unused]] bool same_layout(const clearbomb::MinesweeperBoard& lhs, const clearbomb::MinesweeperBoard& rhs)
+{
+    return std::equal(
+        lhs.packed_cells().begin(), lhs.packed_cells().end(), rhs.packed_cells().begin(), rhs.packed_cells().end(),
+        [](clearbomb::PackedCell a, clearbomb::PackedCell b) { return a.raw() == b.raw(); }
+    );
+}
+
+void test_seeded_boards_are_reproducible()
+{
+    using clearbomb::BoardGenerator;
+    using clearbomb::SafeStart;
+    for (const auto generator : {BoardGenerator::Mt19937, BoardGenerator::Counter}) {
+        const clearbomb::MinesweeperBoard first(30, 40, 200, 77, generator, SafeStart::None);
+        const clearbomb::MinesweeperBoard second(30, 40, 200, 77, generator, SafeStart::None);
+        const clearbomb::MinesweeperBoard other(30, 40, 200, 78, generator, SafeStart::None);
+        assert(first.seed() == 77 && first.generator() == generator);
+        assert(same_layout(first, second));
+        assert(!same_layout(first, other));
+    }
+    assert(!same_layout(
+        clearbomb::MinesweeperBoard(30, 40, 200, 77, BoardGenerator::Mt19937, SafeStart::None),
+        clearbomb::MinesweeperBoard(30, 40, 200, 77, BoardGenerator::Counter, SafeStart::None)
+    ));
+}
+
+void test_mine_placement_is_uniform()
+{
+    clearbomb::MinesweeperBoard board(3, 3, 2, 5, clearbomb::BoardGenerator::Counter);
+    std::vector<std::size_t> hits(9, 0);
+    constexpr std::size_t kLayouts = 6000;
+    for (std::size_t layout = 0; layout < kLayouts; ++layout) {
+        board.regenerate();
+        std::size_t mines = 0;
+        for (std::size_t idx = 0; idx < 9; ++idx) {
+            if (board.packed_cells()[idx].is_mine()) {
+                ++hits[idx];
+                ++mines;
+            }
+        }
+        assert(mines == 2);
+    }
+    const std::size_t expected = kLayouts * 2 / 9;
+    for (const std::size_t count : hits) {
+        assert(count > expected * 85 / 100 && count < expected * 115 / 100);
+    }
+
+    // Deferred placement around a corner opening spreads the mines evenly
+    // over the other eight cells instead of favouring the first free ones.
+    clearbomb::MinesweeperBoard deferred(3, 3, 2, 5, clearbomb::BoardGenerator::Counter, clearbomb::SafeStart::Cell);
+    std::fill(hits.begin(), hits.end(), 0);
+    for (std::size_t layout = 0; layout < kLayouts; ++layout) {
+        deferred.resize(3, 3, 2);
+        const auto outcome = deferred.reveal(clearbomb::Position{0, 0});
+        assert(!outcome.hit_mine);
+        for (std::size_t idx = 0; idx < 9; ++idx) {
+            hits[idx] += deferred.packed_cells()[idx].is_mine() ? 1 : 0;
+        }
+    }
+    assert(hits[0] == 0);
+    const std::size_t expected_deferred = kLayouts * 2 / 8;
+    for (std::size_t idx = 1; idx < 9; ++idx) {
+        assert(hits[idx] > expected_deferred * 85 / 100 && hits[idx] < expected_deferred * 115 / 100);
+    }
+}
+
+void test_first_reveal_places_mines_around_safe_start()
+{
+    using clearbomb::Position;
+    using clearbomb::SafeStart;
+    for (std::uint64_t seed = 0; seed < 200; ++seed) {
+        clearbomb::MinesweeperBoard board(9, 9, 30, seed, clearbomb::BoardGenerator::Mt19937, SafeStart::Neighborhood);
+        assert(!board.mines_placed());
+        board.toggle_flag(Position{8, 8});
+        const Position opening{seed % 8, (seed / 8) % 8};
+        const auto outcome = board.reveal(opening);
+        assert(board.mines_placed() && !outcome.hit_mine);
+        assert(board.cell_at(opening).adjacent_mines == 0);
+        std::size_t mines = 0;
+        for (const auto& cell : board.cells()) {
+            mines += cell.is_mine ? 1 : 0;
+        }
+        assert(mines == 30);
+        for (const auto& neighbor : board.neighbors(opening)) {
+            assert(!neighbor.is_mine && neighbor.state != clearbomb::CellState::Hidden);
+        }
+        if (opening.row != 7 || opening.column != 7) {
+            assert(board.cell_at(Position{8, 8}).state == clearbomb::CellState::Flagged);
+        }
+    }
+
+    // Too dense to clear a neighbourhood: only the opening itself is safe.
+    for (std::uint64_t seed = 0; seed < 50; ++seed) {
+        clearbomb::MinesweeperBoard board(4, 4, 14, seed, clearbomb::BoardGenerator::Counter, SafeStart::Neighborhood);
+        const auto outcome = board.reveal(Position{1, 1});
+        assert(!outcome.hit_mine);
+    }
+
+    clearbomb::GameEngine engine;
+    for (int game = 0; game < 50; ++game) {
+        engine.reset(clearbomb::BoardConfig{16, 30, 99, std::nullopt, clearbomb::BoardGenerator::Mt19937, SafeStart::Neighborhood});
+        const auto result = engine.reveal_cell(Position{8, 15});
+        assert(!result.hit_mine && result.updated_cells.size() >= 9);
+    }
+}
+
+void test_seeded_games_replay_identically()
+{
+    const clearbomb::BoardConfig config{12, 12, 60, 4242, clearbomb::BoardGenerator::Counter};
+    clearbomb::GameEngine first;
+    clearbomb::GameEngine second;
+    first.reset(config);
+    second.reset(config);
+    assert(first.snapshot().seed == 4242 && first.snapshot().generator == clearbomb::BoardGenerator::Counter);
+
+    const clearbomb::Position opening{5, 5};
+    std::mt19937 picker(9);
+    std::uniform_int_distribution<std::size_t> pick(0, 11);
+    first.reveal_cell(opening);
+    second.reveal_cell(opening);
+    for (int move = 0; move < 40; ++move) {
+        const clearbomb::Position position{pick(picker), pick(picker)};
+        first.reveal_cell(position);
+        second.reveal_cell(position);
+    }
+    assert(same_layout(first.board(), second.board()));
+    assert(first.snapshot().status == second.snapshot().status);
+
+    first.reset();
+    assert(first.snapshot().seed != 4242);
+    assert(first.snapshot().generator == clearbomb::BoardGenerator::Counter);
+
+    bool threw = false;
+    try {
+        first.reset(clearbomb::BoardConfig{9, 9, 10, clearbomb::kMaxBoardSeed + 1});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+// Cells the original breadth-first reveal would expose from start.
+std::vector<std::size_t> reference_reveal(const clearbomb::MinesweeperBoard& board, clearbomb::Position start)
+{
+    const auto cells = board.cells();
+    const std::size_t columns = board.columns();
+    std::vector<bool> visited(cells.size(), false);
+    std::vector<std::size_t> pending{start.row * columns + start.column};
+    std::vector<std::size_t> exposed;
+    visited[pending.front()] = true;
+    while (!pending.empty()) {
+        const std::size_t idx = pending.back();
+        pending.pop_back();
+        if (cells[idx].state == clearbomb::CellState::Hidden) {
+            exposed.push_back(idx);
+        }
+        if (cells[idx].adjacent_mines != 0) {
+            continue;
+        }
+        for (const auto& neighbor : board.neighbors(cells[idx].position)) {
+            const std::size_t next = neighbor.position.row * columns + neighbor.position.column;
+            if (!visited[next] && !neighbor.is_mine && neighbor.state != clearbomb::CellState::Flagged) {
+                visited[next] = true;
+                pending.push_back(next);
+            }
+        }
+    }
+    std::sort(exposed.begin(), exposed.end());
+    return exposed;
+}
+
+void test_span_reveal_matches_breadth_first_reveal()
+{
+    std::mt19937 picker(1234);
+    for (int round = 0; round < 20; ++round) {
+        clearbomb::MinesweeperBoard board(
+            17 + static_cast<std::size_t>(round), 40, 40 + static_cast<std::size_t>(round) * 3,
+            static_cast<std::uint64_t>(round), clearbomb::BoardGenerator::Mt19937, clearbomb::SafeStart::None
+        );
+        std::uniform_int_distribution<std::size_t> pick(0, board.rows() * board.columns() - 1);
+        for (int flag = 0; flag < 15; ++flag) {
+            const std::size_t idx = pick(picker);
+            board.toggle_flag(clearbomb::Position{idx / board.columns(), idx % board.columns()});
+        }
+
+        for (int move = 0; move < 30; ++move) {
+            const std::size_t idx = pick(picker);
+            const clearbomb::Position position{idx / board.columns(), idx % board.columns()};
+            const auto cell = board.cell_at(position);
+            if (cell.is_mine || cell.state != clearbomb::CellState::Hidden) {
+                continue;
+            }
+
+            const auto expected = reference_reveal(board, position);
+            const std::size_t revealed_before = board.revealed_safe_cells();
+            const auto outcome = board.reveal(position);
+            std::vector<std::size_t> actual;
+            for (const auto& revealed : outcome.revealed_cells) {
+                assert(revealed.state == clearbomb::CellState::Revealed);
+                actual.push_back(revealed.position.row * board.columns() + revealed.position.column);
+            }
+            std::sort(actual.begin(), actual.end());
+            assert(!outcome.hit_mine);
+            assert(actual == expected);
+            assert(board.revealed_safe_cells() == revealed_before + actual.size());
+        }
+    }
+}
+
+// Chording a satisfied number must expose exactly what revealing each of its
+// hidden neighbours one by one would, listing every cell once.
+void test_chord_merges_neighbor_reveals()
+{
+    std::size_t chords = 0;
+    for (std::uint64_t seed = 0; seed < 40; ++seed) {
+        clearbomb::MinesweeperBoard board(
+            16, 30, 99, seed, clearbomb::BoardGenerator::Counter, clearbomb::SafeStart::Neighborhood
+        );
+        board.reveal(clearbomb::Position{8, 15});
+        const auto& packed = board.packed_cells();
+        for (std::size_t idx = 0; idx < packed.size(); ++idx) {
+            if (packed[idx].state() != clearbomb::CellState::Revealed || packed[idx].adjacent_mines() == 0) {
+                continue;
+            }
+            const clearbomb::Position center{idx / 30, idx % 30};
+            bool has_hidden_safe = false;
+            board.for_each_neighbor(idx, [&](std::size_t neighbor) {
+                has_hidden_safe = has_hidden_safe ||
+                                  (packed[neighbor].state() == clearbomb::CellState::Hidden && !packed[neighbor].is_mine());
+            });
+            if (!has_hidden_safe) {
+                continue;
+            }
+
+            // Unsatisfied: nothing happens.
+            const auto unsatisfied = board.chord(center);
+            assert(unsatisfied.revealed_cells.empty());
+
+            std::vector<std::size_t> expected;
+            board.for_each_neighbor(idx, [&](std::size_t neighbor) {
+                if (packed[neighbor].is_mine() && packed[neighbor].state() == clearbomb::CellState::Hidden) {
+                    board.toggle_flag(clearbomb::Position{neighbor / 30, neighbor % 30});
+                }
+            });
+            board.for_each_neighbor(idx, [&](std::size_t neighbor) {
+                if (packed[neighbor].state() == clearbomb::CellState::Hidden) {
+                    const auto region = reference_reveal(board, clearbomb::Position{neighbor / 30, neighbor % 30});
+                    expected.insert(expected.end(), region.begin(), region.end());
+                }
+            });
+            std::sort(expected.begin(), expected.end());
+            expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+            const std::size_t revealed_before = board.revealed_safe_cells();
+            const auto outcome = board.chord(center);
+            assert(!outcome.hit_mine);
+            std::vector<std::size_t> actual;
+            for (const auto& cell : outcome.revealed_cells) {
+                actual.push_back(cell.position.row * 30 + cell.position.column);
+            }
+            std::sort(actual.begin(), actual.end());
+            assert(std::adjacent_find(actual.begin(), actual.end()) == actual.end());
+            assert(actual == expected);
+            assert(board.revealed_safe_cells() == revealed_before + actual.size());
+            ++chords;
+            break;
+        }
+    }
+    assert(chords > 20);
+}
+
+void test_chord_with_wrong_flag_loses()
+{
+    clearbomb::GameEngine engine;
+    engine.reset(clearbomb::BoardConfig{
+        9, 9, 10, 3, clearbomb::BoardGenerator::Mt19937, clearbomb::SafeStart::Neighborhood
+    });
+    engine.reveal_cell(clearbomb::Position{4, 4});
+    const auto& board = engine.board();
+    const auto& packed = board.packed_cells();
+    for (std::size_t idx = 0; idx < packed.size(); ++idx) {
+        if (packed[idx].state() != clearbomb::CellState::Revealed || packed[idx].adjacent_mines() != 1) {
+            continue;
+        }
+        // Flag a safe hidden neighbour so the number looks satisfied.
+        std::size_t decoy = packed.size();
+        bool has_hidden_mine = false;
+        board.for_each_neighbor(idx, [&](std::size_t neighbor) {
+            if (packed[neighbor].state() != clearbomb::CellState::Hidden) {
+                return;
+            }
+            has_hidden_mine = has_hidden_mine || packed[neighbor].is_mine();
+            if (!packed[neighbor].is_mine()) {
+                decoy = neighbor;
+            }
+        });
+        if (!has_hidden_mine || decoy == packed.size()) {
+            continue;
+        }
+        engine.toggle_flag(clearbomb::Position{decoy / 9, decoy % 9});
+        const auto result = engine.chord_cell(clearbomb::Position{idx / 9, idx % 9});
+        assert(result.hit_mine);
+        assert(engine.snapshot().status == clearbomb::GameStatus::Defeat);
+        return;
+    }
+    assert(false && "no suitable number on the test board");
+}
+
+bool same_cell(const clearbomb::Cell& lhs, const clearbomb::Cell& rhs)
+{
+    return lhs.position.row == rhs.position.row && lhs.position.column == rhs.position.column &&
+           lhs.state == rhs.state && lhs.is_mine == rhs.is_mine && lhs.exploded == rhs.exploded;
+}
+
+void test_batch_matches_individual_moves()
+{
+    std::mt19937 picker(31);
+    std::uniform_int_distribution<std::size_t> pick_row(0, 15);
+    std::uniform_int_distribution<std::size_t> pick_column(0, 29);
+    for (std::uint64_t seed = 0; seed < 20; ++seed) {
+        const clearbomb::BoardConfig config{16, 30, 99, seed, clearbomb::BoardGenerator::Counter};
+        clearbomb::GameEngine single;
+        clearbomb::GameEngine batched;
+        single.reset(config);
+        batched.reset(config);
+
+        std::vector<clearbomb::Move> moves{{clearbomb::MoveType::Reveal, {8, 15}}};
+        for (int i = 0; i < 60; ++i) {
+            const auto type = static_cast<clearbomb::MoveType>(picker() % 4);
+            moves.push_back(clearbomb::Move{
+                type, {pick_row(picker), pick_column(picker)}, clearbomb::SelectionRect{0, 0, 15, 29}
+            });
+        }
+
+        std::vector<std::size_t> touched;
+        std::size_t applied = 0;
+        for (const auto& move : moves) {
+            if (single.snapshot().status != clearbomb::GameStatus::Playing) {
+                break;
+            }
+            std::vector<clearbomb::Cell> cells;
+            switch (move.type) {
+            case clearbomb::MoveType::Reveal:
+                cells = single.reveal_cell(move.position).updated_cells;
+                break;
+            case clearbomb::MoveType::Chord:
+                cells = single.chord_cell(move.position).updated_cells;
+                break;
+            case clearbomb::MoveType::Flag:
+                cells = {single.toggle_flag(move.position).updated_cell};
+                break;
+            case clearbomb::MoveType::AutoMark:
+                if (const auto result = single.auto_mark(move.selection)) {
+                    cells = result->flagged_cells;
+                }
+                break;
+            }
+            for (const auto& cell : cells) {
+                touched.push_back(cell.position.row * 30 + cell.position.column);
+            }
+            ++applied;
+        }
+
+        const auto result = batched.apply_batch(moves);
+        assert(result.applied == applied);
+        assert(same_layout(single.board(), batched.board()));
+        const auto snapshot = single.snapshot();
+        assert(result.status == snapshot.status);
+        assert(result.flags_remaining == snapshot.flags_remaining);
+        assert(result.hit_mine == (snapshot.status == clearbomb::GameStatus::Defeat));
+
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        std::vector<std::size_t> reported;
+        for (const auto& cell : result.updated_cells) {
+            const std::size_t idx = cell.position.row * 30 + cell.position.column;
+            reported.push_back(idx);
+            assert(same_cell(cell, snapshot.cells[idx]));
+        }
+        std::sort(reported.begin(), reported.end());
+        assert(std::adjacent_find(reported.begin(), reported.end()) == reported.end());
+        assert(reported == touched);
+    }
+}
+
+void test_batch_rejects_out_of_range_moves_up_front()
+{
+    clearbomb::GameEngine engine;
+    engine.reset(clearbomb::BoardConfig{9, 9, 10, 1});
+    bool threw = false;
+    try {
+        engine.apply_batch({{clearbomb::MoveType::Flag, {0, 0}}, {clearbomb::MoveType::Reveal, {9, 0}}});
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(engine.snapshot().flags_remaining == 10);
+}
+
+// Hidden and flagged cells only show their state; mines are placed on the
+// first reveal without touching what a client sees of them.
+[[maybe_unused]] bool same_visible_cell(const clearbomb::Cell& lhs, const clearbomb::Cell& rhs)
+{
+    return lhs.state == rhs.state && (lhs.state != clearbomb::CellState::Revealed || same_cell(lhs, rhs));
+}
+
+void test_changes_since_replays_onto_earlier_snapshots()
+{
+    std::mt19937 picker(5);
+    std::size_t served = 0;
+    std::size_t expired = 0;
+    for (std::uint64_t seed = 0; seed < 20; ++seed) {
+        clearbomb::GameEngine engine;
+        engine.reset(clearbomb::BoardConfig{9, 9, 10, seed, clearbomb::BoardGenerator::Counter});
+        std::uniform_int_distribution<std::size_t> pick(0, 8);
+        std::vector<clearbomb::BoardSnapshot> history{engine.snapshot()};
+
+        for (int move = 0; move < 80 && engine.status() == clearbomb::GameStatus::Playing; ++move) {
+            const clearbomb::Position position{pick(picker), pick(picker)};
+            const auto before = engine.version();
+            const bool revealed = engine.board().cell_at(position).state == clearbomb::CellState::Revealed;
+            if (picker() % 3 == 0) {
+                engine.toggle_flag(position);
+                // Flagging a revealed cell changes nothing, so neither does the version.
+                assert(!revealed || engine.version() == before);
+            } else if (!engine.board().cell_at(position).is_mine || picker() % 8 == 0) {
+                engine.reveal_cell(position);
+            }
+            assert(engine.version() >= before);
+            history.push_back(engine.snapshot());
+        }
+
+        const auto current = engine.snapshot();
+        for (const auto& earlier : history) {
+            const auto delta = engine.changes_since(earlier.version);
+            if (!delta) {
+                ++expired;
+                continue;
+            }
+            ++served;
+            assert(delta->version == current.version);
+            assert(delta->status == current.status && delta->flags_remaining == current.flags_remaining);
+            auto cells = earlier.cells;
+            for (const auto& cell : delta->updated_cells) {
+                cells[cell.position.row * 9 + cell.position.column] = cell;
+            }
+            for (std::size_t idx = 0; idx < cells.size(); ++idx) {
+                assert(same_visible_cell(cells[idx], current.cells[idx]));
+            }
+        }
+        assert(engine.changes_since(current.version)->updated_cells.empty());
+        assert(!engine.changes_since(current.version + 1));
+
+        // A new board cannot be described as changes to the old one.
+        engine.reset();
+        assert(engine.version() > current.version);
+        assert(!engine.changes_since(current.version));
+        assert(engine.changes_since(engine.version())->updated_cells.empty());
+    }
+    assert(served > 0 && expired > 0);
+}
+
+// Checks the engine's incremental frontier against one derived from scratch.
+void assert_frontier_matches_board(const clearbomb::GameEngine& engine)
+{
+    const auto& board = engine.board();
+    const auto& frontier = engine.frontier();
+    const auto& packed = board.packed_cells();
+    std::size_t expected_size = 0;
+    for (std::size_t idx = 0; idx < packed.size(); ++idx) {
+        std::size_t hidden = 0;
+        int flagged = 0;
+        board.for_each_neighbor(idx, [&](std::size_t neighbor) {
+            hidden += packed[neighbor].state() == clearbomb::CellState::Hidden ? 1 : 0;
+            flagged += packed[neighbor].state() == clearbomb::CellState::Flagged ? 1 : 0;
+        });
+        const bool member = packed[idx].state() == clearbomb::CellState::Revealed && !packed[idx].is_mine() &&
+                            packed[idx].adjacent_mines() > 0 && hidden > 0;
+        assert(frontier.contains(idx) == member);
+        assert(frontier.hidden_neighbors(idx) == hidden);
+        if (member) {
+            assert(frontier.remaining_mines(board, idx) == packed[idx].adjacent_mines() - flagged);
+            ++expected_size;
+        }
+    }
+    assert(frontier.cells().size() == expected_size);
+}
+
+void test_frontier_tracks_random_moves()
+{
+    std::mt19937 picker(77);
+    for (std::uint64_t game = 0; game < 30; ++game) {
+        clearbomb::GameEngine engine;
+        engine.reset(clearbomb::BoardConfig{
+            10 + game % 7, 12 + game % 5, 15 + game % 11, game, clearbomb::BoardGenerator::Counter
+        });
+        assert_frontier_matches_board(engine);
+        const auto rows = engine.board().rows();
+        const auto columns = engine.board().columns();
+        std::uniform_int_distribution<std::size_t> pick_row(0, rows - 1);
+        std::uniform_int_distribution<std::size_t> pick_column(0, columns - 1);
+
+        for (int move = 0; move < 120 && engine.snapshot().status == clearbomb::GameStatus::Playing; ++move) {
+            const clearbomb::Position position{pick_row(picker), pick_column(picker)};
+            switch (picker() % 5) {
+            case 0:
+            case 1:
+                engine.toggle_flag(position);
+                break;
+            case 2:
+                if (picker() % 2 == 0) {
+                    engine.auto_mark(clearbomb::SelectionRect{0, 0, rows - 1, columns - 1});
+                } else {
+                    engine.chord_cell(position);
+                }
+                break;
+            default:
+                // Mostly open safe cells so games run long; now and then
+                // step on a mine to cover the end-of-game path.
+                if (!engine.board().cell_at(position).is_mine || picker() % 10 == 0) {
+                    engine.reveal_cell(position);
+                }
+                break;
+            }
+            assert_frontier_matches_board(engine);
+        }
+    }
 }
 
 }  // namespace
@@ -55,6 +660,20 @@ int main()
     test_reset_changes_board_dimensions();
     test_flagging_consistency();
     test_first_move_is_safe();
+    test_packed_cell_round_trip();
+    test_board_adjacency_matches_layout();
+    test_for_each_neighbor_clamps_at_borders();
+    test_span_reveal_matches_breadth_first_reveal();
+    test_chord_merges_neighbor_reveals();
+    test_chord_with_wrong_flag_loses();
+    test_frontier_tracks_random_moves();
+    test_batch_matches_individual_moves();
+    test_batch_rejects_out_of_range_moves_up_front();
+    test_changes_since_replays_onto_earlier_snapshots();
+    test_seeded_boards_are_reproducible();
+    test_mine_placement_is_uniform();
+    test_first_reveal_places_mines_around_safe_start();
+    test_seeded_games_replay_identically();
 
     std::cout << "GameEngine smoke tests completed successfully." << std::endl;
     return 0;
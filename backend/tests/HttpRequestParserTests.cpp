@@ -0,0 +1,121 @@
+#include "HttpRequestParser.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+using clearbomb::HttpParseStatus;
+using clearbomb::HttpRequest;
+using clearbomb::HttpRequestParser;
+
+void test_parses_request_with_body()
+{
+    const std::string raw =
+        "POST /api/reveal?session=abc HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "content-length: 20\r\n"
+        "X-Session-Id:  player-1 \r\n"
+        "\r\n"
+        "{\"row\":1,\"column\":2}";
+
+    HttpRequestParser parser;
+    HttpRequest request;
+    const auto result = parser.parse(raw, request);
+
+    assert(result.status == HttpParseStatus::Complete);
+    assert(result.consumed == raw.size());
+    assert(request.method == "POST");
+    assert(request.path == "/api/reveal");
+    assert(request.query == "session=abc");
+    assert(request.query_parameter("session") == std::string_view("abc"));
+    assert(request.header("Content-Length") == std::string_view("20"));
+    assert(request.header("x-session-id") == std::string_view("player-1"));
+    assert(request.body == "{\"row\":1,\"column\":2}");
+    assert(request.keep_alive());
+}
+
+void test_incremental_feed_and_pipelining()
+{
+    const std::string first = "GET /api/board HTTP/1.1\r\nHost: a\r\n\r\n";
+    const std::string second = "GET /api/board HTTP/1.0\r\nConnection: keep-alive\r\n\r\n";
+    const std::string stream = first + second;
+
+    HttpRequestParser parser;
+    HttpRequest request;
+    for (std::size_t length = 0; length < first.size(); ++length) {
+        const auto partial = parser.parse(std::string_view(stream).substr(0, length), request);
+        assert(partial.status == HttpParseStatus::Incomplete);
+    }
+
+    auto result = parser.parse(stream, request);
+    assert(result.status == HttpParseStatus::Complete);
+    assert(result.consumed == first.size());
+
+    parser.reset();
+    result = parser.parse(std::string_view(stream).substr(result.consumed), request);
+    assert(result.status == HttpParseStatus::Complete);
+    assert(request.version == "HTTP/1.0");
+    assert(request.keep_alive());
+}
+
+void test_rejects_malformed_and_oversized_requests()
+{
+    HttpRequest request;
+
+    HttpRequestParser parser;
+    assert(parser.parse("GARBAGE\r\n\r\n", request).status == HttpParseStatus::Invalid);
+    parser.reset();
+    assert(parser.parse("GET /x HTTP/2.0\r\n\r\n", request).status == HttpParseStatus::Invalid);
+    parser.reset();
+    assert(parser.parse("GET /x HTTP/1.1\r\nContent-Length: 4x\r\n\r\n", request).status == HttpParseStatus::Invalid);
+    parser.reset();
+    assert(parser.parse("GET /x HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n", request).status == HttpParseStatus::Invalid);
+
+    HttpRequestParser limited(clearbomb::HttpParserLimits{64, 8});
+    assert(limited.parse(std::string(80, 'A'), request).status == HttpParseStatus::HeadersTooLarge);
+    limited.reset();
+    assert(limited.parse("POST /x HTTP/1.1\r\nContent-Length: 9\r\n\r\n", request).status == HttpParseStatus::BodyTooLarge);
+}
+
+void test_connection_close_and_rebase()
+{
+    std::string raw = "GET /api/board HTTP/1.1\r\nConnection: Close\r\n\r\n";
+    HttpRequestParser parser;
+    HttpRequest request;
+    const auto result = parser.parse(raw, request);
+    assert(result.status == HttpParseStatus::Complete);
+    assert(!request.keep_alive());
+
+    const std::string copy = raw;
+    request.rebase(raw.data(), copy.data());
+    raw.assign(raw.size(), '#');
+    assert(request.path == "/api/board");
+    assert(request.header("connection") == std::string_view("Close"));
+}
+
+void test_accept_lists()
+{
+    const std::string_view accept = "text/html, Application/JSON;q=0.9 , image/webp;q=0, */*;q=0.000";
+    assert(clearbomb::accepts_list_token(accept, "application/json"));
+    assert(clearbomb::accepts_list_token(accept, "text/html"));
+    assert(!clearbomb::accepts_list_token(accept, "image/webp"));
+    assert(!clearbomb::accepts_list_token(accept, "*/*"));
+    assert(!clearbomb::accepts_list_token(accept, "text/plain"));
+    assert(clearbomb::accepts_list_token("gzip;level=1", "gzip"));
+}
+
+}  // namespace
+
+int main()
+{
+    test_parses_request_with_body();
+    test_incremental_feed_and_pipelining();
+    test_rejects_malformed_and_oversized_requests();
+    test_connection_close_and_rebase();
+    test_accept_lists();
+
+    std::cout << "HttpRequestParser tests completed successfully." << std::endl;
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "JsonReader.hpp"
+
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+using clearbomb::JsonReader;
+using clearbomb::JsonUnsignedField;
+
+struct PositionFields {
+    std::size_t row {0};
+    std::size_t column {0};
+    std::array<JsonUnsignedField, 2> fields{{{"row", &row}, {"column", &column}}};
+};
+
+[[maybe_unused]] std::string parse_position_error(std::string_view body)
+{
+    PositionFields position;
+    JsonReader reader(body);
+    const bool parsed = clearbomb::read_unsigned_fields(reader, position.fields);
+    assert(parsed == !reader.failed());
+    return reader.error_message();
+}
+
+void test_reads_fields_in_any_order_and_skips_unknown_members()
+{
+    PositionFields position;
+    JsonReader reader(" {\"extra\":{\"nested\":[1,-2.5e3,\"s\\\"\",true,null]},\"column\": 12 ,\n\"row\":3} ");
+    const bool read = clearbomb::read_unsigned_fields(reader, position.fields);
+    assert(read);
+    assert(position.row == 3 && position.column == 12);
+    assert(reader.error_message().empty());
+}
+
+void test_optional_fields()
+{
+    std::size_t rows = 0;
+    std::size_t seed = 99;
+    std::array<JsonUnsignedField, 2> fields{{{"rows", &rows}, {"seed", &seed, false}}};
+    JsonReader reader("{\"rows\":9}");
+    const bool read = clearbomb::read_unsigned_fields(reader, fields);
+    assert(read);
+    assert(rows == 9 && seed == 99 && !fields[1].present);
+}
+
+void test_reports_precise_errors()
+{
+    assert(parse_position_error("") == "expected '{' at offset 0");
+    assert(parse_position_error("{\"row\":1}") == "field \"column\": missing required field");
+    assert(parse_position_error("{\"row\":1,\"column\":-4}") == "field \"column\": expected a non-negative integer at offset 18");
+    assert(parse_position_error("{\"row\":1.5,\"column\":2}") == "field \"row\": expected an integer at offset 8");
+    assert(parse_position_error("{\"row\":01,\"column\":2}") == "field \"row\": leading zeros are not allowed at offset 7");
+    assert(parse_position_error("{\"row\":1 \"column\":2}") == "expected ',' or '}' at offset 9");
+    assert(parse_position_error("{\"row\":1,\"row\":2,\"column\":2}") == "field \"row\": duplicate field at offset 15");
+    assert(parse_position_error("{\"row\":1,\"column\":2} x") == "unexpected trailing characters at offset 21");
+    assert(parse_position_error("{row:1}") == "expected string at offset 1");
+    assert(parse_position_error("{\"row\":99999999999999999999999,\"column\":0}") == "field \"row\": integer out of range at offset 7");
+    assert(parse_position_error("{\"row\":1,\"column\":2,\"x\":\"\\q\"}") == "field \"x\": invalid escape sequence at offset 26");
+}
+
+void test_hands_other_members_to_callback()
+{
+    std::size_t rows = 0;
+    std::array<JsonUnsignedField, 1> fields{{{"rows", &rows}}};
+    std::string_view name;
+    JsonReader reader("{\"name\":\"counter\",\"rows\":3,\"extra\":[1]}");
+    const bool parsed = clearbomb::read_unsigned_fields(reader, fields, [&](std::string_view key) {
+        return key == "name" ? reader.read_string(name) : reader.skip_value();
+    });
+    assert(parsed && rows == 3 && name == "counter");
+}
+
+void test_rejects_deep_nesting()
+{
+    const std::string nested = "{\"x\":" + std::string(64, '[') + std::string(64, ']') + "}";
+    JsonReader reader(nested);
+    const bool skipped = reader.skip_value();
+    assert(!skipped);
+    assert(reader.error_message().find("nesting too deep") != std::string::npos);
+}
+}  // namespace
+
+int main()
+{
+    test_reads_fields_in_any_order_and_skips_unknown_members();
+    test_optional_fields();
+    test_reports_precise_errors();
+    test_hands_other_members_to_callback();
+    test_rejects_deep_nesting();
+
+    std::cout << "JsonReader tests completed successfully." << std::endl;
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "Base64.hpp"
+#include "JsonWriter.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <string>
+
+namespace {
+using clearbomb::Cell;
+using clearbomb::CellState;
+using clearbomb::JsonWriter;
+
+void test_cell_hides_unrevealed_information()
+{
+    std::string out;
+    JsonWriter(out).cell(Cell{{3, 12}, true, 2, CellState::Hidden, false});
+    assert(out == "{\"row\":3,\"column\":12,\"state\":\"hidden\",\"adjacentMines\":0,\"isMine\":false,\"exploded\":false}");
+
+    out.clear();
+    JsonWriter(out).cell(Cell{{0, 1}, false, 4, CellState::Revealed, false});
+    assert(out == "{\"row\":0,\"column\":1,\"state\":\"revealed\",\"adjacentMines\":4,\"isMine\":false,\"exploded\":false}");
+
+    out.clear();
+    JsonWriter(out).cell(Cell{{49, 7}, true, 3, CellState::Revealed, true});
+    assert(out == "{\"row\":49,\"column\":7,\"state\":\"revealed\",\"adjacentMines\":0,\"isMine\":true,\"exploded\":true}");
+}
+
+void test_board_snapshot_layout()
+{
+    const clearbomb::BoardSnapshot snapshot{
+        2,
+        1,
+        1,
+        0,
+        clearbomb::GameStatus::Defeat,
+        {Cell{{0, 0}, false, 1, CellState::Revealed, false}, Cell{{1, 0}, true, 0, CellState::Flagged, false}},
+        9007199254740991ULL,
+        clearbomb::BoardGenerator::Counter,
+        clearbomb::SafeStart::Neighborhood,
+        42
+    };
+
+    std::string out;
+    JsonWriter(out).board_snapshot(snapshot);
+    assert(
+        out ==
+        "{\"rows\":2,\"columns\":1,\"mines\":1,\"flagsRemaining\":0,\"status\":\"defeat\",\"seed\":9007199254740991,"
+        "\"generator\":\"counter\",\"safeStart\":\"neighborhood\",\"version\":42,\"cells\":["
+        "{\"row\":0,\"column\":0,\"state\":\"revealed\",\"adjacentMines\":1,\"isMine\":false,\"exploded\":false},"
+        "{\"row\":1,\"column\":0,\"state\":\"flagged\",\"adjacentMines\":0,\"isMine\":false,\"exploded\":false}]}"
+    );
+    assert(out.capacity() >= JsonWriter::cells_capacity(snapshot.cells.size()));
+
+    out.clear();
+    JsonWriter(out).cells({});
+    assert(out == "[]");
+}
+
+void test_board_delta_layout()
+{
+    std::string out;
+    JsonWriter(out).board_delta(clearbomb::BoardDelta{
+        7, 3, clearbomb::GameStatus::Playing, {Cell{{1, 2}, false, 0, CellState::Revealed, false}}
+    });
+    assert(
+        out == "{\"version\":7,\"flagsRemaining\":3,\"status\":\"playing\",\"updatedCells\":["
+               "{\"row\":1,\"column\":2,\"state\":\"revealed\",\"adjacentMines\":0,\"isMine\":false,"
+               "\"exploded\":false}]}"
+    );
+}
+
+void test_base64()
+{
+    assert(clearbomb::base64_encode("").empty());
+    assert(clearbomb::base64_encode("f") == "Zg==");
+    assert(clearbomb::base64_encode("fo") == "Zm8=");
+    assert(clearbomb::base64_encode("foobar") == "Zm9vYmFy");
+    assert(clearbomb::base64_encode(std::string_view("\xff\x00\xfe", 3)) == "/wD+");
+}
+
+void test_compact_board_snapshot_layout()
+{
+    // A revealed 1, a flag, then 300 hidden cells that need two runs.
+    clearbomb::BoardSnapshot snapshot{
+        1, 302, 10, 9, clearbomb::GameStatus::Playing, {}, 5, clearbomb::BoardGenerator::Mt19937,
+        clearbomb::SafeStart::Cell, 8
+    };
+    snapshot.cells.push_back(Cell{{0, 0}, false, 1, CellState::Revealed, false});
+    snapshot.cells.push_back(Cell{{0, 1}, true, 1, CellState::Flagged, false});
+    for (std::size_t column = 2; column < 302; ++column) {
+        snapshot.cells.push_back(Cell{{0, column}, column % 7 == 0, 2, CellState::Hidden, false});
+    }
+
+    std::string out;
+    JsonWriter(out).compact_board_snapshot(snapshot);
+    assert(
+        out == "{\"rows\":1,\"columns\":302,\"mines\":10,\"flagsRemaining\":9,\"status\":\"playing\",\"seed\":5,"
+               "\"generator\":\"mt19937\",\"safeStart\":\"cell\",\"version\":8,\"encoding\":\"rle\","
+               "\"cells\":\"ARIBBP8ALQA=\"}"
+    );
+}
+
+void test_scalars()
+{
+    std::string out;
+    JsonWriter(out).number(std::size_t{18446744073709551615ULL}).raw(",").number(-12).raw(",").boolean(true);
+    assert(out == "18446744073709551615,-12,true");
+}
+
+void test_cell_probabilities()
+{
+    std::string out;
+    JsonWriter(out).cell_probabilities({{{0, 1}, 0.0}, {{2, 3}, 0.125}, {{4, 5}, 1.0 / 3.0}});
+    assert(
+        out == "[{\"row\":0,\"column\":1,\"mineProbability\":0},"
+               "{\"row\":2,\"column\":3,\"mineProbability\":0.125},"
+               "{\"row\":4,\"column\":5,\"mineProbability\":0.333333}]"
+    );
+}
+}  // namespace
+
+int main()
+{
+    test_cell_hides_unrevealed_information();
+    test_board_snapshot_layout();
+    test_board_delta_layout();
+    test_base64();
+    test_compact_board_snapshot_layout();
+    test_scalars();
+    test_cell_probabilities();
+
+    std::cout << "JsonWriter tests completed successfully." << std::endl;
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "Logger.hpp"
+
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+namespace fs = std::filesystem;
+
+[[maybe_unused]] std::size_t count_lines(const fs::path& directory, const std::string& needle)
+{
+    std::size_t count = 0;
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        std::ifstream stream(entry.path());
+        std::string line;
+        while (std::getline(stream, line)) {
+            if (line.find(needle) != std::string::npos) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+fs::path fresh_directory(const std::string& name)
+{
+    const auto directory = fs::temp_directory_path() / name;
+    fs::remove_all(directory);
+    return directory;
+}
+
+void test_messages_are_only_built_when_logged()
+{
+    auto& logger = clearbomb::Logger::instance();
+    int evaluations = 0;
+    const auto count = [&evaluations]() { return ++evaluations; };
+
+    logger.set_level(clearbomb::LogLevel::Warning);
+    LOG_DEBUG("LoggerTests", "debug " << count());
+    LOG_INFO("LoggerTests", "info " << count());
+    assert(evaluations == 0);
+
+    LOG_ERROR("LoggerTests", "error " << count());
+    assert(evaluations == (clearbomb::kMinCompiledLogLevel <= clearbomb::LogLevel::Error ? 1 : 0));
+
+    logger.set_level(clearbomb::LogLevel::Debug);
+    LOG_DEBUG("LoggerTests", "debug " << count());
+    assert(evaluations == (clearbomb::kMinCompiledLogLevel <= clearbomb::LogLevel::Debug ? 2 : 0));
+
+    logger.set_level(clearbomb::LogLevel::Info);
+}
+
+void test_async_logging_delivers_every_record()
+{
+    auto& logger = clearbomb::Logger::instance();
+    const auto directory = fresh_directory("clear_bomb_logger_async");
+    logger.set_log_directory(directory.string(), "async", 0);
+    logger.start_async(clearbomb::AsyncLoggingOptions{1 << 16, std::chrono::milliseconds(50)});
+    assert(logger.async_enabled());
+
+    constexpr int kThreads = 4;
+    constexpr int kRecordsPerThread = 2000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < kRecordsPerThread; ++i) {
+                LOG_INFO("LoggerTests", "async record thread=" << t << " index=" << i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    logger.stop_async();
+    assert(!logger.async_enabled());
+    assert(logger.dropped_records() == 0);
+    assert(count_lines(directory, "async record") == kThreads * kRecordsPerThread);
+}
+
+void test_async_logging_rotates_files()
+{
+    auto& logger = clearbomb::Logger::instance();
+    const auto directory = fresh_directory("clear_bomb_logger_rotation");
+    logger.set_log_directory(directory.string(), "rotation", 4096);
+    logger.start_async();
+
+    for (int i = 0; i < 500; ++i) {
+        LOG_WARNING("LoggerTests", "rotation record " << i);
+    }
+    logger.stop_async();
+
+    std::size_t files = 0;
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        assert(fs::file_size(entry.path()) <= 4096);
+        ++files;
+    }
+    assert(files > 1);
+    assert(count_lines(directory, "rotation record") == 500);
+}
+}  // namespace
+
+int main()
+{
+    clearbomb::Logger::instance().enable_console_logging(false);
+
+    test_messages_are_only_built_when_logged();
+    test_async_logging_delivers_every_record();
+    test_async_logging_rotates_files();
+
+    std::cout << "Logger tests completed successfully." << std::endl;
+    return 0;
+}
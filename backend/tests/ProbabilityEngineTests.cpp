@@ -0,0 +1,250 @@
+#include "ProbabilityEngine.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+using clearbomb::CellState;
+using clearbomb::PackedCell;
+using clearbomb::Position;
+using clearbomb::ProbabilityEngine;
+using clearbomb::ProbabilityMap;
+using clearbomb::ProbabilityStatus;
+
+// Board built from a picture: '*' hidden mine, 'F' flagged cell (mined
+// unless lowercase 'f'), '.' hidden safe cell, 'o' revealed safe cell.
+class LayoutBoard : public clearbomb::MinesweeperBoard {
+public:
+    explicit LayoutBoard(const std::vector<std::string>& picture)
+        : MinesweeperBoard(
+              picture.size(), picture.front().size(), count_mines(picture), 0, clearbomb::BoardGenerator::Mt19937,
+              clearbomb::SafeStart::Cell
+          )
+    {
+        for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
+            const char symbol = picture[idx / columns_][idx % columns_];
+            cells_[idx].set_mine(symbol == '*' || symbol == 'F');
+            cells_[idx].set_state(
+                symbol == 'F' || symbol == 'f' ? CellState::Flagged
+                : symbol == 'o'                ? CellState::Revealed
+                                               : CellState::Hidden
+            );
+        }
+        for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
+            int count = 0;
+            for_each_neighbor(idx, [&](std::size_t neighbor) { count += cells_[neighbor].is_mine() ? 1 : 0; });
+            cells_[idx].set_adjacent_mines(cells_[idx].is_mine() ? 0 : count);
+        }
+        mines_placed_ = true;
+    }
+
+private:
+    static std::size_t count_mines(const std::vector<std::string>& picture)
+    {
+        std::size_t mines = 0;
+        for (const auto& row : picture) {
+            mines += static_cast<std::size_t>(std::count_if(row.begin(), row.end(), [](char symbol) {
+                return symbol == '*' || symbol == 'F';
+            }));
+        }
+        return mines;
+    }
+};
+
+[[maybe_unused]] double probability_at(const ProbabilityMap& map, Position position)
+{
+    const auto it = std::find_if(map.cells.begin(), map.cells.end(), [&](const auto& cell) {
+        return cell.position.row == position.row && cell.position.column == position.column;
+    });
+    assert(it != map.cells.end());
+    return it->mine_probability;
+}
+
+[[maybe_unused]] bool near(double lhs, double rhs)
+{
+    return std::abs(lhs - rhs) < 1e-9;
+}
+
+// Enumerates every placement of the remaining mines over the hidden cells
+// and averages the ones that agree with all revealed numbers.
+std::vector<double> brute_force(const clearbomb::MinesweeperBoard& board)
+{
+    const auto& packed = board.packed_cells();
+    std::vector<std::size_t> hidden;
+    std::size_t flags = 0;
+    for (std::size_t idx = 0; idx < packed.size(); ++idx) {
+        hidden.push_back(idx);
+        flags += packed[idx].state() == CellState::Flagged ? 1 : 0;
+    }
+    std::erase_if(hidden, [&](std::size_t idx) { return packed[idx].state() != CellState::Hidden; });
+    assert(hidden.size() <= 24);
+
+    struct Check {
+        std::uint32_t mask;
+        int mines;
+    };
+    std::vector<Check> checks;
+    for (std::size_t idx = 0; idx < packed.size(); ++idx) {
+        if (packed[idx].state() != CellState::Revealed) {
+            continue;
+        }
+        Check check{0, packed[idx].adjacent_mines()};
+        board.for_each_neighbor(idx, [&](std::size_t neighbor) {
+            const auto it = std::find(hidden.begin(), hidden.end(), neighbor);
+            if (it != hidden.end()) {
+                check.mask |= std::uint32_t{1} << (it - hidden.begin());
+            }
+            check.mines -= packed[neighbor].state() == CellState::Flagged ? 1 : 0;
+        });
+        checks.push_back(check);
+    }
+
+    const int remaining = static_cast<int>(board.mine_count() - flags);
+    std::vector<double> mined(hidden.size(), 0.0);
+    double layouts = 0.0;
+    for (std::uint32_t layout = 0; layout < (std::uint32_t{1} << hidden.size()); ++layout) {
+        if (std::popcount(layout) != remaining ||
+            !std::all_of(checks.begin(), checks.end(), [&](const Check& check) {
+                return std::popcount(layout & check.mask) == check.mines;
+            })) {
+            continue;
+        }
+        layouts += 1.0;
+        for (std::size_t i = 0; i < hidden.size(); ++i) {
+            mined[i] += (layout >> i) & 1U ? 1.0 : 0.0;
+        }
+    }
+    assert(layouts > 0.0);
+    for (auto& value : mined) {
+        value /= layouts;
+    }
+    return mined;
+}
+
+void test_uniform_before_first_reveal()
+{
+    const clearbomb::MinesweeperBoard board(
+        8, 8, 10, 7, clearbomb::BoardGenerator::Mt19937, clearbomb::SafeStart::Cell
+    );
+    const auto map = ProbabilityEngine{}.compute(board);
+    assert(map.status == ProbabilityStatus::Exact);
+    assert(map.cells.size() == 64);
+    assert(map.frontier_cells == 0 && map.components == 0);
+    for (const auto& cell : map.cells) {
+        assert(near(cell.mine_probability, 10.0 / 64.0));
+    }
+}
+
+void test_global_count_weights_components()
+{
+    // The numbers only see part of the hidden cells, so the cells off the
+    // frontier get their share of the mines the numbers leave over.
+    const LayoutBoard board({
+        "*.*..",
+        ".oooo",
+    });
+    const auto map = ProbabilityEngine{}.compute(board);
+    assert(map.status == ProbabilityStatus::Exact);
+    double total = 0.0;
+    for (const auto& cell : map.cells) {
+        total += cell.mine_probability;
+    }
+    assert(near(total, 2.0));
+    const auto expected = brute_force(board);
+    for (std::size_t i = 0; i < map.cells.size(); ++i) {
+        assert(near(map.cells[i].mine_probability, expected[i]));
+    }
+}
+
+void test_matches_brute_force_on_random_games()
+{
+    std::size_t checked = 0;
+    for (std::uint64_t seed = 0; seed < 60; ++seed) {
+        clearbomb::MinesweeperBoard board(
+            6, 6, 7, seed, clearbomb::BoardGenerator::Counter, clearbomb::SafeStart::Cell
+        );
+        std::mt19937_64 picker(seed);
+        std::uniform_int_distribution<std::size_t> pick(0, 35);
+        const auto& packed = board.packed_cells();
+        board.reveal(Position{seed % 6, (seed / 6) % 6});
+
+        // Open random safe cells and flag some mines until few cells remain
+        // hidden, checking the engine against enumeration along the way.
+        while (!board.all_safe_cells_revealed()) {
+            const std::size_t idx = pick(picker);
+            const PackedCell cell = packed[idx];
+            if (cell.state() != CellState::Hidden) {
+                continue;
+            }
+            if (cell.is_mine()) {
+                if (picker() % 3 == 0) {
+                    board.toggle_flag(Position{idx / 6, idx % 6});
+                }
+                continue;
+            }
+            board.reveal(Position{idx / 6, idx % 6});
+            const auto hidden = std::count_if(packed.begin(), packed.end(), [](PackedCell other) {
+                return other.state() == CellState::Hidden;
+            });
+            if (hidden > 16 || board.all_safe_cells_revealed()) {
+                continue;
+            }
+            const auto map = ProbabilityEngine{}.compute(board);
+            assert(map.status == ProbabilityStatus::Exact);
+            const auto expected = brute_force(board);
+            assert(map.cells.size() == expected.size());
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                assert(near(map.cells[i].mine_probability, expected[i]));
+            }
+            ++checked;
+        }
+    }
+    assert(checked > 100);
+}
+
+void test_wrong_flag_is_inconsistent()
+{
+    // (0,1) counts the wrongly flagged (0,0) as its mine, so it rules out
+    // the mine at (0,2) that (1,2) needs.
+    const LayoutBoard board({
+        "fo*",
+        "ooo",
+        "ooo",
+    });
+    assert(ProbabilityEngine{}.compute(board).status == ProbabilityStatus::Inconsistent);
+}
+
+void test_state_limit()
+{
+    const LayoutBoard board({
+        "*.*.*.*.",
+        "oooooooo",
+        "oooooooo",
+    });
+    assert(ProbabilityEngine{1}.compute(board).status == ProbabilityStatus::TooComplex);
+    const auto map = ProbabilityEngine{}.compute(board);
+    assert(map.status == ProbabilityStatus::Exact);
+    assert(map.components == 1);
+    assert(near(probability_at(map, Position{0, 0}), 1.0));
+    assert(near(probability_at(map, Position{0, 1}), 0.0));
+}
+}  // namespace
+
+int main()
+{
+    test_uniform_before_first_reveal();
+    test_global_count_weights_components();
+    test_matches_brute_force_on_random_games();
+    test_wrong_flag_is_inconsistent();
+    test_state_limit();
+
+    std::cout << "ProbabilityEngine tests completed successfully." << std::endl;
+    return 0;
+}
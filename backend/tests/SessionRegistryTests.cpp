@@ -0,0 +1,127 @@
+#include "SessionRegistry.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+void test_sessions_are_isolated()
+{
+    clearbomb::SessionRegistry registry;
+
+    {
+        auto session = registry.acquire("alpha");
+        session->reset(clearbomb::BoardConfig{9, 9, 10});
+    }
+
+    const auto alpha = registry.acquire("alpha")->snapshot();
+    const auto beta = registry.acquire("beta")->snapshot();
+
+    assert(alpha.rows == 9 && alpha.columns == 9 && alpha.mines == 10);
+    assert(beta.rows == 16 && beta.columns == 16 && beta.mines == 40);
+    assert(registry.size() == 2);
+}
+
+void test_idle_sessions_are_evicted()
+{
+    clearbomb::SessionRegistry registry(clearbomb::SessionRegistryOptions{4, 8, std::chrono::seconds(0)});
+    registry.acquire("gamma");
+    registry.acquire("delta");
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    const std::size_t evicted = registry.evict_idle();
+    assert(evicted == 2);
+    assert(registry.size() == 0);
+
+    // A leased session stays, however long ago it was acquired.
+    auto lease = registry.acquire("epsilon");
+    registry.acquire("zeta");
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    const std::size_t evicted_around_lease = registry.evict_idle();
+    assert(evicted_around_lease == 1);
+    assert(registry.size() == 1);
+}
+
+void test_full_shard_evicts_least_recent()
+{
+    clearbomb::SessionRegistry registry(clearbomb::SessionRegistryOptions{1, 2, std::chrono::seconds(3600)});
+    registry.acquire("one");
+    registry.acquire("two");
+    registry.acquire("one");
+    registry.acquire("three");
+
+    assert(registry.size() == 2);
+}
+
+void test_full_shard_skips_leased_sessions()
+{
+    clearbomb::SessionRegistry registry(clearbomb::SessionRegistryOptions{1, 1, std::chrono::seconds(3600)});
+    auto lease = registry.acquire("one");
+    lease->reset(clearbomb::BoardConfig{9, 9, 10});
+
+    // "one" is still leased while "two" is created, so the shard goes over
+    // its limit instead of dropping a game in use.
+    lease = registry.acquire("two");
+    assert(registry.size() == 2);
+    lease = registry.acquire("one");
+    const std::size_t kept_rows = lease->snapshot().rows;
+    assert(kept_rows == 9);
+
+    // Creating "three" must make room, and "two" is the only session not
+    // leased, so it goes while "one" keeps its game.
+    lease = registry.acquire("three");
+    assert(registry.size() == 2);
+    lease = registry.acquire("one");
+    assert(registry.size() == 2);
+    const std::size_t rows_after = lease->snapshot().rows;
+    assert(rows_after == 9);
+}
+
+void test_invalid_session_ids_are_rejected()
+{
+    assert(clearbomb::SessionRegistry::is_valid_session_id("player_42-a"));
+    assert(!clearbomb::SessionRegistry::is_valid_session_id(""));
+    assert(!clearbomb::SessionRegistry::is_valid_session_id("has space"));
+    assert(!clearbomb::SessionRegistry::is_valid_session_id(std::string(65, 'x')));
+}
+
+void test_concurrent_sessions_progress_independently()
+{
+    clearbomb::SessionRegistry registry;
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < 8; ++worker) {
+        workers.emplace_back([&registry, worker]() {
+            const std::string id = "worker-" + std::to_string(worker);
+            for (int move = 0; move < 20; ++move) {
+                auto session = registry.acquire(id);
+                session->toggle_flag(clearbomb::Position{0, 0});
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    assert(registry.size() == 8);
+    for (int worker = 0; worker < 8; ++worker) {
+        const auto snapshot = registry.acquire("worker-" + std::to_string(worker))->snapshot();
+        assert(snapshot.flags_remaining == snapshot.mines);
+    }
+}
+
+}  // namespace
+
+int main()
+{
+    test_sessions_are_isolated();
+    test_idle_sessions_are_evicted();
+    test_full_shard_evicts_least_recent();
+    test_full_shard_skips_leased_sessions();
+    test_invalid_session_ids_are_rejected();
+    test_concurrent_sessions_progress_independently();
+
+    std::cout << "SessionRegistry tests completed successfully." << std::endl;
+    return 0;
+}
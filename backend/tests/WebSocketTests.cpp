@@ -0,0 +1,158 @@
+#include "BinaryProtocol.hpp"
+#include "WebSocket.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <string>
+
+namespace {
+using clearbomb::BinaryOp;
+using clearbomb::CellState;
+using clearbomb::MoveType;
+using clearbomb::WebSocketFrame;
+using clearbomb::WebSocketOpcode;
+using clearbomb::WebSocketParseStatus;
+
+std::string bytes(std::initializer_list<unsigned> values)
+{
+    std::string out;
+    for (const unsigned value : values) {
+        out.push_back(static_cast<char>(value));
+    }
+    return out;
+}
+
+void test_accept_key_matches_rfc_example()
+{
+    assert(clearbomb::websocket_accept_key("dGhlIHNhbXBsZSBub25jZQ==") == "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+}
+
+void test_parses_masked_frames()
+{
+    // The masked "Hello" from RFC 6455 section 5.7, followed by the start
+    // of a second frame.
+    const std::string buffer =
+        bytes({0x81, 0x85, 0x37, 0xfa, 0x21, 0x3d, 0x7f, 0x9f, 0x4d, 0x51, 0x58}) + bytes({0x82, 0x80});
+    WebSocketFrame frame;
+    const auto result = clearbomb::parse_websocket_frame(buffer, 1024, frame);
+    assert(result.status == WebSocketParseStatus::Complete);
+    assert(result.consumed == 11);
+    assert(frame.fin && frame.opcode == WebSocketOpcode::Text && frame.payload == "Hello");
+
+    for (std::size_t size = 0; size < 11; ++size) {
+        const auto partial = clearbomb::parse_websocket_frame(buffer.substr(0, size), 1024, frame);
+        assert(partial.status == WebSocketParseStatus::Incomplete);
+    }
+
+    // A 300-byte masked binary payload uses the 16-bit length form.
+    std::string large = bytes({0x82, 0xfe, 0x01, 0x2c, 1, 2, 3, 4});
+    for (std::size_t i = 0; i < 300; ++i) {
+        large.push_back(static_cast<char>((i & 0xffU) ^ (1 + i % 4)));
+    }
+    const auto large_result = clearbomb::parse_websocket_frame(large, 1024, frame);
+    assert(large_result.status == WebSocketParseStatus::Complete && large_result.consumed == large.size());
+    assert(frame.payload.size() == 300 && static_cast<unsigned char>(frame.payload[299]) == (299 & 0xffU));
+    assert(clearbomb::parse_websocket_frame(large, 299, frame).status == WebSocketParseStatus::TooLarge);
+}
+
+void test_rejects_invalid_frames()
+{
+    WebSocketFrame frame;
+    // Unmasked client frame.
+    assert(clearbomb::parse_websocket_frame(bytes({0x82, 0x00}), 1024, frame).status == WebSocketParseStatus::Invalid);
+    // Reserved bit set.
+    assert(
+        clearbomb::parse_websocket_frame(bytes({0xc2, 0x80, 0, 0, 0, 0}), 1024, frame).status ==
+        WebSocketParseStatus::Invalid
+    );
+    // Unknown opcode.
+    assert(
+        clearbomb::parse_websocket_frame(bytes({0x83, 0x80, 0, 0, 0, 0}), 1024, frame).status ==
+        WebSocketParseStatus::Invalid
+    );
+    // Fragmented ping.
+    assert(
+        clearbomb::parse_websocket_frame(bytes({0x09, 0x80, 0, 0, 0, 0}), 1024, frame).status ==
+        WebSocketParseStatus::Invalid
+    );
+}
+
+void test_server_frames_are_unmasked()
+{
+    std::string out;
+    clearbomb::append_websocket_frame(out, WebSocketOpcode::Binary, "abc");
+    assert(out == bytes({0x82, 0x03}) + "abc");
+
+    out.clear();
+    clearbomb::append_websocket_frame(out, WebSocketOpcode::Binary, std::string(70000, 'x'));
+    assert(out.substr(0, 10) == bytes({0x82, 0x7f, 0, 0, 0, 0, 0, 0x01, 0x11, 0x70}));
+    assert(out.size() == 10 + 70000);
+
+    assert(clearbomb::websocket_close_payload(1009, "big") == bytes({0x03, 0xf1}) + "big");
+}
+
+void test_decodes_binary_requests()
+{
+    std::string error;
+    const auto request = clearbomb::decode_binary_request(
+        bytes({0x01, 3, 4, 0x05, 0x02, 0, 49, 0x04, 1, 2, 3, 4, 0x03, 7, 8}), error
+    );
+    assert(request && request->wants_snapshot);
+    assert(request->moves.size() == 4);
+    assert(request->moves[0].type == MoveType::Reveal && request->moves[0].position.row == 3);
+    assert(request->moves[0].position.column == 4);
+    assert(request->moves[1].type == MoveType::Flag && request->moves[1].position.column == 49);
+    assert(request->moves[2].type == MoveType::AutoMark && request->moves[2].selection.col_end == 4);
+    assert(request->moves[3].type == MoveType::Chord && request->moves[3].position.row == 7);
+
+    assert(!clearbomb::decode_binary_request(bytes({0x01, 3}), error));
+    assert(error == "truncated operation at byte 0");
+    assert(!clearbomb::decode_binary_request(bytes({0x05, 0x42}), error));
+    assert(error == "unknown operation at byte 1");
+}
+
+void test_encodes_deltas_without_leaking_hidden_cells()
+{
+    const clearbomb::BatchResult result{
+        {clearbomb::Cell{{1, 2}, false, 3, CellState::Revealed, false},
+         clearbomb::Cell{{4, 5}, true, 2, CellState::Flagged, false}},
+        2, false, false, 9, clearbomb::GameStatus::Playing
+    };
+    std::string out;
+    clearbomb::append_binary_delta(out, result, 0x0102030405060708ULL);
+    assert(
+        out == bytes({static_cast<unsigned>(BinaryOp::Delta), 8, 7, 6, 5, 4, 3, 2, 1, 0, 9, 0, 2, 0, 2, 0}) +
+                   bytes({1, 2, 0x32, 4, 5, 0x04})
+    );
+}
+
+void test_encodes_snapshots()
+{
+    clearbomb::GameEngine engine;
+    engine.reset(clearbomb::BoardConfig{3, 4, 2, 11, clearbomb::BoardGenerator::Counter});
+    engine.toggle_flag(clearbomb::Position{0, 0});
+    std::string out;
+    clearbomb::append_binary_snapshot(out, engine);
+    assert(out.size() == 16 + 12);
+    assert(static_cast<unsigned char>(out[0]) == static_cast<unsigned>(BinaryOp::SnapshotReply));
+    assert(out[9] == 0 && out[10] == 1 && out[12] == 3 && out[13] == 4 && out[14] == 2);
+    assert(out[16] == 0x04);
+    for (std::size_t i = 17; i < out.size(); ++i) {
+        assert(out[i] == 0);
+    }
+}
+}  // namespace
+
+int main()
+{
+    test_accept_key_matches_rfc_example();
+    test_parses_masked_frames();
+    test_rejects_invalid_frames();
+    test_server_frames_are_unmasked();
+    test_decodes_binary_requests();
+    test_encodes_deltas_without_leaking_hidden_cells();
+    test_encodes_snapshots();
+
+    std::cout << "WebSocket tests completed successfully." << std::endl;
+    return 0;
+}
@@ -1,10 +1,13 @@
 import { useCallback, useEffect, useMemo, useReducer, useRef } from 'react';
 import {
   autoMarkSelection as autoMarkSelectionRequest,
+  chordCell as chordCellRequest,
   fetchBoard,
+  fetchBoardChanges,
   flagCell as flagCellRequest,
   resetGame as resetGameRequest,
-  revealCell as revealCellRequest
+  revealCell as revealCellRequest,
+  subscribeToBoardEvents
 } from '../services/apiClient.js';
 
 const DIFFICULTY_PRESETS = [
@@ -45,7 +48,39 @@ const mergeCells = (current, updates) => {
   return current.map((cell) => replacement.get(cell.id) ?? cell);
 };
 
+// A snapshot holds every change up to its version, so one at or below the
+// version already shown is old news.
+const isStale = (state, version) =>
+  typeof version === 'number' && typeof state.version === 'number' && version <= state.version;
+
+// Move responses and pushed deltas travel on different connections, and each
+// only carries the cells its own move touched. The same change arriving twice
+// is skipped; an unseen change older than the board shown cannot be merged
+// safely (a later move may have touched the same cells), so the board is
+// resynced with the changes since the last full sync instead.
+const RECENT_VERSION_LIMIT = 64;
+
+const classifyUpdate = (state, version) => {
+  if (typeof version !== 'number' || typeof state.version !== 'number' || version > state.version) {
+    return 'apply';
+  }
+  if (version <= state.syncedVersion || state.recentVersions.includes(version)) {
+    return 'duplicate';
+  }
+  return 'resync';
+};
+
+const rememberVersion = (state, version) =>
+  typeof version === 'number'
+    ? [...state.recentVersions.slice(1 - RECENT_VERSION_LIMIT), version]
+    : state.recentVersions;
+
 const initialState = {
+  version: null,
+  syncedVersion: null,
+  recentVersions: [],
+  resyncPending: false,
+  resyncAttempt: 0,
   rows: 0,
   columns: 0,
   mines: 0,
@@ -76,6 +111,10 @@ const reducer = (state, action) => {
     case 'BOOTSTRAP_SUCCESS':
       return {
         ...state,
+        version: action.payload.version ?? null,
+        syncedVersion: action.payload.version ?? null,
+        recentVersions: [],
+        resyncPending: false,
         rows: action.payload.rows,
         columns: action.payload.columns,
         mines: action.payload.mines,
@@ -95,16 +134,52 @@ const reducer = (state, action) => {
         error: action.payload,
         status: 'error'
       };
+    case 'SYNC_SNAPSHOT':
+      if (isStale(state, action.payload.version)) {
+        return state;
+      }
+      return reducer(state, { type: 'BOOTSTRAP_SUCCESS', payload: action.payload });
     case 'APPLY_CELL_UPDATES': {
+      const verdict = classifyUpdate(state, action.payload.version);
+      if (verdict === 'duplicate') {
+        return state;
+      }
+      if (verdict === 'resync') {
+        return state.resyncPending ? state : { ...state, resyncPending: true };
+      }
       const updates = (action.payload.cells ?? []).map(normaliseCell);
       return {
         ...state,
+        version: action.payload.version ?? state.version,
+        recentVersions: rememberVersion(state, action.payload.version),
         cells: state.cells.length ? mergeCells(state.cells, updates) : updates,
         flagsRemaining: action.payload.flagsRemaining ?? state.flagsRemaining,
         status: action.payload.status ?? state.status,
         error: null
       };
     }
+    case 'APPLY_RESYNC': {
+      const { payload } = action;
+      // Moves landed while the resync was in flight; ask again from the same
+      // baseline so their cells are covered too.
+      if (typeof state.version === 'number' && payload.version < state.version) {
+        return { ...state, resyncAttempt: state.resyncAttempt + 1 };
+      }
+      const cells = payload.cells
+        ? payload.cells.map(normaliseCell)
+        : mergeCells(state.cells, (payload.updatedCells ?? []).map(normaliseCell));
+      return {
+        ...state,
+        version: payload.version,
+        syncedVersion: payload.version,
+        recentVersions: [],
+        resyncPending: false,
+        cells,
+        flagsRemaining: payload.flagsRemaining,
+        status: payload.status,
+        error: null
+      };
+    }
     case 'SET_TIMER_ACTIVE':
       if (state.timerActive === action.payload) {
         return state;
@@ -312,6 +387,47 @@ export const useMinesweeper = () => {
     loadBoardSnapshot();
   }, [loadBoardSnapshot]);
 
+  // Moves made elsewhere on this session (another tab, a spectator's view of
+  // it) arrive over the event stream instead of by polling.
+  useEffect(
+    () =>
+      subscribeToBoardEvents({
+        onSnapshot: (snapshot) => dispatch({ type: 'SYNC_SNAPSHOT', payload: snapshot }),
+        onDelta: (delta) =>
+          dispatch({
+            type: 'APPLY_CELL_UPDATES',
+            payload: {
+              cells: delta.updatedCells,
+              flagsRemaining: delta.flagsRemaining,
+              status: delta.status,
+              version: delta.version
+            }
+          })
+      }),
+    []
+  );
+
+  useEffect(() => {
+    if (!state.resyncPending) {
+      return () => {};
+    }
+    let cancelled = false;
+    fetchBoardChanges(state.syncedVersion)
+      .then((payload) => {
+        if (!cancelled) {
+          dispatch({ type: 'APPLY_RESYNC', payload });
+        }
+      })
+      .catch((error) => {
+        if (!cancelled) {
+          dispatch({ type: 'SET_ERROR', payload: error.message || 'Unable to resync board' });
+        }
+      });
+    return () => {
+      cancelled = true;
+    };
+  }, [state.resyncPending, state.syncedVersion, state.resyncAttempt]);
+
   useEffect(() => () => {
     if (flashTimeoutRef.current) {
       clearTimeout(flashTimeoutRef.current);
@@ -420,7 +536,8 @@ export const useMinesweeper = () => {
             applyUpdates({
               cells: result.flaggedCells,
               flagsRemaining: result.flagsRemaining,
-              status: result.status
+              status: result.status,
+              version: result.version
             });
           }
         } catch (error) {
@@ -432,41 +549,6 @@ export const useMinesweeper = () => {
     [applyUpdates, cellLookup, dispatch, state.columns, state.rows]
   );
 
-  const revealMultipleCells = useCallback(
-    async (positions) => {
-      if (!positions.length) {
-        return { cells: [], flagsRemaining: state.flagsRemaining, status: state.status };
-      }
-      try {
-        const results = await Promise.all(positions.map((position) => revealCellRequest(position)));
-        const aggregated = results.reduce(
-          (acc, response) => {
-            const updated = response?.updatedCells ?? [];
-            if (updated.length) {
-              acc.cells.push(...updated);
-            }
-            if (typeof response?.flagsRemaining === 'number') {
-              acc.flagsRemaining = response.flagsRemaining;
-            }
-            if (response?.status) {
-              acc.status = response.status;
-            }
-            return acc;
-          },
-          { cells: [], flagsRemaining: state.flagsRemaining, status: state.status }
-        );
-        if (aggregated.cells.length) {
-          applyUpdates(aggregated);
-        }
-        return aggregated;
-      } catch (error) {
-        dispatch({ type: 'SET_ERROR', payload: error.message });
-        return null;
-      }
-    },
-    [applyUpdates, dispatch, state.flagsRemaining, state.status]
-  );
-
   const flashSelection = useCallback(
     (startCell, endCell) => {
       if (flashTimeoutRef.current) {
@@ -494,7 +576,8 @@ export const useMinesweeper = () => {
         applyUpdates({
           cells: response.updatedCells,
           flagsRemaining: response.flagsRemaining,
-          status: response.status
+          status: response.status,
+          version: response.version
         });
 
         if (!state.timerActive && response.updatedCells?.length) {
@@ -539,15 +622,23 @@ export const useMinesweeper = () => {
       });
 
       if (flaggedCount === centerCell.adjacentMines && hiddenTargets.length) {
-        const aggregated = await revealMultipleCells(hiddenTargets);
-        if (!aggregated) {
-          return;
-        }
-        if (!state.timerActive && aggregated.cells.length) {
-          dispatch({ type: 'SET_TIMER_ACTIVE', payload: true });
-        }
-        if (state.autoMarkEnabled && aggregated.status === 'playing' && aggregated.cells.length) {
-          await autoMarkFromCells(aggregated.cells);
+        try {
+          const response = await chordCellRequest(position);
+          const updated = response.updatedCells ?? [];
+          applyUpdates({
+            cells: updated,
+            flagsRemaining: response.flagsRemaining,
+            status: response.status,
+            version: response.version
+          });
+          if (!state.timerActive && updated.length) {
+            dispatch({ type: 'SET_TIMER_ACTIVE', payload: true });
+          }
+          if (state.autoMarkEnabled && response.status === 'playing' && updated.length) {
+            await autoMarkFromCells(updated);
+          }
+        } catch (error) {
+          dispatch({ type: 'SET_ERROR', payload: error.message });
         }
       } else {
         const startRow = Math.max(0, position.row - 1);
@@ -563,7 +654,7 @@ export const useMinesweeper = () => {
       state.rows,
       state.columns,
       flashSelection,
-      revealMultipleCells,
+      applyUpdates,
       state.timerActive,
       dispatch,
       state.autoMarkEnabled,
@@ -581,7 +672,8 @@ export const useMinesweeper = () => {
         applyUpdates({
           cells: [response.updatedCell],
           flagsRemaining: response.flagsRemaining,
-          status: response.status
+          status: response.status,
+          version: response.version
         });
       } catch (error) {
         dispatch({ type: 'SET_ERROR', payload: error.message });
@@ -699,7 +791,8 @@ export const useMinesweeper = () => {
         applyUpdates({
           cells: response.flaggedCells,
           flagsRemaining: response.flagsRemaining,
-          status: response.status
+          status: response.status,
+          version: response.version
         });
       } catch (error) {
         dispatch({ type: 'SET_ERROR', payload: error.message });
@@ -1,4 +1,36 @@
+import { COMPACT_BOARD_TYPE, decodeBoardSnapshot } from './boardCodec.js';
+
 const API_BASE_URL = '/api';
+const SESSION_STORAGE_KEY = 'clear-bomb-session-id';
+
+const createSessionId = () => {
+  if (globalThis.crypto?.randomUUID) {
+    return globalThis.crypto.randomUUID();
+  }
+  return `${Date.now().toString(36)}-${Math.random().toString(36).slice(2, 10)}`;
+};
+
+// Each browser tab plays its own game; the id survives reloads of that tab.
+const resolveSessionId = () => {
+  try {
+    const existing = window.sessionStorage.getItem(SESSION_STORAGE_KEY);
+    if (existing) {
+      return existing;
+    }
+    const created = createSessionId();
+    window.sessionStorage.setItem(SESSION_STORAGE_KEY, created);
+    return created;
+  } catch {
+    return createSessionId();
+  }
+};
+
+const SESSION_ID = resolveSessionId();
+const SESSION_HEADERS = { 'X-Session-Id': SESSION_ID };
+const JSON_HEADERS = { ...SESSION_HEADERS, 'Content-Type': 'application/json' };
+// Whole boards are large as JSON, so ask for the compact encoding; the server
+// falls back to JSON when it does not offer it.
+const BOARD_ACCEPT = `${COMPACT_BOARD_TYPE}, application/json;q=0.9`;
 
 const handleResponse = async (response) => {
   if (!response.ok) {
@@ -12,14 +44,47 @@ const handleResponse = async (response) => {
 };
 
 export const fetchBoard = async () => {
-  const response = await fetch(`${API_BASE_URL}/board`);
-  return handleResponse(response);
+  const response = await fetch(`${API_BASE_URL}/board`, {
+    headers: { ...SESSION_HEADERS, Accept: BOARD_ACCEPT }
+  });
+  return decodeBoardSnapshot(await handleResponse(response));
+};
+
+// The cells changed since the given version, or a full snapshot when the
+// server's change journal no longer reaches that far back.
+export const fetchBoardChanges = async (since) => {
+  const response = await fetch(`${API_BASE_URL}/board?since=${encodeURIComponent(since)}`, {
+    headers: { ...SESSION_HEADERS, Accept: BOARD_ACCEPT }
+  });
+  return decodeBoardSnapshot(await handleResponse(response));
+};
+
+// Follows this session's board over server-sent events: a snapshot first,
+// then a delta per change. Returns a function that closes the stream.
+export const subscribeToBoardEvents = ({ onSnapshot, onDelta }) => {
+  if (typeof EventSource === 'undefined') {
+    return () => {};
+  }
+  const source = new EventSource(`${API_BASE_URL}/events?session=${encodeURIComponent(SESSION_ID)}`);
+  source.addEventListener('snapshot', (event) => onSnapshot(JSON.parse(event.data)));
+  source.addEventListener('delta', (event) => onDelta(JSON.parse(event.data)));
+  return () => source.close();
 };
 
 export const revealCell = async (position) => {
   const response = await fetch(`${API_BASE_URL}/reveal`, {
     method: 'POST',
-    headers: { 'Content-Type': 'application/json' },
+    headers: JSON_HEADERS,
+    body: JSON.stringify(position)
+  });
+  return handleResponse(response);
+};
+
+// Reveals every unflagged neighbour of a satisfied number in one request.
+export const chordCell = async (position) => {
+  const response = await fetch(`${API_BASE_URL}/chord`, {
+    method: 'POST',
+    headers: JSON_HEADERS,
     body: JSON.stringify(position)
   });
   return handleResponse(response);
@@ -28,7 +93,7 @@ export const revealCell = async (position) => {
 export const flagCell = async (position) => {
   const response = await fetch(`${API_BASE_URL}/flag`, {
     method: 'POST',
-    headers: { 'Content-Type': 'application/json' },
+    headers: JSON_HEADERS,
     body: JSON.stringify(position)
   });
   return handleResponse(response);
@@ -37,7 +102,7 @@ export const flagCell = async (position) => {
 export const autoMarkSelection = async (selection) => {
   const response = await fetch(`${API_BASE_URL}/auto-mark`, {
     method: 'POST',
-    headers: { 'Content-Type': 'application/json' },
+    headers: JSON_HEADERS,
     body: JSON.stringify(selection)
   });
   return handleResponse(response);
@@ -46,8 +111,8 @@ export const autoMarkSelection = async (selection) => {
 export const resetGame = async (config) => {
   const response = await fetch(`${API_BASE_URL}/reset`, {
     method: 'POST',
-    headers: { 'Content-Type': 'application/json' },
+    headers: { ...JSON_HEADERS, Accept: BOARD_ACCEPT },
     body: config ? JSON.stringify(config) : ''
   });
-  return handleResponse(response);
+  return decodeBoardSnapshot(await handleResponse(response));
 };
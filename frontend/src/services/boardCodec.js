@@ -0,0 +1,38 @@
+// Media type of the compact snapshot: the usual snapshot fields, with
+// "cells" holding base64 (run length, cell byte) pairs in row-major order.
+export const COMPACT_BOARD_TYPE = 'application/vnd.clearbomb.compact+json';
+
+const CELL_STATES = ['hidden', 'revealed', 'flagged'];
+
+// Cell bytes use the server's packed layout: bit 0 mine, bits 1-2 state,
+// bit 3 exploded, bits 4-7 adjacent mines.
+const decodeCell = (value, row, column) => ({
+  row,
+  column,
+  state: CELL_STATES[(value >> 1) & 3] ?? 'hidden',
+  adjacentMines: value >> 4,
+  isMine: (value & 1) !== 0,
+  exploded: (value & 8) !== 0
+});
+
+// Turns either snapshot encoding into the JSON one the UI works with.
+export const decodeBoardSnapshot = (payload) => {
+  if (!payload || payload.encoding !== 'rle') {
+    return payload;
+  }
+  const { encoding, cells: encoded, ...board } = payload;
+  const bytes = atob(encoded);
+  const cells = [];
+  for (let offset = 0; offset + 1 < bytes.length; offset += 2) {
+    const run = bytes.charCodeAt(offset);
+    const value = bytes.charCodeAt(offset + 1);
+    for (let i = 0; i < run; i += 1) {
+      const index = cells.length;
+      cells.push(decodeCell(value, Math.floor(index / board.columns), index % board.columns));
+    }
+  }
+  if (cells.length !== board.rows * board.columns) {
+    throw new Error(`Compact ${encoding} snapshot holds ${cells.length} cells, expected ${board.rows * board.columns}`);
+  }
+  return { ...board, cells };
+};
@@ -58,7 +58,7 @@ fi
 printf '[INFO] Building backend tests...\n'
 (
   set -x
-  cmake --build "$BUILD_DIR" --target clear_bomb_tests
+  cmake --build "$BUILD_DIR"
 )
 
 printf '[INFO] Running backend test suite...\n'